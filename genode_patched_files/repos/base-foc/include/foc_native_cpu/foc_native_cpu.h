@@ -0,0 +1,98 @@
+/*
+ * \brief  Fiasco.OC-specific part of the CPU session interface
+ * \author Stefan Kalkowski
+ * \author Norman Feske
+ * \date   2011-04-14
+ */
+
+/*
+ * Copyright (C) 2011-2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__FOC_NATIVE_CPU__FOC_NATIVE_CPU_H_
+#define _INCLUDE__FOC_NATIVE_CPU__FOC_NATIVE_CPU_H_
+
+#include <base/rpc.h>
+#include <cpu_session/cpu_session.h>
+#include <cpu_thread/cpu_thread.h>
+#include <dataspace/dataspace.h>
+
+namespace Genode { struct Foc_native_cpu; }
+
+
+struct Genode::Foc_native_cpu : Cpu_session::Native_cpu
+{
+	/**
+	 * Layout of a RAM dataspace for transferring the states of all threads
+	 *
+	 * The entries directly follow the header. A thread is identified by the
+	 * badge of its thread capability.
+	 */
+	struct Thread_state_buffer
+	{
+		struct Entry
+		{
+			unsigned long badge;
+			bool          valid;   /* state was read or shall be written */
+			Thread_state  state;
+		};
+
+		unsigned count;
+		unsigned reserved;
+
+		Entry       *entries()       { return (Entry*)(this + 1); }
+		Entry const *entries() const { return (Entry const*)(this + 1); }
+
+		static unsigned max_entries(size_t size)
+		{
+			return size < sizeof(Thread_state_buffer) ? 0
+			       : (size - sizeof(Thread_state_buffer)) / sizeof(Entry);
+		}
+	};
+
+	virtual Native_capability native_cap(Thread_capability) = 0;
+
+	/**
+	 * Pause all threads of the CPU session
+	 *
+	 * Each thread is paused by Platform_thread::pause, i.e. a started thread
+	 * is stopped when the call returns. Threads without a pager, which were
+	 * not started yet, are skipped. Core does not report a per-thread result.
+	 */
+	virtual void pause_all() = 0;
+
+	/**
+	 * Resume all threads of the CPU session
+	 */
+	virtual void resume_all() = 0;
+
+	/**
+	 * Read the states of all threads of the CPU session into the buffer
+	 *
+	 * \param buffer  RAM dataspace laid out as Thread_state_buffer
+	 *
+	 * \return number of entries with a valid state
+	 */
+	virtual unsigned get_states(Dataspace_capability buffer) = 0;
+
+	/**
+	 * Write the valid states of the buffer to the threads of the CPU session
+	 *
+	 * Entries which could not be written are marked as not valid.
+	 *
+	 * \return number of written states
+	 */
+	virtual unsigned set_states(Dataspace_capability buffer) = 0;
+
+	GENODE_RPC(Rpc_native_cap, Native_capability, native_cap, Thread_capability);
+	GENODE_RPC(Rpc_pause_all, void, pause_all);
+	GENODE_RPC(Rpc_resume_all, void, resume_all);
+	GENODE_RPC(Rpc_get_states, unsigned, get_states, Dataspace_capability);
+	GENODE_RPC(Rpc_set_states, unsigned, set_states, Dataspace_capability);
+	GENODE_RPC_INTERFACE(Rpc_native_cap, Rpc_pause_all, Rpc_resume_all, Rpc_get_states, Rpc_set_states);
+};
+
+#endif /* _INCLUDE__FOC_NATIVE_CPU__FOC_NATIVE_CPU_H_ */
@@ -32,7 +32,27 @@ struct Genode::Foc_native_pd_client : Rpc_client<Foc_native_pd>
 
 	void cap_map_info(addr_t addr) override { call<Rpc_set_cap_map_info>(addr); }
 
+	Cap_map_layout cap_map_layout() override { return call<Rpc_get_cap_map_layout>(); }
+
+	void cap_map_layout(Cap_map_layout const &layout) override { call<Rpc_set_cap_map_layout>(layout); }
+
 	void install(Native_capability cap, addr_t kcap) override { call<Rpc_install>(cap, kcap); }
+
+	void install_batch(Install_batch &batch, Native_capability cap0, Native_capability cap1,
+	                   Native_capability cap2, Native_capability cap3) override {
+		call<Rpc_install_batch>(batch, cap0, cap1, cap2, cap3); }
+
+	void attach_batch(Capability<Region_map> region_map, Attach_batch &batch, Dataspace_capability ds0,
+	                  Dataspace_capability ds1, Dataspace_capability ds2) override {
+		call<Rpc_attach_batch>(region_map, batch, ds0, ds1, ds2); }
+
+	void alloc_attach_batch(Capability<Region_map> region_map, Capability<Ram_session> ram,
+	                        Alloc_attach_batch &batch, Ram_dataspace_capability &ds0,
+	                        Ram_dataspace_capability &ds1, Ram_dataspace_capability &ds2) override {
+		call<Rpc_alloc_attach_batch>(region_map, ram, batch, ds0, ds1, ds2); }
+
+	void detach_batch(Capability<Region_map> region_map, Detach_batch &batch) override {
+		call<Rpc_detach_batch>(region_map, batch); }
 };
 
 #endif /* _INCLUDE__FOC_NATIVE_PD__CLIENT_H_ */
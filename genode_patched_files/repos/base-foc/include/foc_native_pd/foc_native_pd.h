@@ -18,22 +18,251 @@
 #include <base/capability.h>
 #include <base/rpc.h>
 #include <pd_session/pd_session.h>
+#include <ram_session/ram_session.h>
+#include <region_map/region_map.h>
 
 namespace Genode { struct Foc_native_pd; }
 
 
 struct Genode::Foc_native_pd : Pd_session::Native_pd
 {
+	/**
+	 * Layout of the capability map (Cap_index_allocator) of the component
+	 */
+	struct Cap_map_layout
+	{
+		addr_t struct_addr;    /* address of the Cap_index_allocator */
+		addr_t array_addr;     /* address of the first Cap_index */
+		size_t num_slots;      /* number of Cap_index slots */
+		size_t element_size;   /* size of a Cap_index */
+		size_t ref_cnt_offset; /* offset of the 8-bit reference counter within a Cap_index */
+		size_t badge_offset;   /* offset of the 16-bit badge within a Cap_index */
+		size_t user_slot;      /* first slot handed out by the allocator; the slots below are reserved */
+	};
+
+	/**
+	 * Target selectors of a batch of capabilities to install
+	 *
+	 * The capabilities themselves are arguments of install_batch, i.e. they
+	 * are transferred by the IPC and the caller has to possess each of them.
+	 * Thus, a batch is bounded by the capabilities a message can carry
+	 * (Msgbuf_base::MAX_CAPS_PER_MSG). Only the IPC round trip is batched;
+	 * core maps each capability by its own l4_task_map. Core reports per
+	 * entry whether it was installed.
+	 */
+	struct Install_batch
+	{
+		enum { MAX_ENTRIES = 4 };
+
+		struct Entry
+		{
+			addr_t kcap;
+			bool   installed;
+		};
+
+		unsigned count;
+		Entry    entries[MAX_ENTRIES];
+
+		Install_batch() : count(0) { }
+
+		bool full() const { return count == MAX_ENTRIES; }
+
+		/**
+		 * Add the entry for the count-th capability argument of install_batch
+		 */
+		void add(addr_t kcap)
+		{
+			if(full()) return;
+			entries[count].kcap      = kcap;
+			entries[count].installed = false;
+			count++;
+		}
+	};
+
+	/**
+	 * Regions of a batch of dataspaces to attach to a region map at fixed addresses
+	 *
+	 * As for Install_batch, the dataspaces are capability arguments of
+	 * attach_batch, thus, only dataspaces the caller possesses are attached.
+	 * The region map takes one of the capabilities of the message. Core
+	 * reports per entry whether the dataspace was attached at rel_addr.
+	 */
+	struct Attach_batch
+	{
+		enum { MAX_ENTRIES = 3 };
+
+		struct Entry
+		{
+			addr_t rel_addr;
+			size_t size;
+			bool   attached;
+		};
+
+		unsigned count;
+		Entry    entries[MAX_ENTRIES];
+
+		Attach_batch() : count(0) { }
+
+		bool full() const { return count == MAX_ENTRIES; }
+
+		/**
+		 * Add the entry for the count-th dataspace argument of attach_batch
+		 */
+		void add(addr_t rel_addr, size_t size)
+		{
+			if(full()) return;
+			entries[count].rel_addr = rel_addr;
+			entries[count].size     = size;
+			entries[count].attached = false;
+			count++;
+		}
+	};
+
+	/**
+	 * Regions of a batch of dataspaces which core allocates and attaches to a region map
+	 *
+	 * Core allocates each dataspace from the RAM session argument of
+	 * alloc_attach_batch and attaches it at rel_addr. The capabilities of the
+	 * dataspaces are result arguments, thus, a batch is bounded by the
+	 * capabilities of the reply. The request carries only the region map and
+	 * the RAM session. Core reports per entry whether the dataspace was
+	 * attached; the capability of a dataspace core could not allocate is
+	 * invalid.
+	 */
+	struct Alloc_attach_batch
+	{
+		enum { MAX_ENTRIES = 3 };
+
+		struct Entry
+		{
+			addr_t rel_addr;
+			size_t size;
+			bool   attached;
+		};
+
+		Cache_attribute cached;
+		unsigned        count;
+		Entry           entries[MAX_ENTRIES];
+
+		Alloc_attach_batch(Cache_attribute cached = CACHED) : cached(cached), count(0) { }
+
+		bool full() const { return count == MAX_ENTRIES; }
+
+		/**
+		 * Add the entry for the count-th dataspace result of alloc_attach_batch
+		 */
+		void add(addr_t rel_addr, size_t size)
+		{
+			if(full()) return;
+			entries[count].rel_addr = rel_addr;
+			entries[count].size     = size;
+			entries[count].attached = false;
+			count++;
+		}
+	};
+
+	/**
+	 * Batch of regions to detach from a region map
+	 *
+	 * An entry describes count regions starting at rel_addr + i*stride, i.e.
+	 * a run of adjacent dataspaces of equal size is detached by one entry.
+	 * Core reports per entry whether all of its regions were attached and,
+	 * thus, detached.
+	 */
+	struct Detach_batch
+	{
+		enum { MAX_ENTRIES = 12 };
+
+		struct Entry
+		{
+			addr_t   rel_addr;
+			size_t   stride;
+			unsigned count;
+			bool     detached;
+		};
+
+		unsigned count;
+		Entry    entries[MAX_ENTRIES];
+
+		Detach_batch() : count(0) { }
+
+		bool full() const { return count == MAX_ENTRIES; }
+
+		void add(addr_t rel_addr, size_t stride)
+		{
+			if(full()) return;
+			entries[count].rel_addr = rel_addr;
+			entries[count].stride   = stride;
+			entries[count].count    = 1;
+			entries[count].detached = false;
+			count++;
+		}
+	};
+
 	virtual Native_capability task_cap() = 0;
 	virtual void install(Native_capability, addr_t) = 0;
+
+	/**
+	 * Install the capabilities to the selectors of the batch entries of the task
+	 *
+	 * Capabilities without a batch entry are ignored and may be invalid.
+	 */
+	virtual void install_batch(Install_batch &, Native_capability, Native_capability,
+	                           Native_capability, Native_capability) = 0;
+
+	/**
+	 * Attach the dataspaces to the regions of the batch entries of the region map
+	 *
+	 * Dataspaces without a batch entry are ignored and may be invalid.
+	 */
+	virtual void attach_batch(Capability<Region_map>, Attach_batch &, Dataspace_capability,
+	                          Dataspace_capability, Dataspace_capability) = 0;
+
+	/**
+	 * Allocate the dataspaces of the batch entries from the RAM session and attach them to the region map
+	 *
+	 * The dataspaces are returned in the capability arguments; the arguments
+	 * without a batch entry are invalid.
+	 */
+	virtual void alloc_attach_batch(Capability<Region_map>, Capability<Ram_session>, Alloc_attach_batch &,
+	                                Ram_dataspace_capability &, Ram_dataspace_capability &,
+	                                Ram_dataspace_capability &) = 0;
+
+	/**
+	 * Detach the regions of a batch from the region map
+	 */
+	virtual void detach_batch(Capability<Region_map>, Detach_batch &) = 0;
+
 	virtual addr_t cap_map_info() = 0;
 	virtual void cap_map_info(addr_t) = 0;
 
+	/**
+	 * Return layout of the capability map; num_slots is 0, if the component did not report it
+	 */
+	virtual Cap_map_layout cap_map_layout() = 0;
+
+	/**
+	 * Report layout of the capability map; also sets cap_map_info to layout.struct_addr
+	 */
+	virtual void cap_map_layout(Cap_map_layout const &) = 0;
+
 	GENODE_RPC(Rpc_task_cap, Native_capability, task_cap);
 	GENODE_RPC(Rpc_install, void, install, Native_capability, addr_t);
+	GENODE_RPC(Rpc_install_batch, void, install_batch, Install_batch &, Native_capability,
+	           Native_capability, Native_capability, Native_capability);
+	GENODE_RPC(Rpc_attach_batch, void, attach_batch, Capability<Region_map>, Attach_batch &,
+	           Dataspace_capability, Dataspace_capability, Dataspace_capability);
+	GENODE_RPC(Rpc_alloc_attach_batch, void, alloc_attach_batch, Capability<Region_map>, Capability<Ram_session>,
+	           Alloc_attach_batch &, Ram_dataspace_capability &, Ram_dataspace_capability &,
+	           Ram_dataspace_capability &);
+	GENODE_RPC(Rpc_detach_batch, void, detach_batch, Capability<Region_map>, Detach_batch &);
 	GENODE_RPC(Rpc_get_cap_map_info, addr_t, cap_map_info);
 	GENODE_RPC(Rpc_set_cap_map_info, void, cap_map_info, addr_t);
-	GENODE_RPC_INTERFACE(Rpc_task_cap, Rpc_install, Rpc_get_cap_map_info, Rpc_set_cap_map_info);
+	GENODE_RPC(Rpc_get_cap_map_layout, Cap_map_layout, cap_map_layout);
+	GENODE_RPC(Rpc_set_cap_map_layout, void, cap_map_layout, Cap_map_layout const &);
+	GENODE_RPC_INTERFACE(Rpc_task_cap, Rpc_install, Rpc_install_batch, Rpc_attach_batch,
+	                     Rpc_alloc_attach_batch, Rpc_detach_batch, Rpc_get_cap_map_info, Rpc_set_cap_map_info, Rpc_get_cap_map_layout,
+	                     Rpc_set_cap_map_layout);
 };
 
 #endif /* _INCLUDE__FOC_NATIVE_PD__FOC_NATIVE_PD_H_ */
@@ -0,0 +1,48 @@
+/*
+ * \brief  Kernel-specific part of the CPU-session interface
+ * \author Norman Feske
+ * \date   2016-01-19
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _CORE__INCLUDE__NATIVE_CPU_COMPONENT_H_
+#define _CORE__INCLUDE__NATIVE_CPU_COMPONENT_H_
+
+/* Genode includes */
+#include <base/rpc_server.h>
+#include <foc_native_cpu/foc_native_cpu.h>
+
+namespace Genode {
+
+	class Cpu_session_component;
+	class Native_cpu_component;
+}
+
+
+class Genode::Native_cpu_component : public Rpc_object<Foc_native_cpu,
+                                                       Native_cpu_component>
+{
+	private:
+
+		Cpu_session_component &_cpu_session;
+		Rpc_entrypoint        &_thread_ep;
+
+	public:
+
+		Native_cpu_component(Cpu_session_component &, char const *);
+		~Native_cpu_component();
+
+		Native_capability native_cap(Thread_capability) override;
+		void pause_all() override;
+		void resume_all() override;
+		unsigned get_states(Dataspace_capability buffer) override;
+		unsigned set_states(Dataspace_capability buffer) override;
+};
+
+#endif /* _CORE__INCLUDE__NATIVE_CPU_COMPONENT_H_ */
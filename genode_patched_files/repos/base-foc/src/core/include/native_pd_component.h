@@ -33,13 +33,29 @@ class Genode::Native_pd_component : public Rpc_object<Foc_native_pd>
 
 		Pd_session_component &_pd_session;
 		addr_t                _cap_map_info;
+		Cap_map_layout        _cap_map_layout;
+
+		/**
+		 * Map the capability at core's cap selector core_kcap to kcap of the task
+		 */
+		bool _map(addr_t core_kcap, addr_t kcap);
 
 	public:
 
 		Native_capability task_cap() override;
 		addr_t cap_map_info() override;
 		void cap_map_info(addr_t addr) override;
+		Cap_map_layout cap_map_layout() override;
+		void cap_map_layout(Cap_map_layout const &layout) override;
 		void install(Native_capability cap, addr_t kcap) override;
+		void install_batch(Install_batch &batch, Native_capability cap0, Native_capability cap1,
+		                   Native_capability cap2, Native_capability cap3) override;
+		void attach_batch(Capability<Region_map> region_map, Attach_batch &batch, Dataspace_capability ds0,
+		                  Dataspace_capability ds1, Dataspace_capability ds2) override;
+		void alloc_attach_batch(Capability<Region_map> region_map, Capability<Ram_session> ram,
+		                        Alloc_attach_batch &batch, Ram_dataspace_capability &ds0,
+		                        Ram_dataspace_capability &ds1, Ram_dataspace_capability &ds2) override;
+		void detach_batch(Capability<Region_map> region_map, Detach_batch &batch) override;
 
 		Native_pd_component(Pd_session_component &pd, char const *args);
 
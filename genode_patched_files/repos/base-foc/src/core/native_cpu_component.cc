@@ -0,0 +1,152 @@
+/*
+ * \brief  Core implementation of the CPU session interface extension
+ * \author Stefan Kalkowski
+ * \date   2011-04-14
+ */
+
+/*
+ * Copyright (C) 2011-2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* core includes */
+#include <cpu_session_component.h>
+#include <native_cpu_component.h>
+#include <platform_thread.h>
+#include <dataspace_component.h>
+
+using namespace Genode;
+
+
+Native_capability Native_cpu_component::native_cap(Thread_capability cap)
+{
+	auto lambda = [&] (Cpu_thread_component *thread) {
+		return (!thread) ? Native_capability()
+		                 : thread->platform_thread().thread().local; };
+
+	return _thread_ep.apply(cap, lambda);
+}
+
+
+void Native_cpu_component::pause_all()
+{
+	//log("Native_cpu::\033[33m", __func__, "\033[0m()");
+
+	Lock::Guard guard(_cpu_session._thread_list_lock);
+
+	/*
+	 * Platform_thread::pause forces the thread into an exception and waits
+	 * until the pager observed it. Pausing all threads in core, without IPC
+	 * round trips between them, keeps the time span small in which some
+	 * threads still run while others are stopped.
+	 */
+	for(Cpu_thread_component *thread = _cpu_session._thread_list.first(); thread; thread = thread->next())
+		thread->platform_thread().pause();
+}
+
+
+void Native_cpu_component::resume_all()
+{
+	//log("Native_cpu::\033[33m", __func__, "\033[0m()");
+
+	Lock::Guard guard(_cpu_session._thread_list_lock);
+
+	for(Cpu_thread_component *thread = _cpu_session._thread_list.first(); thread; thread = thread->next())
+		thread->platform_thread().resume();
+}
+
+
+unsigned Native_cpu_component::get_states(Dataspace_capability buffer_cap)
+{
+	//log("Native_cpu::\033[33m", __func__, "\033[0m(", buffer_cap, ")");
+
+	auto lambda = [&] (Dataspace_component *ds) -> unsigned {
+
+		if(!ds || !ds->core_local_addr()) return 0;
+
+		Thread_state_buffer &buffer = *(Thread_state_buffer*)ds->core_local_addr();
+		unsigned const max_entries  = Thread_state_buffer::max_entries(ds->size());
+
+		Lock::Guard guard(_cpu_session._thread_list_lock);
+
+		unsigned count = 0, valid = 0;
+		for(Cpu_thread_component *thread = _cpu_session._thread_list.first();
+		    thread && count < max_entries; thread = thread->next(), count++)
+		{
+			Thread_state_buffer::Entry &entry = buffer.entries()[count];
+
+			entry.badge = thread->cap().local_name();
+			entry.valid = false;
+
+			// The state of a running thread is not accessible
+			try { entry.state = thread->state(); entry.valid = true; valid++; }
+			catch(Cpu_thread::State_access_failed) { }
+		}
+		buffer.count = count;
+
+		return valid;
+	};
+
+	return _thread_ep.apply(buffer_cap, lambda);
+}
+
+
+unsigned Native_cpu_component::set_states(Dataspace_capability buffer_cap)
+{
+	//log("Native_cpu::\033[33m", __func__, "\033[0m(", buffer_cap, ")");
+
+	auto lambda = [&] (Dataspace_component *ds) -> unsigned {
+
+		if(!ds || !ds->core_local_addr()) return 0;
+
+		Thread_state_buffer &buffer = *(Thread_state_buffer*)ds->core_local_addr();
+		unsigned const count = min(buffer.count, Thread_state_buffer::max_entries(ds->size()));
+
+		Lock::Guard guard(_cpu_session._thread_list_lock);
+
+		/*
+		 * The client usually lists the threads in the order of our thread list,
+		 * hence, the search for the next thread starts after the last match
+		 */
+		Cpu_thread_component *thread = _cpu_session._thread_list.first();
+		unsigned written = 0;
+		for(unsigned i = 0; i < count; i++)
+		{
+			Thread_state_buffer::Entry &entry = buffer.entries()[i];
+			if(!entry.valid) continue;
+
+			Cpu_thread_component *match = nullptr;
+			for(Cpu_thread_component *t = thread; t && !match; t = t->next())
+				if(t->cap().local_name() == (long)entry.badge) match = t;
+			for(Cpu_thread_component *t = _cpu_session._thread_list.first(); t != thread && !match; t = t->next())
+				if(t->cap().local_name() == (long)entry.badge) match = t;
+
+			entry.valid = false;
+			if(!match) continue;
+			thread = match->next();
+
+			try { match->state(entry.state); entry.valid = true; written++; }
+			catch(Cpu_thread::State_access_failed) { }
+		}
+
+		return written;
+	};
+
+	return _thread_ep.apply(buffer_cap, lambda);
+}
+
+
+Native_cpu_component::Native_cpu_component(Cpu_session_component &cpu_session, char const *)
+:
+	_cpu_session(cpu_session), _thread_ep(*_cpu_session._thread_ep)
+{
+	_thread_ep.manage(this);
+}
+
+
+Genode::Native_cpu_component::~Native_cpu_component()
+{
+	_thread_ep.dissolve(this);
+}
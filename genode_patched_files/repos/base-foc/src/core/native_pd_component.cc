@@ -13,6 +13,11 @@
 
 #include <pd_session_component.h>
 #include <native_pd_component.h>
+#include <region_map_component.h>
+#include <ram_session_component.h>
+
+/* base-internal includes */
+#include <base/internal/cap_map.h>
 
 namespace Fiasco {
 #include <l4/sys/task.h>
@@ -39,35 +44,199 @@ void Native_pd_component::cap_map_info(addr_t addr)
 	_cap_map_info = addr;
 }
 
-void Native_pd_component::install(Native_capability cap, addr_t kcap)
+
+Foc_native_pd::Cap_map_layout Native_pd_component::cap_map_layout()
+{
+	return _cap_map_layout;
+}
+
+
+void Native_pd_component::cap_map_layout(Cap_map_layout const &layout)
+{
+	_cap_map_layout = layout;
+	_cap_map_info   = layout.struct_addr;
+}
+
+bool Native_pd_component::_map(addr_t core_kcap, addr_t kcap)
 {
 	using namespace Fiasco;
 
-	//log("Native_pd::\033[33m", __func__, "\033[0m(", cap, ", kcap=", Hex(kcap), ")");
+	l4_cap_idx_t const task = task_cap().data()->kcap();
 
 	// Testing whether remote task has a valid cap at the target cap selector
 	{
-		l4_msgtag_t tag = l4_task_cap_valid(task_cap().data()->kcap(), (l4_cap_idx_t) kcap);
+		l4_msgtag_t tag = l4_task_cap_valid(task, (l4_cap_idx_t) kcap);
 		if(l4_msgtag_label(tag))
 			warning("Overriding valid capability at kcap=", Hex(kcap));
 	}
 
 	// Mapping cap from core's cap space to the task associated with this native PD session
 	{
-		l4_msgtag_t tag = l4_task_map(task_cap().data()->kcap(), L4_BASE_TASK_CAP,
-					l4_obj_fpage((l4_cap_idx_t)cap.data()->kcap(), 0, L4_FPAGE_RWX),
+		l4_msgtag_t tag = l4_task_map(task, L4_BASE_TASK_CAP,
+					l4_obj_fpage((l4_cap_idx_t)core_kcap, 0, L4_FPAGE_RWX),
 					((l4_cap_idx_t)kcap | L4_ITEM_MAP));
 
 		if (l4_msgtag_has_error(tag))
+		{
 			error("mapping cap failed");
+			return false;
+		}
 	}
+
+	return true;
+}
+
+
+void Native_pd_component::install(Native_capability cap, addr_t kcap)
+{
+	//log("Native_pd::\033[33m", __func__, "\033[0m(", cap, ", kcap=", Hex(kcap), ")");
+
+	_map(cap.data()->kcap(), kcap);
+}
+
+
+void Native_pd_component::install_batch(Install_batch &batch, Native_capability cap0, Native_capability cap1,
+                                        Native_capability cap2, Native_capability cap3)
+{
+	//log("Native_pd::\033[33m", __func__, "\033[0m(count=", batch.count, ")");
+
+	Native_capability const caps[Install_batch::MAX_ENTRIES] = { cap0, cap1, cap2, cap3 };
+
+	unsigned const count = min(batch.count, (unsigned)Install_batch::MAX_ENTRIES);
+	for(unsigned i = 0; i < count; i++)
+	{
+		Install_batch::Entry &entry = batch.entries[i];
+
+		// Only capabilities received with this call are installed; invalid ones are left to the caller
+		entry.installed = caps[i].valid() && _map(caps[i].data()->kcap(), entry.kcap);
+	}
+}
+
+
+void Native_pd_component::attach_batch(Capability<Region_map> region_map, Attach_batch &batch,
+                                       Dataspace_capability ds0, Dataspace_capability ds1,
+                                       Dataspace_capability ds2)
+{
+	//log("Native_pd::\033[33m", __func__, "\033[0m(", region_map, ", count=", batch.count, ")");
+
+	Dataspace_capability const dataspaces[Attach_batch::MAX_ENTRIES] = { ds0, ds1, ds2 };
+
+	unsigned const count = min(batch.count, (unsigned)Attach_batch::MAX_ENTRIES);
+
+	_pd_session._thread_ep.apply(region_map, [&] (Region_map_component *rm) {
+
+		// Region maps not served by this entrypoint are left to the caller
+		if(!rm) return;
+
+		for(unsigned i = 0; i < count; i++)
+		{
+			Attach_batch::Entry &entry = batch.entries[i];
+
+			// Only dataspaces received with this call are attached
+			if(!dataspaces[i].valid()) continue;
+
+			try
+			{
+				Region_map::Local_addr addr =
+					rm->attach(dataspaces[i], entry.size, 0, true, entry.rel_addr, false);
+
+				entry.attached = ((addr_t)addr == entry.rel_addr);
+			}
+			catch(Region_map::Invalid_dataspace) { }
+			catch(Region_map::Region_conflict)   { }
+			catch(Region_map::Out_of_metadata)   { }
+			catch(Region_map::Invalid_args)      { }
+		}
+	});
+}
+
+
+void Native_pd_component::alloc_attach_batch(Capability<Region_map> region_map, Capability<Ram_session> ram,
+                                             Alloc_attach_batch &batch, Ram_dataspace_capability &ds0,
+                                             Ram_dataspace_capability &ds1, Ram_dataspace_capability &ds2)
+{
+	//log("Native_pd::\033[33m", __func__, "\033[0m(", region_map, ", ", ram, ", count=", batch.count, ")");
+
+	Ram_dataspace_capability *dataspaces[Alloc_attach_batch::MAX_ENTRIES] = { &ds0, &ds1, &ds2 };
+	for(unsigned i = 0; i < Alloc_attach_batch::MAX_ENTRIES; i++)
+		*dataspaces[i] = Ram_dataspace_capability();
+
+	unsigned const count = min(batch.count, (unsigned)Alloc_attach_batch::MAX_ENTRIES);
+
+	_pd_session._thread_ep.apply(ram, [&] (Ram_session_component *ram_session) {
+
+		// RAM sessions and region maps not served by this entrypoint are left to the caller
+		if(!ram_session) return;
+
+		_pd_session._thread_ep.apply(region_map, [&] (Region_map_component *rm) {
+
+			if(!rm) return;
+
+			for(unsigned i = 0; i < count; i++)
+			{
+				Alloc_attach_batch::Entry &entry = batch.entries[i];
+
+				// The remaining dataspaces are left to the caller, which reports the exhausted quota
+				try { *dataspaces[i] = ram_session->alloc(entry.size, batch.cached); }
+				catch(Ram_session::Quota_exceeded)  { break; }
+				catch(Ram_session::Out_of_metadata) { break; }
+
+				try
+				{
+					Region_map::Local_addr addr =
+						rm->attach(*dataspaces[i], entry.size, 0, true, entry.rel_addr, false);
+
+					entry.attached = ((addr_t)addr == entry.rel_addr);
+				}
+				catch(Region_map::Invalid_dataspace) { }
+				catch(Region_map::Region_conflict)   { }
+				catch(Region_map::Out_of_metadata)   { }
+				catch(Region_map::Invalid_args)      { }
+			}
+		});
+	});
+}
+
+
+void Native_pd_component::detach_batch(Capability<Region_map> region_map, Detach_batch &batch)
+{
+	//log("Native_pd::\033[33m", __func__, "\033[0m(", region_map, ", count=", batch.count, ")");
+
+	unsigned const count = min(batch.count, (unsigned)Detach_batch::MAX_ENTRIES);
+
+	_pd_session._thread_ep.apply(region_map, [&] (Region_map_component *rm) {
+
+		// Region maps not served by this entrypoint are left to the caller
+		if(!rm) return;
+
+		for(unsigned i = 0; i < count; i++)
+		{
+			Detach_batch::Entry &entry = batch.entries[i];
+
+			// The entry is reported as detached only if a region started at each of its addresses
+			bool detached = true;
+			for(unsigned j = 0; j < entry.count; j++)
+			{
+				addr_t const addr = entry.rel_addr + j*entry.stride;
+
+				bool const attached = rm->apply_to_dataspace(addr,
+					[&] (Region_map_component *, Rm_region *region, addr_t, addr_t) -> bool {
+						return region && region->base() == addr; }, 0, 1);
+
+				if(attached) rm->detach(addr);
+				else detached = false;
+			}
+
+			entry.detached = detached;
+		}
+	});
 }
 
 
 Native_pd_component::Native_pd_component(Pd_session_component &pd_session,
                                          char const *args)
 :
-	_pd_session(pd_session), _cap_map_info(0)
+	_pd_session(pd_session), _cap_map_info(0), _cap_map_layout()
 {
 	_pd_session._thread_ep.manage(this);
 }
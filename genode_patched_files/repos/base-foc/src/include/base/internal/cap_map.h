@@ -122,6 +122,12 @@ namespace Genode {
 	Cap_index_allocator *cap_idx_alloc();
 
 
+	/**
+	 * Get the number of Cap_index slots of the global Cap_index_allocator
+	 */
+	size_t cap_idx_alloc_slots();
+
+
 	/**
 	 * Low-level spin-lock to protect Cap_index_allocator and the Cap_map
 	 *
@@ -48,6 +48,13 @@ class Genode::Native_capability::Data : public List<Data>::Element, Noncopyable
 		uint8_t  dec();
 		addr_t   kcap() const;
 
+		/**
+		 * Offsets of the members within a Data object, used to describe the
+		 * layout of the capability map to a checkpointer
+		 */
+		static size_t ref_cnt_offset() { Data d; return (addr_t)&d._ref_cnt - (addr_t)&d; }
+		static size_t id_offset()      { Data d; return (addr_t)&d._id - (addr_t)&d; }
+
 		void* operator new    (size_t size, Data* idx) { return idx; }
 		void  operator delete (void* idx) { memset(idx, 0, sizeof(Data)); }
 
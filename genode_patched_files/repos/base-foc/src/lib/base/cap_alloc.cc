@@ -0,0 +1,40 @@
+/*
+ * \brief  Capability index allocator for Fiasco.OC non-core processes.
+ * \author Stefan Kalkowski
+ * \date   2012-02-16
+ */
+
+/*
+ * Copyright (C) 2012-2013 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* base-internal includes */
+#include <base/internal/cap_alloc.h>
+
+/**
+ * Number of Cap_index slots of a component
+ *
+ * Components with large capability spaces set it in the build, e.g. by
+ * CC_OPT += -DCAP_INDEX_SLOTS=16384 in the build description of the base
+ * library. The layout of the capability map is reported to the PD session
+ * (see init_pd), thus, a checkpointer does not depend on this value.
+ */
+#ifndef CAP_INDEX_SLOTS
+#define CAP_INDEX_SLOTS (4*1024)
+#endif
+
+
+Genode::Cap_index_allocator* Genode::cap_idx_alloc()
+{
+	static Genode::Cap_index_allocator_tpl<Genode::Cap_index, CAP_INDEX_SLOTS> alloc;
+	return &alloc;
+}
+
+
+Genode::size_t Genode::cap_idx_alloc_slots()
+{
+	return CAP_INDEX_SLOTS;
+}
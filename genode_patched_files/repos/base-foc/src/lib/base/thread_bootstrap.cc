@@ -49,7 +49,7 @@ void prepare_reinit_main_thread()
 
 
 /**
- * Sets cap_map_info in Foc_native_pd
+ * Sets cap_map_info and the layout of the capability map in Foc_native_pd
  */
 void init_pd()
 {
@@ -60,7 +60,17 @@ void init_pd()
 	if(native_pd_cap.valid())
 	{
 		Capability<Foc_native_pd> foc_pd_cap = static_cap_cast<Foc_native_pd>(native_pd_cap);
-		Foc_native_pd_client(foc_pd_cap).cap_map_info((addr_t) cap_idx_alloc());
+
+		Foc_native_pd::Cap_map_layout layout;
+		layout.struct_addr    = (addr_t) cap_idx_alloc();
+		layout.array_addr     = (addr_t) cap_idx_alloc()->kcap_to_idx(0);
+		layout.num_slots      = cap_idx_alloc_slots();
+		layout.element_size   = sizeof(Cap_index);
+		layout.ref_cnt_offset = Cap_index::ref_cnt_offset();
+		layout.badge_offset   = Cap_index::id_offset();
+		layout.user_slot      = Fiasco::USER_BASE_CAP >> Fiasco::L4_CAP_SHIFT;
+
+		Foc_native_pd_client(foc_pd_cap).cap_map_layout(layout);
 		//log("from thread_bootstrap: ", cap_idx_alloc());
 	}
 
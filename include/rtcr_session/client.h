@@ -19,11 +19,44 @@ struct Rtcr::Session_client : Genode::Rpc_client<Rtcr::Session>
 	explicit Session_client(Rtcr::Session_capability session)
 	: Rpc_client<Session>(session) { }
 
-	void checkpoint(Name const &name) override {
-		call<Rpc_checkpoint>(name); }
+	void start(Name const &name, Genode::size_t granularity) override {
+		call<Rpc_start>(name, granularity); }
 
-	void restore(Name const &name) override {
-		call<Rpc_restore>(name); }
+	unsigned checkpoint(Name const &name) override {
+		return call<Rpc_checkpoint>(name); }
+
+	void restore(Name const &name, unsigned generation = 0) override {
+		call<Rpc_restore>(name, generation); }
+
+	unsigned clone(Name const &name, unsigned count, unsigned generation = 0) override {
+		return call<Rpc_clone>(name, count, generation); }
+
+	unsigned destroy_clones(Name const &name) override {
+		return call<Rpc_destroy_clones>(name); }
+
+	void failover(Name const &name) override {
+		call<Rpc_failover>(name); }
+
+	Job checkpoint_async(Name const &name) override {
+		return call<Rpc_checkpoint_async>(name); }
+
+	Job restore_async(Name const &name, unsigned generation = 0) override {
+		return call<Rpc_restore_async>(name, generation); }
+
+	void completion_sigh(Genode::Signal_context_capability sigh) override {
+		call<Rpc_completion_sigh>(sigh); }
+
+	Genode::Dataspace_capability status_dataspace() override {
+		return call<Rpc_status_dataspace>(); }
+
+	Prediction predict(Name const &name) override {
+		return call<Rpc_predict>(name); }
+
+	unsigned phase_records(Name const &name) override {
+		return call<Rpc_phase_records>(name); }
+
+	Genode::Dataspace_capability phase_dataspace() override {
+		return call<Rpc_phase_dataspace>(); }
 };
 
 #endif /* _INCLUDE__RTCR_SESSION__CLIENT_H_ */
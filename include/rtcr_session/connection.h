@@ -15,12 +15,17 @@ namespace Rtcr { struct Connection; }
 
 struct Rtcr::Connection : Genode::Connection<Rtcr::Session>, Rtcr::Session_client
 {
+	/**
+	 * Covers the entrypoint, the Timer session, the shared pages, and the running jobs of the session
+	 */
+	enum { RAM_QUOTA = 512*1024 };
+
 	/**
 	 * Constructor
 	 */
 	Connection(Genode::Env &env)
 	:
-		Genode::Connection<Rtcr::Session>(env, session(env.parent(), "ram_quota=4K")),
+		Genode::Connection<Rtcr::Session>(env, session(env.parent(), "ram_quota=%u", (unsigned)RAM_QUOTA)),
 		Session_client(cap())
 	{ }
 };
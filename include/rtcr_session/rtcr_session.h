@@ -9,6 +9,8 @@
 
 #include <session/session.h>
 #include <base/rpc.h>
+#include <base/signal.h>
+#include <dataspace/capability.h>
 #include <util/string.h>
 
 namespace Rtcr { struct Session; }
@@ -20,23 +22,275 @@ struct Rtcr::Session : Genode::Session
 	 */
 	struct Exception : Genode::Exception { };
 	struct Rom_module_does_not_exist : Exception { };
+	struct Target_does_not_exist     : Exception { };
+	struct Target_already_exists     : Exception { };
+	struct Checkpoint_does_not_exist : Exception { };
+	struct Too_many_jobs             : Exception { };
+
+	/**
+	 * Jobs of a session which run at the same time
+	 */
+	enum { MAX_RUNNING_JOBS = 4 };
 
 	typedef Genode::Rpc_in_buffer<64> Name;
 
+	/**
+	 * Handle of an asynchronous checkpoint or restore; valid handles are greater than zero
+	 */
+	typedef unsigned Job;
+
+	/**
+	 * Status of a job; it is updated by Rtcr while the job proceeds
+	 */
+	struct Job_status
+	{
+		enum Phase { UNUSED, QUEUED, WAITING_FOR_TARGET, CHECKPOINTING, RESTORING, DONE, FAILED };
+
+		Job              job;
+		unsigned         phase;
+		/**
+		 * Generation of the checkpoint, valid when a checkpoint is DONE
+		 */
+		unsigned         generation;
+		Genode::uint64_t bytes_copied;
+		Genode::uint64_t elapsed_ms;
+	};
+
+	/**
+	 * Layout of the status dataspace; the status of job is in jobs[job % MAX_JOBS]
+	 */
+	struct Status_page
+	{
+		enum { MAX_JOBS = 64 };
+
+		Job_status jobs[MAX_JOBS];
+	};
+
+	/**
+	 * Predicted cost of the next checkpoint of a target, derived from its current dirty set
+	 * and the costs measured by Rtcr at startup
+	 */
+	struct Prediction
+	{
+		Genode::uint64_t dirty_bytes;
+		unsigned         dirty_dataspaces;
+		/**
+		 * Pause of the target by the checkpoint
+		 */
+		Genode::uint64_t pause_us;
+		/**
+		 * Handling of the faults by which the target marks the same memory dirty again
+		 */
+		Genode::uint64_t refault_us;
+		/**
+		 * Restore of the target from its last checkpoint
+		 */
+		Genode::uint64_t restore_us;
+	};
+
+	/**
+	 * Timing of a phase of a checkpoint or restore
+	 */
+	struct Phase_record
+	{
+		enum Phase {
+			/* checkpoint */
+			PAUSE, CAP_MAP_SCAN, REGION_MAP_DATASPACES, PREPARE_RAM, PREPARE_PD, PREPARE_CPU,
+			PREPARE_RM, PREPARE_LOG, PREPARE_TIMER, MEMORY_LIST, RESOLVE_INC, DETACH_DESIGNATED,
+			COPY_MEMORY, RESUME, FINISH_DEFERRED, KEEP_GENERATION,
+			/* restore */
+			ROLLBACK, EXPAND_GENERATION, PREPARE_RESTORE, IDENTIFY_RECREATE, RESTORE_STATE,
+			RESTORE_MEMORY_LIST, RESTORE_CAP_MAP, RESTORE_CAP_SPACE, RESTORE_MEMORY, START_THREADS
+		};
+
+		unsigned         phase;
+		/**
+		 * Start and duration in ticks of Genode::Trace::timestamp()
+		 */
+		Genode::uint64_t start;
+		Genode::uint64_t duration;
+		/**
+		 * Number of objects and bytes processed by the phase
+		 */
+		unsigned         objects;
+		Genode::uint64_t bytes;
+	};
+
+	struct Operation_record
+	{
+		enum Operation { CHECKPOINT, RESTORE };
+		enum { MAX_PHASES = 24 };
+
+		unsigned         seq;
+		unsigned         operation;
+		Genode::uint64_t start;
+		Genode::uint64_t duration;
+		unsigned         num_phases;
+		Phase_record     phases[MAX_PHASES];
+	};
+
+	/**
+	 * Layout of the phase dataspace; it holds the last operations of a target, oldest first
+	 */
+	struct Phase_page
+	{
+		enum { MAX_OPERATIONS = 16 };
+
+		/**
+		 * Ticks of Genode::Trace::timestamp() per microsecond, as calibrated by Rtcr at startup
+		 */
+		Genode::uint64_t ticks_per_us;
+		unsigned         count;
+		Operation_record operations[MAX_OPERATIONS];
+	};
+
 	static const char *service_name() { return "Rtcr"; }
 
 	virtual ~Session() { }
 
-	virtual void checkpoint(Name const &component) = 0;
-	virtual void restore(Name const &component) = 0;
+	/**
+	 * Start the component from its rom module as a target of Rtcr
+	 *
+	 * \param granularity Size of designated dataspaces for incremental checkpointing
+	 *                    in pages; zero means the whole memory is copied by each checkpoint
+	 */
+	virtual void start(Name const &component, Genode::size_t granularity) = 0;
+
+	/**
+	 * Checkpoint the target
+	 *
+	 * Rtcr keeps the last checkpoint of a target and a bounded number of older
+	 * generations, set by the generations attribute of its <target> node. The
+	 * oldest generation is dropped when the bound is exceeded. Clones keep the
+	 * generation from which they were started.
+	 *
+	 * With a pause budget, e.g. set by a <schedule> policy, the call returns after
+	 * the target is resumed. The memory left by the budget is copied in the
+	 * background; a following checkpoint, restore, or clone waits for it.
+	 *
+	 * \return generation of the checkpoint; the generations of a target are counted from 1
+	 */
+	virtual unsigned checkpoint(Name const &component) = 0;
+
+	/**
+	 * Revert the target to a checkpoint
+	 *
+	 * The target is rolled back in place, if possible. Otherwise, it is replaced
+	 * by a target restored from the checkpoint. Following checkpoints continue
+	 * from the restored generation; they get new generation numbers.
+	 *
+	 * \param generation Generation to restore; zero means the last checkpoint
+	 *
+	 * \throw Checkpoint_does_not_exist if the generation is not kept
+	 */
+	virtual void restore(Name const &component, unsigned generation = 0) = 0;
+
+	/**
+	 * Start count clones of the checkpointed component
+	 *
+	 * The clones are restored from a checkpoint of the component and share its
+	 * stored memory content. Later checkpoints of the component do not change
+	 * the content seen by the clones.
+	 *
+	 * \param generation Generation of the clones; zero means the last checkpoint
+	 *
+	 * \return number of started clones
+	 */
+	virtual unsigned clone(Name const &component, unsigned count, unsigned generation = 0) = 0;
+
+	/**
+	 * Destroy the clones of the component
+	 *
+	 * \return number of destroyed clones
+	 */
+	virtual unsigned destroy_clones(Name const &component) = 0;
+
+	/**
+	 * Replace the target by its standby replica, which continues from the last checkpoint
+	 *
+	 * The standby is configured by a <standby> node of the <target> node in the
+	 * config of Rtcr. A new replica is restored from the next checkpoint.
+	 *
+	 * \throw Checkpoint_does_not_exist if the target has no standby or no checkpoint
+	 */
+	virtual void failover(Name const &component) = 0;
+
+	/**
+	 * Start an asynchronous checkpoint of the target
+	 *
+	 * The call returns immediately. The progress is reported in the status dataspace,
+	 * and the completion signal is submitted when the job is DONE or FAILED.
+	 *
+	 * \throw Too_many_jobs  if the status slot of the job is still in use, or if the
+	 *                       session runs MAX_RUNNING_JOBS jobs already
+	 */
+	virtual Job checkpoint_async(Name const &component) = 0;
+
+	/**
+	 * Start an asynchronous restore of the target
+	 *
+	 * \param generation Generation to restore; zero means the last checkpoint. The
+	 *                   job FAILED, if the generation is not kept
+	 */
+	virtual Job restore_async(Name const &component, unsigned generation = 0) = 0;
+
+	/**
+	 * Register the signal handler for the completion of jobs
+	 */
+	virtual void completion_sigh(Genode::Signal_context_capability sigh) = 0;
+
+	/**
+	 * Return the dataspace containing the Status_page of the session's jobs
+	 */
+	virtual Genode::Dataspace_capability status_dataspace() = 0;
+
+	/**
+	 * Predict the cost of checkpointing the target now, without checkpointing it
+	 */
+	virtual Prediction predict(Name const &component) = 0;
+
+	/**
+	 * Copy the phase timings of the last checkpoints and restores of the target to the phase dataspace
+	 *
+	 * \return number of copied operations
+	 */
+	virtual unsigned phase_records(Name const &component) = 0;
+
+	/**
+	 * Return the dataspace containing the Phase_page filled by phase_records
+	 */
+	virtual Genode::Dataspace_capability phase_dataspace() = 0;
 
 	/*******************
 	 ** RPC interface **
 	 *******************/
 
-	GENODE_RPC_THROW(Rpc_checkpoint, void, checkpoint, GENODE_TYPE_LIST(Rom_module_does_not_exist), Name const &);
-	GENODE_RPC_THROW(Rpc_restore, void, restore, GENODE_TYPE_LIST(Rom_module_does_not_exist), Name const &);
-	GENODE_RPC_INTERFACE(Rpc_checkpoint, Rpc_restore);
+	GENODE_RPC_THROW(Rpc_start, void, start,
+			GENODE_TYPE_LIST(Rom_module_does_not_exist, Target_already_exists), Name const &, Genode::size_t);
+	GENODE_RPC_THROW(Rpc_checkpoint, unsigned, checkpoint,
+			GENODE_TYPE_LIST(Target_does_not_exist), Name const &);
+	GENODE_RPC_THROW(Rpc_restore, void, restore,
+			GENODE_TYPE_LIST(Target_does_not_exist, Checkpoint_does_not_exist), Name const &, unsigned);
+	GENODE_RPC_THROW(Rpc_clone, unsigned, clone,
+			GENODE_TYPE_LIST(Target_does_not_exist, Checkpoint_does_not_exist), Name const &, unsigned, unsigned);
+	GENODE_RPC_THROW(Rpc_destroy_clones, unsigned, destroy_clones,
+			GENODE_TYPE_LIST(Target_does_not_exist), Name const &);
+	GENODE_RPC_THROW(Rpc_failover, void, failover,
+			GENODE_TYPE_LIST(Target_does_not_exist, Checkpoint_does_not_exist), Name const &);
+	GENODE_RPC_THROW(Rpc_checkpoint_async, Job, checkpoint_async,
+			GENODE_TYPE_LIST(Too_many_jobs), Name const &);
+	GENODE_RPC_THROW(Rpc_restore_async, Job, restore_async,
+			GENODE_TYPE_LIST(Too_many_jobs), Name const &, unsigned);
+	GENODE_RPC(Rpc_completion_sigh, void, completion_sigh, Genode::Signal_context_capability);
+	GENODE_RPC(Rpc_status_dataspace, Genode::Dataspace_capability, status_dataspace);
+	GENODE_RPC_THROW(Rpc_predict, Prediction, predict,
+			GENODE_TYPE_LIST(Target_does_not_exist), Name const &);
+	GENODE_RPC_THROW(Rpc_phase_records, unsigned, phase_records,
+			GENODE_TYPE_LIST(Target_does_not_exist), Name const &);
+	GENODE_RPC(Rpc_phase_dataspace, Genode::Dataspace_capability, phase_dataspace);
+	GENODE_RPC_INTERFACE(Rpc_start, Rpc_checkpoint, Rpc_restore, Rpc_clone, Rpc_destroy_clones,
+			Rpc_failover, Rpc_checkpoint_async, Rpc_restore_async, Rpc_completion_sigh, Rpc_status_dataspace,
+			Rpc_predict, Rpc_phase_records, Rpc_phase_dataspace);
 };
 
 #endif /* _INCLUDE__RTCR_SESSION__RTCR_SESSION_H_ */
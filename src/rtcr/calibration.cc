@@ -0,0 +1,164 @@
+/*
+ * \brief  Calibration of the checkpoint costs and prediction of checkpoint pauses
+ * \author agent
+ * \date   2026-10-18
+ */
+
+/* Genode includes */
+#include <base/signal.h>
+#include <rm_session/connection.h>
+#include <region_map/client.h>
+#include <pd_session/connection.h>
+#include <foc_native_pd/client.h>
+#include <util/retry.h>
+#include <trace/timestamp.h>
+
+/* Rtcr includes */
+#include "calibration.h"
+#include "util/cap_map_scanner.h"
+
+using namespace Rtcr;
+
+
+void Calibration::_measure_attach()
+{
+	Genode::Ram_dataspace_capability ds_cap = _env.ram().alloc(PAGE_SIZE);
+
+	Genode::Trace::Timestamp const start = Genode::Trace::timestamp();
+	for(unsigned i = 0; i < ITERATIONS; i++)
+		_env.rm().detach(_env.rm().attach(ds_cap));
+	_costs.attach_us = _elapsed_us(start, ITERATIONS);
+
+	_env.ram().free(ds_cap);
+}
+
+
+void Calibration::_measure_copy()
+{
+	Genode::Ram_dataspace_capability src_cap = _env.ram().alloc(COPY_SIZE);
+	Genode::Ram_dataspace_capability dst_cap = _env.ram().alloc(COPY_SIZE);
+	char *src = _env.rm().attach(src_cap);
+	char *dst = _env.rm().attach(dst_cap);
+
+	// Touch both dataspaces first; the page faults of the first access are not part of a copy
+	Genode::memcpy(dst, src, COPY_SIZE);
+
+	Genode::Trace::Timestamp const start = Genode::Trace::timestamp();
+	for(unsigned i = 0; i < COPY_ROUNDS; i++)
+		Genode::memcpy(dst, src, COPY_SIZE);
+	_costs.copy_us_per_mib = _elapsed_us(start, COPY_ROUNDS);
+
+	_env.rm().detach(dst);
+	_env.rm().detach(src);
+	_env.ram().free(dst_cap);
+	_env.ram().free(src_cap);
+}
+
+
+void Calibration::_measure_fault()
+{
+	Genode::Rm_connection rm(_env);
+	Genode::Capability<Genode::Region_map> region_map_cap =
+		Genode::retry<Genode::Rm_session::Out_of_metadata>(
+			[&] () { return rm.create(FAULT_PAGES*PAGE_SIZE); },
+			[&] ()
+			{
+				char args[Genode::Parent::Session_args::MAX_SIZE];
+				Genode::snprintf(args, sizeof(args), "ram_quota=%u", 64*1024);
+				_env.parent().upgrade(rm, args);
+			});
+	Genode::Region_map_client region_map(region_map_cap);
+
+	Genode::Signal_receiver receiver;
+	Genode::Signal_context  context;
+	region_map.fault_handler(receiver.manage(&context));
+
+	Genode::Ram_dataspace_capability pages[FAULT_PAGES];
+	for(unsigned i = 0; i < FAULT_PAGES; i++) pages[i] = _env.ram().alloc(PAGE_SIZE);
+
+	char *managed = _env.rm().attach(region_map.dataspace());
+	Toucher toucher(_env, managed);
+
+	Genode::Trace::Timestamp const start = Genode::Trace::timestamp();
+	toucher.start();
+	for(unsigned resolved = 0; resolved < FAULT_PAGES; )
+	{
+		receiver.wait_for_signal();
+
+		Genode::Region_map::State const state = region_map.state();
+		if(state.type == Genode::Region_map::State::READY) continue;
+
+		region_map.attach_at(pages[state.addr / PAGE_SIZE], state.addr & ~(Genode::addr_t)(PAGE_SIZE - 1));
+		resolved++;
+	}
+	toucher.join();
+	_costs.fault_us = _elapsed_us(start, FAULT_PAGES);
+
+	_env.rm().detach(managed);
+	receiver.dissolve(&context);
+	rm.destroy(region_map_cap);
+	for(unsigned i = 0; i < FAULT_PAGES; i++) _env.ram().free(pages[i]);
+}
+
+
+void Calibration::_measure_install()
+{
+	typedef Genode::Foc_native_pd::Install_batch Install_batch;
+
+	// Scratch task; the capabilities are installed to the same slots in each round
+	Genode::Pd_connection pd(_env, "calibration");
+	Genode::Foc_native_pd_client native_pd(pd.native_pd());
+
+	Genode::Ram_dataspace_capability caps[Install_batch::MAX_ENTRIES];
+	for(unsigned i = 0; i < Install_batch::MAX_ENTRIES; i++) caps[i] = _env.ram().alloc(PAGE_SIZE);
+
+	unsigned const rounds = ITERATIONS / Install_batch::MAX_ENTRIES;
+
+	Genode::Trace::Timestamp const start = Genode::Trace::timestamp();
+	for(unsigned round = 0; round < rounds; round++)
+	{
+		Install_batch batch;
+		for(unsigned i = 0; i < Install_batch::MAX_ENTRIES; i++)
+			batch.add(Cap_map_scanner::kcap(INSTALL_SLOT + i));
+		native_pd.install_batch(batch, caps[0], caps[1], caps[2], caps[3]);
+	}
+	_costs.install_us = _elapsed_us(start, rounds * Install_batch::MAX_ENTRIES);
+
+	for(unsigned i = 0; i < Install_batch::MAX_ENTRIES; i++) _env.ram().free(caps[i]);
+}
+
+
+void Calibration::_measure_timestamp()
+{
+	// The rate of the timestamp is measured by the timer, whose millisecond resolution is sufficient over TIMESTAMP_MS
+	unsigned long const start_ms = _timer.elapsed_ms();
+	Genode::Trace::Timestamp const start = Genode::Trace::timestamp();
+	_timer.msleep(TIMESTAMP_MS);
+	Genode::Trace::Timestamp const ticks = Genode::Trace::timestamp() - start;
+	unsigned long const elapsed_ms = Genode::max(_timer.elapsed_ms() - start_ms, 1UL);
+
+	_costs.ticks_per_us = Genode::max(ticks / (elapsed_ms * 1000), (Genode::Trace::Timestamp)1);
+}
+
+
+unsigned long Calibration::_elapsed_us(Genode::Trace::Timestamp start, unsigned count) const
+{
+	return (Genode::Trace::timestamp() - start) / (_costs.ticks_per_us * count);
+}
+
+
+Calibration::Calibration(Genode::Env &env)
+:
+	_env(env), _timer(env), _costs()
+{
+	// The costs are measured with the timestamp, whose rate is needed first
+	_measure_timestamp();
+	_measure_attach();
+	_measure_copy();
+	_measure_fault();
+	_measure_install();
+
+	Genode::log("Calibration: attach+detach ", _costs.attach_us, " us, copy ", _costs.copy_us_per_mib,
+			" us/MiB, fault ", _costs.fault_us, " us, cap install ", _costs.install_us, " us, ",
+			_costs.ticks_per_us, " timestamp ticks/us");
+}
@@ -0,0 +1,139 @@
+/*
+ * \brief  Calibration of the checkpoint costs and prediction of checkpoint pauses
+ * \author agent
+ * \date   2026-10-18
+ *
+ * At startup, Rtcr measures the costs of the operations a checkpoint consists
+ * of on the running system: attaching and detaching a dataspace in Rtcr's
+ * address space (twice per copied dataspace), copying memory, resolving a page
+ * fault of a managed dataspace (once per designated dataspace written after a
+ * checkpoint), and installing a capability into a task (for each capability of
+ * a restored target). Combined with the dirty set of a target, the costs
+ * predict the pause of its next checkpoint.
+ */
+
+#ifndef _RTCR_CALIBRATION_H_
+#define _RTCR_CALIBRATION_H_
+
+/* Genode includes */
+#include <base/env.h>
+#include <base/thread.h>
+#include <timer_session/connection.h>
+#include <trace/timestamp.h>
+
+namespace Rtcr {
+	class Calibration;
+}
+
+
+class Rtcr::Calibration
+{
+public:
+	struct Costs
+	{
+		/**
+		 * Attaching and detaching a dataspace in Rtcr's address space
+		 */
+		unsigned long attach_us;
+		unsigned long copy_us_per_mib;
+		/**
+		 * Round trip of a page fault of a managed dataspace, which is resolved by attaching a dataspace
+		 */
+		unsigned long fault_us;
+		/**
+		 * Installing a capability into a task by a batch
+		 */
+		unsigned long install_us;
+		/**
+		 * Ticks of Genode::Trace::timestamp() per microsecond, for converting the phase timings
+		 */
+		Genode::uint64_t ticks_per_us;
+	};
+
+private:
+	enum {
+		PAGE_SIZE    = 4096,
+		ITERATIONS   = 1024,
+		COPY_SIZE    = 1024*1024,
+		COPY_ROUNDS  = 32,
+		FAULT_PAGES  = 128,
+		/**
+		 * First slot of the capabilities installed into the scratch task
+		 */
+		INSTALL_SLOT = 0x1000,
+		TIMESTAMP_MS = 100
+	};
+
+	/**
+	 * Thread writing to each page of a managed dataspace; it is blocked by each fault until it is resolved
+	 */
+	struct Toucher : Genode::Thread
+	{
+		char *const base;
+
+		Toucher(Genode::Env &env, char *base)
+		:
+			Thread(env, "calibration toucher", 16*1024), base(base)
+		{ }
+
+		void entry() override
+		{
+			for(unsigned i = 0; i < FAULT_PAGES; i++) base[i*PAGE_SIZE] = 1;
+		}
+	};
+
+	Genode::Env       &_env;
+	Timer::Connection  _timer;
+	Costs              _costs;
+
+	/*
+	 * Noncopyable
+	 */
+	Calibration(Calibration const &);
+	Calibration &operator = (Calibration const &);
+
+	void _measure_attach();
+	void _measure_copy();
+	void _measure_fault();
+	void _measure_install();
+	void _measure_timestamp();
+	/**
+	 * Microseconds per operation of count operations since the timestamp start
+	 */
+	unsigned long _elapsed_us(Genode::Trace::Timestamp start, unsigned count) const;
+
+public:
+	/**
+	 * Constructor; measures the costs
+	 */
+	Calibration(Genode::Env &env);
+
+	Costs const &costs() const { return _costs; }
+
+	/**
+	 * Predicted pause of a checkpoint copying bytes from dataspaces
+	 */
+	Genode::uint64_t checkpoint_pause_us(Genode::size_t bytes, unsigned dataspaces) const
+	{
+		return (Genode::uint64_t)dataspaces * 2 * _costs.attach_us
+				+ (Genode::uint64_t)bytes * _costs.copy_us_per_mib / COPY_SIZE;
+	}
+
+	/**
+	 * Predicted time of handling the faults by which dataspaces are marked dirty again
+	 */
+	Genode::uint64_t refault_us(unsigned dataspaces) const
+	{
+		return (Genode::uint64_t)dataspaces * _costs.fault_us;
+	}
+
+	/**
+	 * Predicted time of restoring bytes from dataspaces and installing caps capabilities
+	 */
+	Genode::uint64_t restore_us(Genode::size_t bytes, unsigned dataspaces, unsigned caps) const
+	{
+		return checkpoint_pause_us(bytes, dataspaces) + (Genode::uint64_t)caps * _costs.install_us;
+	}
+};
+
+#endif /* _RTCR_CALIBRATION_H_ */
@@ -0,0 +1,288 @@
+/*
+ * \brief  Periodic checkpointing of registered targets with an adaptive interval
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#include "checkpoint_scheduler.h"
+
+using namespace Rtcr;
+
+
+Genode::uint64_t Checkpoint_scheduler::_dirty_budget(Scheduled_target const &target) const
+{
+	Genode::uint64_t budget = ~0ULL;
+
+	if(target.policy.loss_budget) budget = target.policy.loss_budget;
+
+	// Dirty memory which is copied within the pause budget at the measured cost
+	if(target.policy.pause_budget_ms && target.cost_us_per_mib)
+		budget = Genode::min(budget, (Genode::uint64_t)target.policy.pause_budget_ms * 1000 * 1024 * 1024
+				/ target.cost_us_per_mib);
+
+	return budget;
+}
+
+
+void Checkpoint_scheduler::_adapt(Scheduled_target &target, unsigned long elapsed_ms, unsigned long duration_ms,
+		Genode::uint64_t dirty)
+{
+	// Exponential moving averages with a weight of 1/4 for the new sample
+	auto smooth = [] (Genode::uint64_t average, Genode::uint64_t sample) {
+		return average ? (3*average + sample) / 4 : sample; };
+
+	if(elapsed_ms) target.dirty_rate = smooth(target.dirty_rate, dirty * 1000 / elapsed_ms);
+	if(dirty)      target.cost_us_per_mib = smooth(target.cost_us_per_mib, (Genode::uint64_t)duration_ms * 1000 * 1024 * 1024 / dirty);
+
+	// Interval in which the dirty rate fills the budget
+	Genode::uint64_t interval = target.policy.max_interval_ms;
+	Genode::uint64_t const budget = _dirty_budget(target);
+	if(budget != ~0ULL && target.dirty_rate)
+		interval = Genode::min(interval, budget * 1000 / target.dirty_rate);
+
+	target.interval_ms = Genode::max((Genode::uint64_t)target.policy.min_interval_ms, interval);
+
+	if(verbose_debug) Genode::log("Scheduler: ", target.name, " dirty=", dirty, " duration_ms=", duration_ms,
+			" dirty_rate=", target.dirty_rate, " cost_us_per_mib=", target.cost_us_per_mib,
+			" interval_ms=", target.interval_ms);
+}
+
+
+void Checkpoint_scheduler::_checkpoint(Scheduled_target &target)
+{
+	unsigned long    start_ms     = 0;
+	unsigned long    duration_ms  = 0;
+	unsigned long    pause_ms     = 0;
+	bool             budget_held  = true;
+	Genode::uint64_t copied       = 0;
+	bool             checkpointed = false;
+
+	try
+	{
+		_registry.apply(target.name, [&] (Target_registry::Target &registered) {
+			start_ms = _timer.elapsed_ms();
+			registered.checkpoint(target.policy.pause_budget_ms);
+			duration_ms = _timer.elapsed_ms() - start_ms;
+			pause_ms    = registered.pause_ms();
+			budget_held = registered.budget_held();
+			copied      = registered.bytes_copied();
+			checkpointed = true;
+		});
+	}
+	catch(Rtcr::Session::Exception)
+	{
+		Genode::warning("Could not checkpoint scheduled target ", target.name);
+	}
+
+	Genode::Lock::Guard guard(_lock);
+
+	// A failed checkpoint is released again by the next tick; it is not accounted
+	if(checkpointed)
+	{
+		// The target is resumed after its pause; the deferred memory is copied while it runs
+		unsigned long const resumed_ms = start_ms + pause_ms;
+
+		if(resumed_ms > target.deadline_ms)
+		{
+			target.deadline_misses++;
+			Genode::warning("Checkpoint of ", target.name, " missed its deadline by ", resumed_ms - target.deadline_ms, " ms");
+		}
+		if(!budget_held)
+		{
+			target.budget_overruns++;
+			Genode::warning("Checkpoint of ", target.name, " paused it for ", pause_ms, " ms; its budget is ",
+					target.policy.pause_budget_ms, " ms");
+		}
+
+		_adapt(target, target.release_ms - target.last_ckpt_ms, duration_ms, copied);
+		target.last_ckpt_ms = target.release_ms;
+	}
+	target.released     = false;
+	target.running      = false;
+
+	// Unscheduled during the checkpoint
+	if(target.removed) Genode::destroy(_alloc, &target);
+}
+
+
+Checkpoint_scheduler::Scheduled_target *Checkpoint_scheduler::_pick()
+{
+	Genode::Lock::Guard guard(_lock);
+
+	Scheduled_target *earliest = nullptr;
+	for(Scheduled_target *target = _targets.first(); target; target = target->next())
+	{
+		if(!target->released || target->running) continue;
+		if(!earliest || target->deadline_ms < earliest->deadline_ms) earliest = target;
+	}
+
+	if(earliest) earliest->running = true;
+	return earliest;
+}
+
+
+void Checkpoint_scheduler::_work()
+{
+	for(;;)
+	{
+		_released.down();
+		if(_shutdown) return;
+
+		Scheduled_target *target = _pick();
+		if(!target) continue;
+
+		_checkpoint(*target);
+	}
+}
+
+
+Checkpoint_scheduler::Scheduled_target *Checkpoint_scheduler::_find(Target_registry::Name const &name)
+{
+	Scheduled_target *target = _targets.first();
+	while(target && !(target->name == name)) target = target->next();
+	return target;
+}
+
+
+void Checkpoint_scheduler::_handle_tick()
+{
+	/*
+	 * The lock of a target is held during its checkpoint; thus, the dirty set is
+	 * determined without holding _lock, and the target is looked up again afterwards.
+	 * A target during an operation is skipped; the tick must not block the entrypoint
+	 */
+	for(unsigned i = 0; ; i++)
+	{
+		Target_registry::Name name;
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			Scheduled_target *target = _targets.first();
+			for(unsigned j = 0; target && j < i; j++) target = target->next();
+			if(!target) return;
+			if(target->released) continue;
+
+			name = target->name;
+		}
+
+		// The dirty memory is the memory of the designated dataspaces attached by faults since the last checkpoint
+		Genode::size_t dirty = 0;
+		unsigned dataspaces  = 0;
+		try
+		{
+			bool const idle = _registry.try_apply(name, [&] (Target_registry::Target &registered) {
+				registered.dirty_set(dirty, dataspaces); });
+			if(!idle) continue;
+		}
+		catch(Rtcr::Session::Exception)
+		{
+			Genode::warning("Scheduled target ", name, " does not exist");
+			continue;
+		}
+
+		unsigned long const now_ms = _timer.elapsed_ms();
+
+		Genode::Lock::Guard guard(_lock);
+
+		// Unscheduled or released in the meantime
+		Scheduled_target *target = _find(name);
+		if(!target || target->released) continue;
+
+		// The predicted pause covers the first checkpoints, whose cost is not measured yet
+		bool const over_pause = target->policy.pause_budget_ms
+				&& _calibration.checkpoint_pause_us(dirty, dataspaces) >= target->policy.pause_budget_ms * 1000ULL;
+
+		bool const due     = now_ms - target->last_ckpt_ms >= target->interval_ms;
+		bool const exceeds = now_ms - target->last_ckpt_ms >= target->policy.min_interval_ms
+				&& (dirty >= _dirty_budget(*target) || over_pause);
+
+		if(!due && !exceeds) continue;
+
+		target->released    = true;
+		target->release_ms  = now_ms;
+		target->deadline_ms = now_ms + target->policy.relative_deadline_ms();
+		_released.up();
+	}
+}
+
+
+Checkpoint_scheduler::Checkpoint_scheduler(Genode::Env &env, Genode::Allocator &alloc, Target_registry &registry,
+		Calibration const &calibration, unsigned tick_ms, unsigned workers)
+:
+	_registry(registry), _alloc(alloc), _calibration(calibration), _timer(env),
+	_tick_handler(env.ep(), *this, &Checkpoint_scheduler::_handle_tick),
+	_lock(), _targets(), _released(0), _num_workers(Genode::max(1U, Genode::min(workers, (unsigned)MAX_WORKERS))),
+	_density(0), _shutdown(false)
+{
+	for(unsigned i = 0; i < _num_workers; i++)
+	{
+		_workers[i] = new (_alloc) Worker(env, *this);
+		_workers[i]->start();
+	}
+
+	_timer.sigh(_tick_handler);
+	_timer.trigger_periodic(tick_ms*1000);
+}
+
+
+Checkpoint_scheduler::~Checkpoint_scheduler()
+{
+	_shutdown = true;
+	for(unsigned i = 0; i < _num_workers; i++) _released.up();
+	for(unsigned i = 0; i < _num_workers; i++)
+	{
+		_workers[i]->join();
+		Genode::destroy(_alloc, _workers[i]);
+	}
+
+	while(Scheduled_target *target = _targets.first())
+	{
+		_targets.remove(target);
+		Genode::destroy(_alloc, target);
+	}
+}
+
+
+bool Checkpoint_scheduler::schedule(Target_registry::Name const &name, Policy const &policy)
+{
+	if(verbose_debug) Genode::log("Scheduler::\033[33m", __func__, "\033[0m(", name, ", min_interval_ms=",
+			policy.min_interval_ms, ", max_interval_ms=", policy.max_interval_ms, ", deadline_ms=",
+			policy.relative_deadline_ms(), ", pause_budget_ms=", policy.pause_budget_ms,
+			", loss_budget=", policy.loss_budget, ")");
+
+	unschedule(name);
+
+	Scheduled_target *target = new (_alloc) Scheduled_target(name, policy, _timer.elapsed_ms());
+
+	Genode::Lock::Guard guard(_lock);
+
+	// Admission: the checkpoint has to fit into its deadline, and the workers must not be overloaded
+	unsigned long const density = target->density();
+	if(policy.pause_budget_ms > policy.relative_deadline_ms() || _density + density > 1000UL * _num_workers)
+	{
+		Genode::warning("Target ", name, " is not admitted: density ", density, "/1000, admitted ",
+				_density, "/1000 of ", _num_workers, " workers");
+		Genode::destroy(_alloc, target);
+		return false;
+	}
+
+	_density += density;
+	_targets.insert(target);
+	return true;
+}
+
+
+void Checkpoint_scheduler::unschedule(Target_registry::Name const &name)
+{
+	Genode::Lock::Guard guard(_lock);
+
+	Scheduled_target *target = _find(name);
+	if(!target) return;
+
+	_targets.remove(target);
+	_density -= target->density();
+
+	// A running checkpoint is finished by its worker, which destroys the target afterwards
+	if(target->running) target->removed = true;
+	else                Genode::destroy(_alloc, target);
+}
@@ -0,0 +1,242 @@
+/*
+ * \brief  Periodic checkpointing of registered targets with an adaptive interval
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The scheduler checkpoints each scheduled target periodically. The interval
+ * is not fixed; it is derived from the observed dirty rate of the target (the
+ * memory of the attached designated dataspaces, i.e. the faults since the last
+ * checkpoint) and the measured cost of its checkpoints, such that the pause of
+ * a checkpoint stays within the pause budget and the memory lost by a failure
+ * stays within the loss budget. Between checkpoints, the dirty memory is
+ * inspected on each tick; a checkpoint is released early, if a budget would be
+ * exceeded.
+ *
+ * A released checkpoint has to resume its target within the relative deadline
+ * of the target. A target with a pause budget is checkpointed in the budgeted
+ * mode of the Checkpointer: the memory which is not copied within the budget is
+ * copied after the target is resumed, and its pages are saved on their first
+ * write (copy-on-write). The released checkpoints are executed by a pool of checkpoint
+ * workers in the order of their absolute deadlines (non-preemptive EDF). A
+ * target is only admitted, if the density of all admitted targets, i.e. the sum
+ * of pause_budget / min(min_interval, deadline), does not exceed the number of
+ * workers; the pause budget is the worst-case execution time of its checkpoint.
+ *
+ * The policy is read from the config, e.g.
+ *
+ * <scheduler tick_ms="100" workers="2"/>
+ * <target name="sheep_counter" granularity="1">
+ *   <schedule min_interval_ms="100" max_interval_ms="10000" deadline_ms="50"
+ *             pause_budget_ms="5" loss_budget_kib="1024"/>
+ * </target>
+ */
+
+#ifndef _RTCR_CHECKPOINT_SCHEDULER_H_
+#define _RTCR_CHECKPOINT_SCHEDULER_H_
+
+/* Genode includes */
+#include <util/list.h>
+#include <util/xml_node.h>
+#include <base/signal.h>
+#include <base/thread.h>
+#include <base/semaphore.h>
+#include <timer_session/connection.h>
+
+/* Rtcr includes */
+#include "target_registry.h"
+#include "calibration.h"
+
+namespace Rtcr {
+	class Checkpoint_scheduler;
+
+	constexpr bool scheduler_verbose_debug = false;
+}
+
+
+class Rtcr::Checkpoint_scheduler
+{
+public:
+	struct Policy
+	{
+		unsigned         min_interval_ms;
+		unsigned         max_interval_ms;
+		/**
+		 * Time after the release of a checkpoint in which it has to be finished; zero means min_interval_ms
+		 */
+		unsigned         deadline_ms;
+		/**
+		 * Maximum pause of the target by a checkpoint; zero means no budget, and the target
+		 * is admitted without a guaranteed deadline
+		 */
+		unsigned         pause_budget_ms;
+		/**
+		 * Maximum dirty memory not yet checkpointed; zero means no budget
+		 */
+		Genode::uint64_t loss_budget;
+
+		Policy()
+		:
+			min_interval_ms(100), max_interval_ms(10000), deadline_ms(0),
+			pause_budget_ms(0), loss_budget(0)
+		{ }
+
+		unsigned relative_deadline_ms() const { return deadline_ms ? deadline_ms : min_interval_ms; }
+
+		static Policy from_xml(Genode::Xml_node node)
+		{
+			Policy policy;
+			policy.min_interval_ms = node.attribute_value("min_interval_ms", policy.min_interval_ms);
+			policy.max_interval_ms = node.attribute_value("max_interval_ms", policy.max_interval_ms);
+			policy.deadline_ms     = node.attribute_value("deadline_ms", policy.deadline_ms);
+			policy.pause_budget_ms = node.attribute_value("pause_budget_ms", policy.pause_budget_ms);
+			policy.loss_budget     = node.attribute_value("loss_budget_kib", 0UL) * 1024;
+
+			if(policy.max_interval_ms < policy.min_interval_ms) policy.max_interval_ms = policy.min_interval_ms;
+			return policy;
+		}
+	};
+
+	enum { MAX_WORKERS = 8 };
+
+private:
+	/**
+	 * Enable log output for debugging
+	 */
+	static constexpr bool verbose_debug = scheduler_verbose_debug;
+
+	struct Scheduled_target : Genode::List<Scheduled_target>::Element
+	{
+		Target_registry::Name const name;
+		Policy                const policy;
+		/**
+		 * Current interval
+		 */
+		unsigned long    interval_ms;
+		unsigned long    last_ckpt_ms;
+		/**
+		 * Smoothed dirty rate in bytes per second
+		 */
+		Genode::uint64_t dirty_rate;
+		/**
+		 * Smoothed checkpoint cost in microseconds per MiB of dirty memory
+		 */
+		Genode::uint64_t cost_us_per_mib;
+		/**
+		 * Released checkpoint: its release time and absolute deadline
+		 */
+		bool             released;
+		bool             running;
+		unsigned long    release_ms;
+		unsigned long    deadline_ms;
+		/**
+		 * Unscheduled while its checkpoint was running; it is destroyed by the worker
+		 */
+		bool             removed;
+		unsigned         deadline_misses;
+		unsigned         budget_overruns;
+
+		Scheduled_target(Target_registry::Name const &name, Policy const &policy, unsigned long now_ms)
+		:
+			name(name), policy(policy), interval_ms(policy.max_interval_ms), last_ckpt_ms(now_ms),
+			dirty_rate(0), cost_us_per_mib(0),
+			released(false), running(false), release_ms(0), deadline_ms(0),
+			removed(false), deadline_misses(0), budget_overruns(0)
+		{ }
+
+		/**
+		 * Fraction of a worker which the target's checkpoints need at most, in 1/1000
+		 */
+		unsigned long density() const
+		{
+			return 1000UL * policy.pause_budget_ms
+					/ Genode::min(policy.min_interval_ms, policy.relative_deadline_ms());
+		}
+	};
+
+	struct Worker : Genode::Thread
+	{
+		Checkpoint_scheduler &scheduler;
+
+		Worker(Genode::Env &env, Checkpoint_scheduler &scheduler)
+		:
+			Thread(env, "ckpt worker", 64*1024), scheduler(scheduler)
+		{ }
+
+		void entry() override
+		{
+			Event_trace::Thread_scope trace_scope;
+			scheduler._work();
+		}
+	};
+
+	Target_registry                              &_registry;
+	Genode::Allocator                            &_alloc;
+	/**
+	 * Predicts the pause of a checkpoint before any checkpoint of a target was measured
+	 */
+	Calibration const                            &_calibration;
+	Timer::Connection                             _timer;
+	Genode::Signal_handler<Checkpoint_scheduler>  _tick_handler;
+	/**
+	 * Protects _targets and the release state of the targets
+	 */
+	Genode::Lock                                  _lock;
+	Genode::List<Scheduled_target>                _targets;
+	/**
+	 * Counts the released checkpoints which are not yet picked by a worker
+	 */
+	Genode::Semaphore                             _released;
+	Worker                                       *_workers[MAX_WORKERS];
+	unsigned                                      _num_workers;
+	/**
+	 * Sum of the densities of the admitted targets, in 1/1000 of a worker
+	 */
+	unsigned long                                 _density;
+	bool                                          _shutdown;
+
+	/*
+	 * Noncopyable
+	 */
+	Checkpoint_scheduler(Checkpoint_scheduler const &);
+	Checkpoint_scheduler &operator = (Checkpoint_scheduler const &);
+
+	/**
+	 * Find the scheduled target name; _lock has to be held
+	 */
+	Scheduled_target *_find(Target_registry::Name const &name);
+	void _handle_tick();
+	/**
+	 * Loop of a worker: execute the released checkpoint with the earliest deadline
+	 */
+	void _work();
+	/**
+	 * Return the released target with the earliest deadline and mark it running
+	 */
+	Scheduled_target *_pick();
+
+	/**
+	 * Dirty memory which is allowed by the budgets of target
+	 */
+	Genode::uint64_t _dirty_budget(Scheduled_target const &target) const;
+	/**
+	 * Checkpoint the picked target; the target is destroyed afterwards, if it was unscheduled meanwhile
+	 */
+	void _checkpoint(Scheduled_target &target);
+	void _adapt(Scheduled_target &target, unsigned long elapsed_ms, unsigned long duration_ms, Genode::uint64_t dirty);
+
+public:
+	Checkpoint_scheduler(Genode::Env &env, Genode::Allocator &alloc, Target_registry &registry,
+			Calibration const &calibration, unsigned tick_ms = 100, unsigned workers = 1);
+	~Checkpoint_scheduler();
+
+	/**
+	 * Checkpoint the registered target name periodically
+	 *
+	 * \return false, if the target is not admitted because the deadlines of the admitted targets
+	 *         would become infeasible
+	 */
+	bool schedule(Target_registry::Name const &name, Policy const &policy);
+	void unschedule(Target_registry::Name const &name);
+};
+
+#endif /* _RTCR_CHECKPOINT_SCHEDULER_H_ */
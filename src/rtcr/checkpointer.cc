@@ -6,27 +6,24 @@
 
 #include "checkpointer.h"
 //#include "util/debug.h"
-#include <base/internal/cap_map.h>
-#include <base/internal/cap_alloc.h>
 
 using namespace Rtcr;
 
 
-Genode::List<Badge_kcap_info> Checkpointer::_create_cap_map_infos()
+void Checkpointer::_update_cap_map_infos()
 {
 	using Genode::log;
 	using Genode::Hex;
 	using Genode::addr_t;
 	using Genode::size_t;
-	using Genode::uint16_t;
 
 	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m()");
 
-	Genode::List<Badge_kcap_info> result;
-
-	// Retrieve cap_idx_alloc_addr
-	addr_t const cap_idx_alloc_addr = Genode::Foc_native_pd_client(_child.pd().native_pd()).cap_map_info();
+	// Retrieve the layout of the child's capability map
+	Cap_map_layout const child_layout = cap_map_layout(_child.pd().native_pd());
+	addr_t const cap_idx_alloc_addr = child_layout.struct_addr;
 	_state._cap_idx_alloc_addr = cap_idx_alloc_addr;
+	_state._cap_map_layout     = child_layout;
 
 	// Find child's dataspace corresponding to cap_idx_alloc_addr
 	Attached_region_info *ar_info = _child.pd().address_space_component().parent_state().attached_regions.first();
@@ -37,175 +34,61 @@ Genode::List<Badge_kcap_info> Checkpointer::_create_cap_map_infos()
 		throw Genode::Exception();
 	}
 
-	// If ar_info is a managed Ram_dataspace_info, mark detached Designated_dataspace_infos and attach them,
-	// thus, the Checkpointer does not trigger page faults which mark accessed regions
-	Genode::List<Ref_badge> marked_badge_infos =
-			_mark_attach_designated_dataspaces(*ar_info);
-
-	// Create new badge_kcap list
-	size_t const struct_size    = sizeof(Genode::Cap_index_allocator_tpl<Genode::Cap_index,4096>);
-	size_t const array_ele_size = sizeof(Genode::Cap_index);
-	size_t const array_size     = array_ele_size*4096;
-
-	addr_t const child_ds_start     = ar_info->rel_addr;
-	addr_t const child_ds_end       = child_ds_start + ar_info->size;
-	addr_t const child_struct_start = cap_idx_alloc_addr;
-	addr_t const child_struct_end   = child_struct_start + struct_size;
-	addr_t const child_array_start  = child_struct_start + 8;
-	addr_t const child_array_end    = child_array_start + array_size;
-
-	addr_t const local_ds_start     = _state._env.rm().attach(ar_info->attached_ds_cap, ar_info->size, ar_info->offset);
-	addr_t const local_ds_end       = local_ds_start + ar_info->size;
-	addr_t const local_struct_start = local_ds_start + (cap_idx_alloc_addr - child_ds_start);
-	addr_t const local_struct_end   = local_struct_start + struct_size;
-	addr_t const local_array_start  = local_struct_start + 8;
-	addr_t const local_array_end    = local_array_start + array_size;
-
-	if(verbose_debug)
-	{
-		log("child_ds_start:     ", Hex(child_ds_start));
-		log("child_struct_start: ", Hex(child_struct_start));
-		log("child_array_start:  ", Hex(child_array_start));
-		log("child_array_end:    ", Hex(child_array_end));
-		log("child_struct_end:   ", Hex(child_struct_end));
-		log("child_ds_end:       ", Hex(child_ds_end));
-
-		log("local_ds_start:     ", Hex(local_ds_start));
-		log("local_struct_start: ", Hex(local_struct_start));
-		log("local_array_start:  ", Hex(local_array_start));
-		log("local_array_end:    ", Hex(local_array_end));
-		log("local_struct_end:   ", Hex(local_struct_end));
-		log("local_ds_end:       ", Hex(local_ds_end));
-	}
+	Cap_map_scanner::Layout layout;
+	layout.array_addr   = child_layout.array_addr;
+	layout.num_slots    = child_layout.num_slots;
+	layout.element_size = child_layout.element_size;
+	layout.badge_offset = child_layout.badge_offset;
 
-	//dump_mem((void*)local_array_start, 0x1200);
+	addr_t const child_array_start = layout.array_addr;
+	addr_t const child_array_end   = child_array_start + layout.num_slots*layout.element_size;
 
-	enum { UNUSED = 0, INVALID_ID = 0xffff };
-	for(addr_t curr = local_array_start; curr < local_array_end; curr += array_ele_size)
+	// Attach the memory containing the array only once; it stays attached for subsequent checkpoints
+	if(_cap_map.backing_badge() != ar_info->attached_ds_cap.local_name())
 	{
-/*
-		log("  ",
-				Hex(*(Genode::uint8_t*)(curr+0), Hex::OMIT_PREFIX, Hex::PAD),
-				Hex(*(Genode::uint8_t*)(curr+1), Hex::OMIT_PREFIX, Hex::PAD),
-				Hex(*(Genode::uint8_t*)(curr+2), Hex::OMIT_PREFIX, Hex::PAD),
-				Hex(*(Genode::uint8_t*)(curr+3), Hex::OMIT_PREFIX, Hex::PAD), "  ",
-				Hex(*(Genode::uint8_t*)(curr+4), Hex::OMIT_PREFIX, Hex::PAD),
-				Hex(*(Genode::uint8_t*)(curr+5), Hex::OMIT_PREFIX, Hex::PAD),
-				Hex(*(Genode::uint8_t*)(curr+6), Hex::OMIT_PREFIX, Hex::PAD),
-				Hex(*(Genode::uint8_t*)(curr+7), Hex::OMIT_PREFIX, Hex::PAD));
-*/
-		size_t const badge_offset = 6;
-
-		// Convert address to pointer and dereference it
-		uint16_t const badge = *(uint16_t*)(curr + badge_offset);
-		// Current capability map slot = Compute distance from start to current address of array and
-		// divide it by the element size;
-		// kcap = current capability map slot shifted by 12 bits to the left (last 12 bits are used
-		// by Fiasco.OC for parameters for IPC calls)
-		addr_t const kcap  = ((curr - local_array_start) / array_ele_size) << 12;
-
-		if(badge != UNUSED && badge != INVALID_ID)
-		{
-			Badge_kcap_info *state_info = new (_alloc) Badge_kcap_info(kcap, badge);
-			result.insert(state_info);
-			//log("+ ", Hex(kcap), ": ", badge, " (", Hex(badge), ")");
-		}
-		else
-		{
-			//log("  ", Hex(kcap), ": ", badge);
-		}
-
-
-	}
-
-	_state._env.rm().detach(local_ds_start);
-
-	// Detach the previously attached Designated_dataspace_infos and delete the list containing marked Designated_dataspace_infos
-	_detach_unmark_designated_dataspaces(marked_badge_infos, *ar_info);
-
-	return result;
-}
+		_cap_map.unmap();
 
-
-void Checkpointer::_destroy_cap_map_infos(Genode::List<Badge_kcap_info> &cap_map_infos)
-{
-	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
-
-	while(Badge_kcap_info *info = cap_map_infos.first())
-	{
-		cap_map_infos.remove(info);
-		Genode::destroy(_alloc, info);
-	}
-}
-
-
-Genode::List<Ref_badge> Checkpointer::_mark_attach_designated_dataspaces(Attached_region_info &ar_info)
-{
-	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
-
-	Genode::List<Ref_badge> result_infos;
-
-	Managed_region_map_info *mrm_info = ar_info.managed_dataspace(_child.ram().parent_state().ram_dataspaces);
-	if(mrm_info)
-	{
-		Designated_dataspace_info *dd_info = mrm_info->dd_infos.first();
-		while(dd_info)
+		// If ar_info is a managed Ram_dataspace_info, attach the designated dataspaces covering the array
+		// directly, thus, the Checkpointer does not trigger page faults which mark accessed regions
+		Managed_region_map_info *mrm_info = ar_info->managed_dataspace(_child.ram().parent_state().ram_dataspaces);
+		if(mrm_info)
 		{
-			if(!dd_info->attached)
+			for(Designated_dataspace_info *dd_info = mrm_info->dd_infos.first(); dd_info; dd_info = dd_info->next())
 			{
-				dd_info->attach();
+				addr_t const dd_child_start = ar_info->rel_addr + dd_info->rel_addr - ar_info->offset;
+				addr_t const dd_child_end   = dd_child_start + dd_info->size;
+				if(dd_child_end <= child_array_start || dd_child_start >= child_array_end) continue;
 
-				Ref_badge *new_info = new (_alloc) Ref_badge(dd_info->cap.local_name());
-				result_infos.insert(new_info);
+				_cap_map.map(ar_info->attached_ds_cap.local_name(), dd_info->cap, 0, dd_info->size, dd_child_start);
 			}
-
-			dd_info = dd_info->next();
 		}
-	}
-
-	return result_infos;
-}
-
-
-void Checkpointer::_detach_unmark_designated_dataspaces(Genode::List<Ref_badge> &badge_infos, Attached_region_info &ar_info)
-{
-	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
-
-	Managed_region_map_info *mrm_info = ar_info.managed_dataspace(_child.ram().parent_state().ram_dataspaces);
-	if(mrm_info && badge_infos.first())
-	{
-		Designated_dataspace_info *dd_info = mrm_info->dd_infos.first();
-		while(dd_info)
+		else
 		{
-			if(badge_infos.first()->find_by_badge(dd_info->cap.local_name()))
-			{
-				dd_info->detach();
-			}
-
-			dd_info = dd_info->next();
+			_cap_map.map(ar_info->attached_ds_cap.local_name(), ar_info->attached_ds_cap,
+					ar_info->offset, ar_info->size, ar_info->rel_addr);
 		}
 	}
 
-	// Delete list elements from badge_infos
-	while(Ref_badge *badge_info = badge_infos.first())
+	_cap_map.layout(layout);
+	size_t const changes = _cap_map.scan();
+
+	if(verbose_debug)
 	{
-		badge_infos.remove(badge_info);
-		Genode::destroy(_alloc, badge_info);
+		log("Capability map: ", Hex(child_array_start), "-", Hex(child_array_end), ", ",
+				_cap_map.num_used(), " used slots, ", changes, " changes");
+		_cap_map.for_each_added([&] (addr_t kcap, Genode::uint16_t badge) {
+			log(" + ", Hex(kcap), ": ", badge); });
+		_cap_map.for_each_removed([&] (addr_t kcap) {
+			log(" - ", Hex(kcap)); });
 	}
 }
 
 
-Genode::addr_t Checkpointer::_find_kcap_by_badge(Genode::uint16_t badge, Genode::List<Badge_kcap_info> &cap_map_infos)
+Genode::addr_t Checkpointer::_find_kcap_by_badge(Genode::uint16_t badge)
 {
 	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
 
-	Genode::addr_t kcap = 0;
-
-	Badge_kcap_info *info = cap_map_infos.first();
-	if(info) info = info->find_by_badge(badge);
-	if(info) kcap = info->kcap;
-
-	return kcap;
+	return _cap_map.kcap_by_badge(badge);
 }
 
 
@@ -228,8 +111,8 @@ void Checkpointer::_prepare_rm_sessions(Genode::List<Stored_rm_session_info> &st
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
-			stored_info = new (_state._alloc) Stored_rm_session_info(*child_info, childs_kcap);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
+			stored_info = new (_state._alloc) Stored_rm_session_info(_state._args_pool, *child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
 
@@ -290,7 +173,7 @@ void Checkpointer::_prepare_region_maps(Genode::List<Stored_region_map_info> &st
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
 			stored_info = new (_state._alloc) Stored_region_map_info(*child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
@@ -300,7 +183,7 @@ void Checkpointer::_prepare_region_maps(Genode::List<Stored_region_map_info> &st
 		_prepare_attached_regions(stored_info->stored_attached_region_infos, child_info->parent_state().attached_regions);
 
 		// Remeber region map's dataspace badge to remove the dataspace from _memory_to_checkpoint later
-		Ref_badge *ref_badge = new (_alloc) Ref_badge(child_info->parent_state().ds_cap.local_name());
+		Ref_badge *ref_badge = new (_arena) Ref_badge(child_info->parent_state().ds_cap.local_name());
 		_region_map_dataspaces.insert(ref_badge);
 
 		child_info = child_info->next();
@@ -420,7 +303,7 @@ Stored_attached_region_info &Checkpointer::_create_stored_attached_region(Attach
 		}
 	}
 
-	Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info.attached_ds_cap.local_name(), _capability_map_infos);
+	Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info.attached_ds_cap.local_name());
 	return *new (_state._alloc) Stored_attached_region_info(child_info, childs_kcap, ramds_cap);
 }
 void Checkpointer::_destroy_stored_attached_region(Stored_attached_region_info &stored_info)
@@ -436,6 +319,7 @@ void Checkpointer::_destroy_stored_attached_region(Stored_attached_region_info &
 		if(known_info->ref_count < 1)
 		{
 			_copy_dataspaces.remove(known_info);
+			_state._env.ram().free(known_info->copy_ds_cap);
 			Genode::destroy(_alloc, known_info);
 		}
 	}
@@ -468,8 +352,8 @@ void Checkpointer::_prepare_ram_sessions(Genode::List<Stored_ram_session_info> &
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
-			stored_info = new (_state._alloc) Stored_ram_session_info(*child_info, childs_kcap);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
+			stored_info = new (_state._alloc) Stored_ram_session_info(_state._args_pool, *child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
 
@@ -587,7 +471,7 @@ Stored_ram_dataspace_info &Checkpointer::_create_stored_ram_dataspace(Ram_datasp
 	}
 
 	// Find childs_kcap
-	Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info.cap.local_name(), _capability_map_infos);
+	Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info.cap.local_name());
 
 	return *new (_state._alloc) Stored_ram_dataspace_info(child_info, childs_kcap, ramds_cap);
 }
@@ -604,6 +488,7 @@ void Checkpointer::_destroy_stored_ram_dataspace(Stored_ram_dataspace_info &stor
 		if(known_info->ref_count < 1)
 		{
 			_copy_dataspaces.remove(known_info);
+			_state._env.ram().free(known_info->copy_ds_cap);
 			Genode::destroy(_alloc, known_info);
 		}
 	}
@@ -636,14 +521,14 @@ void Checkpointer::_prepare_cpu_sessions(Genode::List<Stored_cpu_session_info> &
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
-			stored_info = new (_state._alloc) Stored_cpu_session_info(*child_info, childs_kcap);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
+			stored_info = new (_state._alloc) Stored_cpu_session_info(_state._args_pool, *child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
 
 		// Update stored_info
 		stored_info->sigh_badge = child_info->parent_state().sigh.local_name();
-		_prepare_cpu_threads(stored_info->stored_cpu_thread_infos, child_info->parent_state().cpu_threads);
+		_prepare_cpu_threads(stored_info->stored_cpu_thread_infos, *child_info);
 
 		child_info = child_info->next();
 	}
@@ -682,11 +567,15 @@ void Checkpointer::_destroy_stored_cpu_session(Stored_cpu_session_info &stored_i
 
 
 void Checkpointer::_prepare_cpu_threads(Genode::List<Stored_cpu_thread_info> &stored_infos,
-		Genode::List<Cpu_thread_component> &child_infos)
+		Cpu_session_component &cpu_session)
 {
 	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
 
+	Genode::List<Cpu_thread_component> &child_infos = cpu_session.parent_state().cpu_threads;
 	Cpu_thread_component *child_info = nullptr;
+
+	// Read the register states of all paused threads at once
+	cpu_session.fetch_thread_states();
 	Stored_cpu_thread_info *stored_info = nullptr;
 
 	// Update state_info from child_info
@@ -701,7 +590,7 @@ void Checkpointer::_prepare_cpu_threads(Genode::List<Stored_cpu_thread_info> &st
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
 			stored_info = new (_state._alloc) Stored_cpu_thread_info(*child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
@@ -712,7 +601,7 @@ void Checkpointer::_prepare_cpu_threads(Genode::List<Stored_cpu_thread_info> &st
 		stored_info->single_step = child_info->parent_state().single_step;
 		stored_info->affinity = child_info->parent_state().affinity;
 		stored_info->sigh_badge = child_info->parent_state().sigh.local_name();
-		stored_info->ts = Genode::Cpu_thread_client(child_info->parent_cap()).state();
+		stored_info->ts = cpu_session.thread_state(*child_info);
 
 		child_info = child_info->next();
 	}
@@ -758,7 +647,7 @@ void Checkpointer::_prepare_pd_sessions(Genode::List<Stored_pd_session_info> &st
 	child_info = child_infos.first();
 	while(child_info)
 	{
-		Genode::log(child_info->parent_state());
+		if(verbose_debug) Genode::log(child_info->parent_state());
 		// Find corresponding state_info
 		stored_info = stored_infos.first();
 		if(stored_info) stored_info = stored_info->find_by_badge(child_info->cap().local_name());
@@ -766,11 +655,11 @@ void Checkpointer::_prepare_pd_sessions(Genode::List<Stored_pd_session_info> &st
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_pd_kcap  = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
-			Genode::addr_t childs_add_kcap = _find_kcap_by_badge(child_info->address_space_component().cap().local_name(), _capability_map_infos);
-			Genode::addr_t childs_sta_kcap = _find_kcap_by_badge(child_info->stack_area_component().cap().local_name(), _capability_map_infos);
-			Genode::addr_t childs_lin_kcap = _find_kcap_by_badge(child_info->linker_area_component().cap().local_name(), _capability_map_infos);
-			stored_info = new (_state._alloc) Stored_pd_session_info(*child_info,
+			Genode::addr_t childs_pd_kcap  = _find_kcap_by_badge(child_info->cap().local_name());
+			Genode::addr_t childs_add_kcap = _find_kcap_by_badge(child_info->address_space_component().cap().local_name());
+			Genode::addr_t childs_sta_kcap = _find_kcap_by_badge(child_info->stack_area_component().cap().local_name());
+			Genode::addr_t childs_lin_kcap = _find_kcap_by_badge(child_info->linker_area_component().cap().local_name());
+			stored_info = new (_state._alloc) Stored_pd_session_info(_state._args_pool, *child_info,
 					childs_pd_kcap, childs_add_kcap, childs_sta_kcap, childs_lin_kcap);
 			stored_infos.insert(stored_info);
 		}
@@ -861,7 +750,7 @@ void Checkpointer::_prepare_native_caps(Genode::List<Stored_native_capability_in
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap.local_name(), _capability_map_infos);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap.local_name());
 			stored_info = new (_state._alloc) Stored_native_capability_info(*child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
@@ -919,7 +808,7 @@ void Checkpointer::_prepare_signal_sources(Genode::List<Stored_signal_source_inf
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap.local_name(), _capability_map_infos);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap.local_name());
 			stored_info = new (_state._alloc) Stored_signal_source_info(*child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
@@ -977,7 +866,7 @@ void Checkpointer::_prepare_signal_contexts(Genode::List<Stored_signal_context_i
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap.local_name(), _capability_map_infos);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap.local_name());
 			stored_info = new (_state._alloc) Stored_signal_context_info(*child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
@@ -1035,8 +924,8 @@ void Checkpointer::_prepare_log_sessions(Genode::List<Stored_log_session_info> &
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
-			stored_info = new (_state._alloc) Stored_log_session_info(*child_info, childs_kcap);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
+			stored_info = new (_state._alloc) Stored_log_session_info(_state._args_pool, *child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
 
@@ -1093,8 +982,8 @@ void Checkpointer::_prepare_timer_sessions(Genode::List<Stored_timer_session_inf
 		// No corresponding stored_info => create it
 		if(!stored_info)
 		{
-			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name(), _capability_map_infos);
-			stored_info = new (_state._alloc) Stored_timer_session_info(*child_info, childs_kcap);
+			Genode::addr_t childs_kcap = _find_kcap_by_badge(child_info->cap().local_name());
+			stored_info = new (_state._alloc) Stored_timer_session_info(_state._args_pool, *child_info, childs_kcap);
 			stored_infos.insert(stored_info);
 		}
 
@@ -1147,15 +1036,15 @@ Genode::List<Ref_badge> Checkpointer::_create_region_map_dataspaces(
 		Ref_badge *new_ref = nullptr;
 
 		// Address space
-		new_ref = new (_alloc) Ref_badge(pd_session->address_space_component().parent_state().ds_cap.local_name());
+		new_ref = new (_arena) Ref_badge(pd_session->address_space_component().parent_state().ds_cap.local_name());
 		result_list.insert(new_ref);
 
 		// Stack area
-		new_ref = new (_alloc) Ref_badge(pd_session->stack_area_component().parent_state().ds_cap.local_name());
+		new_ref = new (_arena) Ref_badge(pd_session->stack_area_component().parent_state().ds_cap.local_name());
 		result_list.insert(new_ref);
 
 		// Linker area
-		new_ref = new (_alloc) Ref_badge(pd_session->linker_area_component().parent_state().ds_cap.local_name());
+		new_ref = new (_arena) Ref_badge(pd_session->linker_area_component().parent_state().ds_cap.local_name());
 		result_list.insert(new_ref);
 
 		pd_session = pd_session->next();
@@ -1170,7 +1059,7 @@ Genode::List<Ref_badge> Checkpointer::_create_region_map_dataspaces(
 			Region_map_component *region_map = rm_session->parent_state().region_maps.first();
 			while(region_map)
 			{
-				Ref_badge *new_ref = new (_alloc) Ref_badge(region_map->parent_state().ds_cap.local_name());
+				Ref_badge *new_ref = new (_arena) Ref_badge(region_map->parent_state().ds_cap.local_name());
 				result_list.insert(new_ref);
 
 				region_map = region_map->next();
@@ -1191,7 +1080,7 @@ Genode::List<Orig_copy_ckpt_info> Checkpointer::_create_memory_to_checkpoint(Gen
 	Orig_copy_count_info *occ_info = copy_dataspaces.first();
 	while(occ_info)
 	{
-		Orig_copy_ckpt_info *new_info = new (_alloc) Orig_copy_ckpt_info(occ_info->orig_ds_cap, occ_info->copy_ds_cap,
+		Orig_copy_ckpt_info *new_info = new (_arena) Orig_copy_ckpt_info(occ_info->orig_ds_cap, occ_info->copy_ds_cap,
 				0, occ_info->size);
 		result_list.insert(new_info);
 
@@ -1227,16 +1116,27 @@ void Checkpointer::_resolve_inc_checkpoint_dataspaces(
 					memory_infos.remove(memory_info);
 
 					Designated_dataspace_info *dd_info = ramds_info->mrm_info->dd_infos.first();
-					if(dd_info && dd_info->attached)
+					while(dd_info)
 					{
-						Orig_copy_ckpt_info *new_oc_info = new (_alloc) Orig_copy_ckpt_info(dd_info->cap,
-								memory_info->copy_ds_cap, dd_info->rel_addr, dd_info->size);
-						memory_infos.insert(new_oc_info);
+						Genode::Lock::Guard guard(dd_info->cow_lock);
+
+						if(dd_info->attached)
+						{
+							Orig_copy_ckpt_info *new_oc_info = new (_arena) Orig_copy_ckpt_info(dd_info->cap,
+									memory_info->copy_ds_cap, dd_info->rel_addr, dd_info->size, dd_info);
+							memory_infos.insert(new_oc_info);
+						}
+						// The dataspace was not accessed since a restore on first access;
+						// its content is still in the dataspace it was restored from
+						else if(dd_info->restore_ds_cap.valid())
+						{
+							_checkpoint_restore_content(*dd_info, memory_info->copy_ds_cap, dd_info->rel_addr);
+						}
 
 						dd_info = dd_info->next();
 					}
 
-					Genode::destroy(_alloc, memory_info);
+					Genode::destroy(_arena, memory_info);
 				}
 
 			}
@@ -1262,12 +1162,18 @@ void Checkpointer::_detach_designated_dataspaces(Genode::List<Ram_session_compon
 		{
 			if(ramds_info->mrm_info)
 			{
+				// The attached designated dataspaces were dirty in the epoch ended by this checkpoint
+				unsigned dirty = 0;
 				Designated_dataspace_info *dd_info = ramds_info->mrm_info->dd_infos.first();
-				while(dd_info)
+				for(; dd_info; dd_info = dd_info->next())
 				{
-					if(dd_info->attached) dd_info->detach();
-					dd_info = dd_info->next();
+					if(!dd_info->attached) continue;
+					dd_info->dirty_epochs++;
+					dirty++;
 				}
+				ramds_info->mrm_info->stats.epoch(dirty);
+
+				ramds_info->mrm_info->detach_designated_dataspaces(_state._env.pd().native_pd());
 			}
 			ramds_info = ramds_info->next();
 		}
@@ -1280,10 +1186,11 @@ void Checkpointer::_destroy_memory_to_checkpoint(Genode::List<Orig_copy_ckpt_inf
 {
 	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
 
+	// Call destructors to release the capability references; the memory is released with _arena
 	while(Orig_copy_ckpt_info *info = memory_infos.first())
 	{
 		memory_infos.remove(info);
-		Genode::destroy(_alloc, info);
+		Genode::destroy(_arena, info);
 	}
 }
 
@@ -1292,11 +1199,7 @@ void Checkpointer::_destroy_region_map_dataspaces(Genode::List<Ref_badge> &mands
 {
 	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(...)");
 
-	while(Ref_badge *info = mands_infos.first())
-	{
-		mands_infos.remove(info);
-		Genode::destroy(_alloc, info);
-	}
+	mands_infos = Genode::List<Ref_badge>();
 }
 
 
@@ -1324,6 +1227,7 @@ void Checkpointer::_checkpoint_dataspaces(Genode::List<Orig_copy_ckpt_info> &mem
 			_checkpoint_dataspace_content(memory_info->orig_ds_cap, memory_info->copy_ds_cap,
 					memory_info->copy_rel_addr, memory_info->copy_size);
 			memory_info->checkpointed = true;
+			if(_phase_log) _phase_log->copying(_bytes_copied);
 		}
 
 		memory_info = memory_info->next();
@@ -1331,6 +1235,45 @@ void Checkpointer::_checkpoint_dataspaces(Genode::List<Orig_copy_ckpt_info> &mem
 }
 
 
+void Checkpointer::_checkpoint_dataspaces_within(Genode::List<Orig_copy_ckpt_info> &memory_infos,
+		unsigned long deadline_ms)
+{
+	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(deadline_ms=", deadline_ms, ")");
+
+	Orig_copy_ckpt_info *memory_info = memory_infos.first();
+	for(; memory_info; memory_info = memory_info->next())
+	{
+		if(memory_info->dd_info || memory_info->checkpointed) continue;
+
+		_checkpoint_dataspace_content(memory_info->orig_ds_cap, memory_info->copy_ds_cap,
+				memory_info->copy_rel_addr, memory_info->copy_size);
+		memory_info->checkpointed = true;
+		if(_phase_log) _phase_log->copying(_bytes_copied);
+	}
+
+	for(memory_info = memory_infos.first(); memory_info; memory_info = memory_info->next())
+	{
+		if(!memory_info->dd_info || memory_info->checkpointed) continue;
+
+		if(_timer.elapsed_ms() < deadline_ms)
+		{
+			_checkpoint_dataspace_content(memory_info->orig_ds_cap, memory_info->copy_ds_cap,
+					memory_info->copy_rel_addr, memory_info->copy_size);
+			memory_info->checkpointed = true;
+			if(_phase_log) _phase_log->copying(_bytes_copied);
+			continue;
+		}
+
+		Designated_dataspace_info &dd_info = *memory_info->dd_info;
+
+		Genode::Lock::Guard guard(dd_info.cow_lock);
+		dd_info.cow_ds_cap = memory_info->copy_ds_cap;
+		dd_info.cow_offset = memory_info->copy_rel_addr;
+		_deferred++;
+	}
+}
+
+
 void Checkpointer::_checkpoint_dataspace_content(Genode::Dataspace_capability orig_ds_cap,
 		Genode::Ram_dataspace_capability copy_ds_cap, Genode::addr_t copy_rel_addr, Genode::size_t copy_size)
 {
@@ -1342,6 +1285,28 @@ void Checkpointer::_checkpoint_dataspace_content(Genode::Dataspace_capability or
 	char *copy = _state._env.rm().attach(copy_ds_cap);
 
 	Genode::memcpy(copy + copy_rel_addr, orig, copy_size);
+	_bytes_copied += copy_size;
+
+	_state._env.rm().detach(copy);
+	_state._env.rm().detach(orig);
+}
+
+
+void Checkpointer::_checkpoint_restore_content(Designated_dataspace_info &dd_info,
+		Genode::Ram_dataspace_capability copy_ds_cap, Genode::addr_t copy_rel_addr)
+{
+	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(", dd_info, ", copy ", copy_ds_cap,
+			", copy_rel_addr=", Genode::Hex(copy_rel_addr), ")");
+
+	// The child was restored from the dataspace which is checkpointed to; the content is already there
+	if(dd_info.restore_ds_cap.local_name() == copy_ds_cap.local_name() && dd_info.restore_offset == copy_rel_addr)
+		return;
+
+	char *orig = _state._env.rm().attach(dd_info.restore_ds_cap);
+	char *copy = _state._env.rm().attach(copy_ds_cap);
+
+	Genode::memcpy(copy + copy_rel_addr, orig + dd_info.restore_offset, dd_info.size);
+	_bytes_copied += dd_info.size;
 
 	_state._env.rm().detach(copy);
 	_state._env.rm().detach(orig);
@@ -1350,7 +1315,10 @@ void Checkpointer::_checkpoint_dataspace_content(Genode::Dataspace_capability or
 
 Checkpointer::Checkpointer(Genode::Allocator &alloc, Target_child &child, Target_state &state)
 :
-	_alloc(alloc), _child(child), _state(state)
+	_alloc(alloc), _arena(alloc), _child(child), _state(state), _cap_map(alloc, state._env.rm()),
+	_bytes_copied(0), _timer(state._env), _start_ms(0), _pause_budget_ms(0), _pause_ms(0), _budget_held(true),
+	_deferred(0),
+	_phase_log(nullptr), _delta(nullptr)
 {
 	if(verbose_debug) Genode::log("\033[33m", "Checkpointer", "\033[0m(...)");
 }
@@ -1359,35 +1327,37 @@ Checkpointer::~Checkpointer()
 {
 	if(verbose_debug) Genode::log("\033[33m", "~Checkpointer", "\033[0m");
 
-	_destroy_cap_map_infos(_capability_map_infos);
+	// The copy dataspaces of deferred designated dataspaces are destroyed below
+	finish_deferred();
+
 	_destroy_memory_to_checkpoint(_memory_to_checkpoint);
 	_destroy_region_map_dataspaces(_region_map_dataspaces);
 	_destroy_copy_dataspaces(_copy_dataspaces);
 }
 
 
-void Checkpointer::checkpoint()
+void Checkpointer::checkpoint(unsigned pause_budget_ms)
 {
 	using Genode::log;
-	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m()");
+	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m(pause_budget_ms=", pause_budget_ms, ")");
+
+	// The memory of the previous checkpoint has to be complete before it is overwritten
+	finish_deferred();
+
+	_bytes_copied = 0;
+	if(_delta) _delta->clear();
+
+	_start_ms        = _timer.elapsed_ms();
+	_pause_budget_ms = pause_budget_ms;
+	Phase_log::Timestamp t = Phase_log::now();
 
 	// Pause child
 	_child.pause();
+	t = _phase(Phase_log::Phase_record::PAUSE, t);
 
-	// Create mapping of badge to kcap
-	_capability_map_infos = _create_cap_map_infos();
-
-	if(verbose_debug)
-	{
-		Genode::log("Capability map:");
-		Badge_kcap_info const *info = _capability_map_infos.first();
-		if(!info) Genode::log(" <empty>\n");
-		while(info)
-		{
-			Genode::log(" ", *info);
-			info = info->next();
-		}
-	}
+	// Update mapping of badge to kcap
+	_update_cap_map_infos();
+	t = _phase(Phase_log::Phase_record::CAP_MAP_SCAN, t, _cap_map.num_used());
 
 	// Create a list of region map dataspaces which are known to child
 	// These dataspaces are ignored when creating copy dataspaces
@@ -1396,6 +1366,7 @@ void Checkpointer::checkpoint()
 	Genode::List<Rm_session_component> *rm_sessions = nullptr;
 	if(_child.custom_services().rm_root) rm_sessions = &_child.custom_services().rm_root->session_infos();
 	_region_map_dataspaces = _create_region_map_dataspaces(_child.custom_services().pd_root->session_infos(), rm_sessions);
+	t = _phase(Phase_log::Phase_record::REGION_MAP_DATASPACES, t, Phase_log::count(_region_map_dataspaces));
 
 	if(verbose_debug)
 	{
@@ -1411,14 +1382,26 @@ void Checkpointer::checkpoint()
 	// Prepare state lists
 	// implicitly _copy_dataspaces modified with the child's currently known dataspaces and copy dataspaces
 	_prepare_ram_sessions(_state._stored_ram_sessions, _child.custom_services().ram_root->session_infos());
+	t = _phase(Phase_log::Phase_record::PREPARE_RAM, t, Phase_log::count(_state._stored_ram_sessions));
 	_prepare_pd_sessions(_state._stored_pd_sessions, _child.custom_services().pd_root->session_infos());
+	t = _phase(Phase_log::Phase_record::PREPARE_PD, t, Phase_log::count(_state._stored_pd_sessions));
 	_prepare_cpu_sessions(_state._stored_cpu_sessions, _child.custom_services().cpu_root->session_infos());
+	t = _phase(Phase_log::Phase_record::PREPARE_CPU, t, Phase_log::count(_state._stored_cpu_sessions));
 	if(_child.custom_services().rm_root)
+	{
 		_prepare_rm_sessions(_state._stored_rm_sessions, _child.custom_services().rm_root->session_infos());
+		t = _phase(Phase_log::Phase_record::PREPARE_RM, t, Phase_log::count(_state._stored_rm_sessions));
+	}
 	if(_child.custom_services().log_root)
+	{
 		_prepare_log_sessions(_state._stored_log_sessions, _child.custom_services().log_root->session_infos());
+		t = _phase(Phase_log::Phase_record::PREPARE_LOG, t, Phase_log::count(_state._stored_log_sessions));
+	}
 	if(_child.custom_services().timer_root)
+	{
 		_prepare_timer_sessions(_state._stored_timer_sessions, _child.custom_services().timer_root->session_infos());
+		t = _phase(Phase_log::Phase_record::PREPARE_TIMER, t, Phase_log::count(_state._stored_timer_sessions));
+	}
 
 	if(verbose_debug)
 	{
@@ -1433,9 +1416,12 @@ void Checkpointer::checkpoint()
 
 	// Create list of dataspace capabilities which will be checkpointed in a separate phase
 	_memory_to_checkpoint = _create_memory_to_checkpoint(_copy_dataspaces);
+	t = _phase(Phase_log::Phase_record::MEMORY_LIST, t, Phase_log::count(_memory_to_checkpoint));
 
 	// Resolve managed dataspaces from incremental checkpoint to simple dataspaces in memory_to_checkpoint
 	_resolve_inc_checkpoint_dataspaces(_child.custom_services().ram_root->session_infos(), _memory_to_checkpoint);
+	unsigned const num_memory_infos = Phase_log::count(_memory_to_checkpoint);
+	t = _phase(Phase_log::Phase_record::RESOLVE_INC, t, num_memory_infos);
 
 	if(verbose_debug)
 	{
@@ -1450,18 +1436,91 @@ void Checkpointer::checkpoint()
 
 	// Detach all designated dataspaces
 	_detach_designated_dataspaces(_child.custom_services().ram_root->session_infos());
+	t = _phase(Phase_log::Phase_record::DETACH_DESIGNATED, t);
 
 	// Checkpoint memory in memory_to_checkpoint
-	_checkpoint_dataspaces(_memory_to_checkpoint);
+	if(pause_budget_ms) _checkpoint_dataspaces_within(_memory_to_checkpoint, _start_ms + pause_budget_ms);
+	else                _checkpoint_dataspaces(_memory_to_checkpoint);
+	t = _phase(Phase_log::Phase_record::COPY_MEMORY, t, num_memory_infos - _deferred, _bytes_copied);
 
 	if(verbose_debug) Genode::log(_child);
 	if(verbose_debug) Genode::log(_state);
 
+	// The copied extents are recorded before the list is destroyed; the deferred ones are copied later
+	if(_delta)
+	{
+		Orig_copy_ckpt_info *info = _memory_to_checkpoint.first();
+		for(; info; info = info->next())
+			_delta->add(info->copy_ds_cap.local_name(), info->copy_rel_addr, info->copy_size);
+	}
+
 	// Destroy list elements
-	_destroy_cap_map_infos(_capability_map_infos);
 	_destroy_memory_to_checkpoint(_memory_to_checkpoint);
 	_destroy_region_map_dataspaces(_region_map_dataspaces);
+	_arena.reset();
+
+	resumed();
 
 	// Resume child
 	//_child.resume();
 }
+
+
+void Checkpointer::resumed()
+{
+	_pause_ms    = _timer.elapsed_ms() - _start_ms;
+	_budget_held = !_pause_budget_ms || _pause_ms <= _pause_budget_ms;
+}
+
+
+Genode::size_t Checkpointer::checkpointed_bytes() const
+{
+	Genode::size_t result = 0;
+	for(Orig_copy_count_info const *info = _copy_dataspaces.first(); info; info = info->next())
+		result += info->size;
+	return result;
+}
+
+
+unsigned Checkpointer::checkpointed_dataspaces() const
+{
+	unsigned result = 0;
+	for(Orig_copy_count_info const *info = _copy_dataspaces.first(); info; info = info->next())
+		result++;
+	return result;
+}
+
+
+void Checkpointer::finish_deferred()
+{
+	if(!_deferred) return;
+
+	if(verbose_debug) Genode::log("Ckpt::\033[33m", __func__, "\033[0m() deferred=", _deferred);
+
+	Ram_session_component *ram_session = _child.custom_services().ram_root->session_infos().first();
+	for(; ram_session; ram_session = ram_session->next())
+	{
+		// The child runs; it must not destroy a Designated_dataspace_info while it is copied
+		Genode::Lock::Guard ramds_guard(ram_session->parent_state().ram_dataspaces_lock);
+
+		Ram_dataspace_info *ramds_info = ram_session->parent_state().ram_dataspaces.first();
+		for(; ramds_info; ramds_info = ramds_info->next())
+		{
+			if(!ramds_info->mrm_info) continue;
+
+			Designated_dataspace_info *dd_info = ramds_info->mrm_info->dd_infos.first();
+			for(; dd_info; dd_info = dd_info->next())
+			{
+				Genode::Lock::Guard guard(dd_info->cow_lock);
+
+				// Invalid, if the fault handler saved the content on the first access
+				if(!dd_info->cow_ds_cap.valid()) continue;
+
+				_checkpoint_dataspace_content(dd_info->cap, dd_info->cow_ds_cap, dd_info->cow_offset, dd_info->size);
+				dd_info->cow_ds_cap = Genode::Ram_dataspace_capability();
+			}
+		}
+	}
+
+	_deferred = 0;
+}
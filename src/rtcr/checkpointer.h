@@ -11,19 +11,25 @@
 #include <util/list.h>
 #include <region_map/client.h>
 #include <foc_native_pd/client.h>
+#include <timer_session/connection.h>
 
 /* Rtcr includes */
 #include "target_state.h"
 #include "target_child.h"
 #include "util/ref_badge.h"
-#include "util/badge_kcap_info.h"
+#include "util/cap_map_scanner.h"
+#include "util/cap_map_layout.h"
 #include "util/orig_copy_ckpt_info.h"
 #include "util/orig_copy_count_info.h"
+#include "util/arena.h"
+#include "util/phase_log.h"
+#include "util/event_trace.h"
+#include "util/checkpoint_delta.h"
 
 namespace Rtcr {
 	class Checkpointer;
 
-	constexpr bool checkpointer_verbose_debug = true;
+	constexpr bool checkpointer_verbose_debug = false;
 }
 
 
@@ -40,6 +46,10 @@ private:
 	 * are created with the allocator of Target_state
 	 */
 	Genode::Allocator &_alloc;
+	/**
+	 * Allocator for the temporary lists of a single checkpoint. It is reset at the end of checkpoint()
+	 */
+	Arena              _arena;
 	/**
 	 * Target_child which shall be checkpointed
 	 */
@@ -49,9 +59,10 @@ private:
 	 */
 	Target_state      &_state;
 	/**
-	 * Capability map of Target_child in a condensed form
+	 * Capability map of Target_child in a condensed form; it is updated incrementally
+	 * and persists across checkpoints
 	 */
-	Genode::List<Badge_kcap_info>      _capability_map_infos;
+	Cap_map_scanner                    _cap_map;
 	/**
 	 * Mapping to find a copy dataspace for a given original dataspace badge
 	 */
@@ -65,31 +76,67 @@ private:
 	 * These dataspaces are not needed to be copied
 	 */
 	Genode::List<Ref_badge>            _region_map_dataspaces;
-
+	/**
+	 * Bytes of memory copied by the last checkpoint
+	 */
+	Genode::size_t                     _bytes_copied;
+	/**
+	 * Measures the pause of the child for budgeted checkpoints
+	 */
+	Timer::Connection                  _timer;
+	/**
+	 * Start and pause budget of the last checkpoint
+	 */
+	unsigned long                      _start_ms;
+	unsigned                           _pause_budget_ms;
+	/**
+	 * Pause of the child by the last checkpoint
+	 */
+	unsigned long                      _pause_ms;
+	/**
+	 * Whether the last checkpoint kept its pause budget
+	 */
+	bool                               _budget_held;
+	/**
+	 * Number of designated dataspaces left to finish_deferred() by the last checkpoint
+	 */
+	unsigned                           _deferred;
+	/**
+	 * Ring recording the phases of each checkpoint; may be null
+	 */
+	Phase_log                         *_phase_log;
+	/**
+	 * Extents of the stored memory copied by the last checkpoint; may be null
+	 */
+	Checkpoint_delta                  *_delta;
 
 	/**
-	 * \brief Prepares the capability map state_infos
+	 * Record the phase which started at start, if a Phase_log is set
 	 *
-	 * First the method fetches the capability map information from child's cap map structure in an
-	 * intercepted dataspace.
+	 * \return the end of the phase
+	 */
+	Phase_log::Timestamp _phase(Phase_log::Phase_record::Phase phase, Phase_log::Timestamp start,
+			unsigned objects = 0, Genode::uint64_t bytes = 0)
+	{
+		Event_trace::record(Event_trace::PHASE, Event_trace::PHASE_END, phase, objects);
+		return _phase_log ? _phase_log->phase(phase, start, objects, bytes) : Phase_log::now();
+	}
+
+
+	/**
+	 * \brief Updates the capability map of the child
 	 *
-	 * Second it prepares the capability map state_infos.
-	 * For each badge-kcap tuple found in child's cap map the method checks whether a corresponding
-	 * list element in state_infos exists. If there is no list element, then it is created and marked.
-	 * Else it is just marked. After this, the old badge-kcap tuples, which where not marked, are deleted
-	 * from state_infos. Now an updated capability map is ready to used for the next steps to store the
-	 * kcap for each RPC object.
-	 */
-	Genode::List<Badge_kcap_info> _create_cap_map_infos();
-	void _destroy_cap_map_infos(Genode::List<Badge_kcap_info> &cap_map_infos);
-	Genode::List<Ref_badge> _mark_attach_designated_dataspaces(Attached_region_info &ar_info);
-	void _detach_unmark_designated_dataspaces(Genode::List<Ref_badge> &badge_infos, Attached_region_info &ar_info);
-	/**
-	 * \brief Return the kcap for a given badge from _capability_map_infos
+	 * The method fetches the capability map information from child's cap map structure in an
+	 * intercepted dataspace. The memory containing the cap map is attached once and stays attached.
+	 * Only the slots which changed since the last checkpoint are inspected and updated in _cap_map.
+	 */
+	void _update_cap_map_infos();
+	/**
+	 * \brief Return the kcap for a given badge from _cap_map
 	 *
 	 * Return the kcap for a given badge. If there is no, return 0.
 	 */
-	Genode::addr_t _find_kcap_by_badge(Genode::uint16_t badge, Genode::List<Badge_kcap_info> &cap_map_infos);
+	Genode::addr_t _find_kcap_by_badge(Genode::uint16_t badge);
 
 	void _prepare_rm_sessions(Genode::List<Stored_rm_session_info> &stored_infos, Genode::List<Rm_session_component> &child_infos);
 	void _destroy_stored_rm_session(Stored_rm_session_info &stored_info);
@@ -111,7 +158,7 @@ private:
 	void _prepare_cpu_sessions(Genode::List<Stored_cpu_session_info> &stored_infos, Genode::List<Cpu_session_component> &child_infos);
 	void _destroy_stored_cpu_session(Stored_cpu_session_info &stored_info);
 
-	void _prepare_cpu_threads(Genode::List<Stored_cpu_thread_info> &stored_infos, Genode::List<Cpu_thread_component> &child_infos);
+	void _prepare_cpu_threads(Genode::List<Stored_cpu_thread_info> &stored_infos, Cpu_session_component &cpu_session);
 	void _destroy_stored_cpu_thread(Stored_cpu_thread_info &stored_info);
 
 	void _prepare_pd_sessions(Genode::List<Stored_pd_session_info> &stored_infos, Genode::List<Pd_session_component> &child_infos);
@@ -143,8 +190,22 @@ private:
 	void _destroy_copy_dataspaces(Genode::List<Orig_copy_count_info> known_infos);
 
 	void _checkpoint_dataspaces(Genode::List<Orig_copy_ckpt_info> &memory_infos);
+	/**
+	 * \brief Copy memory until deadline_ms, and defer the remaining designated dataspaces
+	 *
+	 * Dataspaces which are not managed cannot be protected from the child; they are copied
+	 * regardless of the deadline. The deferred designated dataspaces are already detached and
+	 * are saved on their first access by the fault handler or by finish_deferred().
+	 */
+	void _checkpoint_dataspaces_within(Genode::List<Orig_copy_ckpt_info> &memory_infos, unsigned long deadline_ms);
 	void _checkpoint_dataspace_content(Genode::Dataspace_capability orig_ds_cap, Genode::Ram_dataspace_capability copy_ds_cap,
 			Genode::addr_t copy_addr, Genode::size_t copy_size);
+	/**
+	 * Copy the content of a designated dataspace, which is not restored yet, from the dataspace
+	 * it is restored from; dd_info.cow_lock has to be held
+	 */
+	void _checkpoint_restore_content(Designated_dataspace_info &dd_info, Genode::Ram_dataspace_capability copy_ds_cap,
+			Genode::addr_t copy_rel_addr);
 
 public:
 	Checkpointer(Genode::Allocator &alloc, Target_child &child, Target_state &state);
@@ -152,8 +213,49 @@ public:
 
 	/**
 	 * Checkpoint all (known) RPC objects and capabilities from _child to _state
+	 *
+	 * \param pause_budget_ms  If not zero, memory is only copied until the child was paused for
+	 *                         pause_budget_ms; the remaining memory is copied by finish_deferred()
+	 *                         after the child is resumed
+	 */
+	void checkpoint(unsigned pause_budget_ms = 0);
+	/**
+	 * Account the pause of the last checkpoint until now; called after the caller resumed the child
+	 *
+	 * Without this call, the pause ends with checkpoint().
+	 */
+	void resumed();
+	/**
+	 * Copy the memory deferred by the last checkpoint; the child may run meanwhile
+	 *
+	 * The RAM dataspaces of the child are walked under the lock of their RAM session, thus,
+	 * the child can not free a dataspace which is being copied.
+	 */
+	void finish_deferred();
+
+	/**
+	 * Record the phases of the checkpoints to log; the operations are begun and ended by the caller
+	 */
+	void phase_log(Phase_log *log) { _phase_log = log; }
+	/**
+	 * Record the stored memory copied by each checkpoint to delta; it is cleared by the next checkpoint
+	 *
+	 * The extents deferred by a pause budget are complete after finish_deferred().
+	 */
+	void delta(Checkpoint_delta *delta) { _delta = delta; }
+
+	Genode::size_t bytes_copied() const { return _bytes_copied; }
+	unsigned long pause_ms() const { return _pause_ms; }
+	/**
+	 * Size and number of the copy dataspaces holding the memory of the child
+	 */
+	Genode::size_t checkpointed_bytes() const;
+	unsigned checkpointed_dataspaces() const;
+	/**
+	 * Number of capabilities of the child at the last checkpoint
 	 */
-	void checkpoint();
+	Genode::size_t capabilities() const { return _cap_map.num_used(); }
+	bool budget_held() const { return _budget_held; }
 };
 
 #endif /* _RTCR_CHECKPOINTER_H_ */
@@ -0,0 +1,106 @@
+/*
+ * \brief  Periodic report of the fault and dirty statistics of the targets
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#include "fault_telemetry.h"
+
+using namespace Rtcr;
+
+
+void Fault_telemetry::_report_dataspace(Genode::Xml_generator &xml, Ram_dataspace_info &ramds)
+{
+	Managed_region_map_info const &mrm_info = *ramds.mrm_info;
+	Fault_statistics        const &stats    = mrm_info.stats;
+
+	unsigned units = 0;
+	for(Designated_dataspace_info const *dd = mrm_info.dd_infos.first(); dd; dd = dd->next()) units++;
+
+	// Rewrite frequency of the units of each bin; the units are listed in descending order of their addresses
+	enum { BINS = HEATMAP_BINS };
+	unsigned const bins = Genode::min(units, (unsigned)BINS);
+	unsigned long dirty_epochs[BINS] = { };
+	unsigned      bin_units[BINS]    = { };
+	unsigned i = 0;
+	for(Designated_dataspace_info const *dd = mrm_info.dd_infos.first(); dd; dd = dd->next(), i++)
+	{
+		unsigned const bin = (units - 1 - i) * bins / units;
+		dirty_epochs[bin] += dd->dirty_epochs;
+		bin_units[bin]++;
+	}
+
+	char heatmap[BINS + 1];
+	for(unsigned bin = 0; bin < bins; bin++)
+	{
+		unsigned long const possible = bin_units[bin] * stats.epochs;
+		unsigned const level = possible ? dirty_epochs[bin] * 15 / possible : 0;
+		heatmap[bin] = "0123456789abcdef"[level];
+	}
+	heatmap[bins] = 0;
+
+	// Latency histogram up to its last used bucket
+	char latency[Fault_statistics::LATENCY_BUCKETS * 22];
+	unsigned last = 0;
+	for(unsigned bucket = 0; bucket < Fault_statistics::LATENCY_BUCKETS; bucket++)
+		if(stats.latency[bucket]) last = bucket + 1;
+	Genode::size_t pos = 0;
+	latency[0] = 0;
+	for(unsigned bucket = 0; bucket < last; bucket++)
+		pos += Genode::snprintf(latency + pos, sizeof(latency) - pos, bucket ? ",%lu" : "%lu", stats.latency[bucket]);
+
+	xml.node("dataspace", [&] () {
+		xml.attribute("size",         (unsigned long)ramds.size);
+		xml.attribute("units",        units);
+		xml.attribute("read_faults",  stats.read_faults);
+		xml.attribute("write_faults", stats.write_faults);
+		xml.attribute("exec_faults",  stats.exec_faults);
+		xml.attribute("epochs",       stats.epochs);
+		xml.attribute("dirty_last",   stats.dirty_last);
+		xml.attribute("dirty_max",    stats.dirty_max);
+		xml.attribute("dirty_sum",    stats.dirty_sum);
+		xml.attribute("heatmap",      heatmap);
+		xml.attribute("latency",      latency);
+	});
+}
+
+
+void Fault_telemetry::_handle_period()
+{
+	try
+	{
+		Genode::Xml_generator xml(_report_ds.local_addr<char>(), REPORT_SIZE, "rtcr_faults", [&] () {
+			xml.attribute("ticks_per_us", (unsigned long)_ticks_per_us);
+
+			// A target during a checkpoint or restore is reported by a later period
+			_registry.try_for_each([&] (Target_registry::Target &target) {
+				xml.node("target", [&] () {
+					xml.attribute("name", target.name().string());
+					xml.attribute("granularity", (unsigned long)target.granularity());
+
+					unsigned reported = 0;
+					target.for_each_managed_dataspace([&] (Ram_dataspace_info &ramds) {
+						if(reported++ < MAX_DATASPACES) _report_dataspace(xml, ramds); });
+				});
+			});
+		});
+
+		_report.submit(xml.used());
+	}
+	catch(Genode::Xml_generator::Buffer_exceeded)
+	{
+		Genode::warning("Fault telemetry exceeds the report buffer of ", (unsigned)REPORT_SIZE, " bytes");
+	}
+}
+
+
+Fault_telemetry::Fault_telemetry(Genode::Env &env, Target_registry &registry, Genode::uint64_t ticks_per_us,
+		unsigned period_ms)
+:
+	_registry(registry), _ticks_per_us(ticks_per_us), _timer(env),
+	_period_handler(env.ep(), *this, &Fault_telemetry::_handle_period),
+	_report(env, "rtcr_faults", REPORT_SIZE), _report_ds(env.rm(), _report.dataspace())
+{
+	_timer.sigh(_period_handler);
+	_timer.trigger_periodic(period_ms*1000);
+}
@@ -0,0 +1,75 @@
+/*
+ * \brief  Periodic report of the fault and dirty statistics of the targets
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The report shows the working set and the fault costs of each target, which
+ * are needed to choose its granularity. For each managed dataspace, it
+ * contains the faults by type, the histogram of the fault handling latency,
+ * the dirty designated dataspaces (units) per checkpoint (epoch), and a
+ * heatmap of the rewrite frequency: the units are grouped into at most
+ * HEATMAP_BINS bins by address, and each bin is shown as a hex digit of the
+ * fraction of epochs in which its units were dirty. The report is bounded by
+ * MAX_DATASPACES per target and the size of the report buffer, e.g.
+ *
+ * <rtcr_faults ticks_per_us="3400">
+ *   <target name="sheep_counter" granularity="1">
+ *     <dataspace size="0x4000" units="4" read_faults="1" write_faults="12" exec_faults="0"
+ *                epochs="8" dirty_last="2" dirty_max="4" dirty_sum="13" heatmap="f81a"
+ *                latency="0,0,0,0,0,0,0,0,0,0,0,0,3,8,2"/>
+ *   </target>
+ * </rtcr_faults>
+ *
+ * It is enabled by <telemetry period_ms="1000"/> in the config.
+ */
+
+#ifndef _RTCR_FAULT_TELEMETRY_H_
+#define _RTCR_FAULT_TELEMETRY_H_
+
+/* Genode includes */
+#include <base/signal.h>
+#include <os/attached_dataspace.h>
+#include <report_session/connection.h>
+#include <timer_session/connection.h>
+#include <util/xml_generator.h>
+
+/* Rtcr includes */
+#include "target_registry.h"
+
+namespace Rtcr {
+	class Fault_telemetry;
+}
+
+
+class Rtcr::Fault_telemetry
+{
+private:
+	enum { REPORT_SIZE = 16*1024, MAX_DATASPACES = 32, HEATMAP_BINS = 64 };
+
+	Target_registry                        &_registry;
+	Genode::uint64_t                 const  _ticks_per_us;
+	Timer::Connection                       _timer;
+	Genode::Signal_handler<Fault_telemetry> _period_handler;
+	Report::Connection                      _report;
+	Genode::Attached_dataspace              _report_ds;
+
+	/*
+	 * Noncopyable
+	 */
+	Fault_telemetry(Fault_telemetry const &);
+	Fault_telemetry &operator = (Fault_telemetry const &);
+
+	void _report_dataspace(Genode::Xml_generator &xml, Ram_dataspace_info &ramds);
+	void _handle_period();
+
+public:
+	/**
+	 * Constructor
+	 *
+	 * \param ticks_per_us Ticks of Genode::Trace::timestamp() per microsecond; it scales the latency histogram
+	 */
+	Fault_telemetry(Genode::Env &env, Target_registry &registry, Genode::uint64_t ticks_per_us,
+			unsigned period_ms);
+};
+
+#endif /* _RTCR_FAULT_TELEMETRY_H_ */
@@ -59,7 +59,10 @@ Cpu_session_component::Cpu_session_component(Genode::Env &env, Genode::Allocator
 	_bootstrap_phase (bootstrap_phase),
 	_pd_root         (pd_root),
 	_parent_cpu      (env, label),
-	_parent_state    (creation_args, bootstrap_phase)
+	_parent_state    (creation_args, bootstrap_phase),
+	_thread_states   (env.ram(), env.rm(), THREAD_STATES_SIZE),
+	_thread_states_cursor (0),
+	_thread_states_staged (false)
 
 {
 	if(verbose_debug) Genode::log("\033[33m", "Cpu", "\033[0m(parent ", _parent_cpu,")");
@@ -89,11 +92,17 @@ Cpu_session_component *Cpu_session_component::find_by_badge(Genode::uint16_t bad
 
 void Cpu_session_component::pause_threads()
 {
-	Cpu_thread_component *cpu_thread = _parent_state.cpu_threads.first();
+	if(verbose_debug) Genode::log("Cpu::\033[33m", __func__, "\033[0m()");
+
+	Genode::Lock::Guard lock_guard(_parent_state.cpu_threads_lock);
+
+	// Stop all threads in one core operation
+	Genode::Foc_native_cpu_client(_parent_cpu.native_cpu()).pause_all();
 
+	Cpu_thread_component *cpu_thread = _parent_state.cpu_threads.first();
 	while(cpu_thread)
 	{
-		Genode::Cpu_thread_client(cpu_thread->cap()).pause();
+		cpu_thread->parent_state().paused = true;
 
 		cpu_thread = cpu_thread->next();
 	}
@@ -102,17 +111,115 @@ void Cpu_session_component::pause_threads()
 
 void Cpu_session_component::resume_threads()
 {
-	Cpu_thread_component *cpu_thread = _parent_state.cpu_threads.first();
+	if(verbose_debug) Genode::log("Cpu::\033[33m", __func__, "\033[0m()");
 
+	Genode::Lock::Guard lock_guard(_parent_state.cpu_threads_lock);
+
+	Genode::Foc_native_cpu_client(_parent_cpu.native_cpu()).resume_all();
+
+	Cpu_thread_component *cpu_thread = _parent_state.cpu_threads.first();
 	while(cpu_thread)
 	{
-		Genode::Cpu_thread_client(cpu_thread->cap()).resume();
+		cpu_thread->parent_state().paused = false;
 
 		cpu_thread = cpu_thread->next();
 	}
 }
 
 
+Cpu_session_component::Thread_state_buffer::Entry *Cpu_session_component::_find_thread_state(Cpu_thread_component &cpu_thread)
+{
+	Thread_state_buffer &buffer = *_thread_states.local_addr<Thread_state_buffer>();
+	unsigned long const badge = cpu_thread.parent_cap().local_name();
+
+	// Core and this session list the threads in the same order; start the search after the last match
+	for(unsigned i = 0; i < buffer.count; i++)
+	{
+		unsigned const index = (_thread_states_cursor + i) % buffer.count;
+		if(buffer.entries()[index].badge == badge)
+		{
+			_thread_states_cursor = index + 1;
+			return &buffer.entries()[index];
+		}
+	}
+
+	return nullptr;
+}
+
+
+void Cpu_session_component::fetch_thread_states()
+{
+	if(verbose_debug) Genode::log("Cpu::\033[33m", __func__, "\033[0m()");
+
+	Thread_state_buffer &buffer = *_thread_states.local_addr<Thread_state_buffer>();
+	buffer.count = 0;
+	_thread_states_cursor = 0;
+	_thread_states_staged = false;
+
+	Genode::Foc_native_cpu_client(_parent_cpu.native_cpu()).get_states(_thread_states.cap());
+}
+
+
+Genode::Thread_state Cpu_session_component::thread_state(Cpu_thread_component &cpu_thread)
+{
+	Thread_state_buffer::Entry *entry = _thread_states_staged ? nullptr : _find_thread_state(cpu_thread);
+	if(entry && entry->valid) return entry->state;
+
+	return Genode::Cpu_thread_client(cpu_thread.parent_cap()).state();
+}
+
+
+void Cpu_session_component::stage_thread_state(Cpu_thread_component &cpu_thread, Genode::Thread_state const &state)
+{
+	Thread_state_buffer &buffer = *_thread_states.local_addr<Thread_state_buffer>();
+
+	// Start a new batch; the buffer may contain fetched states
+	if(!_thread_states_staged)
+	{
+		buffer.count = 0;
+		_thread_states_staged = true;
+	}
+
+	if(buffer.count == Thread_state_buffer::max_entries(THREAD_STATES_SIZE))
+	{
+		// No space left in the buffer
+		Genode::Cpu_thread_client(cpu_thread.parent_cap()).state(state);
+		return;
+	}
+
+	Thread_state_buffer::Entry &entry = buffer.entries()[buffer.count++];
+	entry.badge = cpu_thread.parent_cap().local_name();
+	entry.valid = true;
+	entry.state = state;
+}
+
+
+void Cpu_session_component::commit_thread_states()
+{
+	if(verbose_debug) Genode::log("Cpu::\033[33m", __func__, "\033[0m()");
+
+	Thread_state_buffer &buffer = *_thread_states.local_addr<Thread_state_buffer>();
+
+	Genode::Foc_native_cpu_client(_parent_cpu.native_cpu()).set_states(_thread_states.cap());
+
+	// Write states one by one, which core could not write
+	for(unsigned i = 0; i < buffer.count; i++)
+	{
+		Thread_state_buffer::Entry &entry = buffer.entries()[i];
+		if(entry.valid) continue;
+
+		Cpu_thread_component *cpu_thread = _parent_state.cpu_threads.first();
+		while(cpu_thread && (unsigned long)cpu_thread->parent_cap().local_name() != entry.badge)
+			cpu_thread = cpu_thread->next();
+
+		if(cpu_thread) Genode::Cpu_thread_client(cpu_thread->parent_cap()).state(entry.state);
+	}
+
+	buffer.count = 0;
+	_thread_states_staged = false;
+}
+
+
 Genode::Thread_capability Cpu_session_component::create_thread(Genode::Pd_session_capability child_pd_cap,
 		Name const &name, Genode::Affinity::Location affinity, Weight weight, Genode::addr_t utcb)
 {
@@ -129,6 +236,7 @@ Genode::Thread_capability Cpu_session_component::create_thread(Genode::Pd_sessio
 
 	// Create custom CPU thread
 	Cpu_thread_component &new_cpu_thread = _create_thread(child_pd_cap, pd_session->parent_cap(), name, affinity, weight, utcb);
+	Event_trace::record(Event_trace::RPC, Event_trace::CPU_CREATE_THREAD, new_cpu_thread.cap().local_name(), utcb);
 
 	if(verbose_debug) Genode::log("  Created custom CPU thread ", new_cpu_thread.cap());
 	return new_cpu_thread.cap();
@@ -138,6 +246,7 @@ Genode::Thread_capability Cpu_session_component::create_thread(Genode::Pd_sessio
 void Cpu_session_component::kill_thread(Genode::Thread_capability thread_cap)
 {
 	if(verbose_debug) Genode::log("Cpu::\033[33m", __func__, "\033[0m(", thread_cap,")");
+	Event_trace::record(Event_trace::RPC, Event_trace::CPU_KILL_THREAD, thread_cap.local_name());
 
 	// Find CPU thread for the given capability
 	Genode::Lock::Guard lock (_parent_state.cpu_threads_lock);
@@ -13,6 +13,8 @@
 #include <base/rpc_server.h>
 #include <cpu_session/connection.h>
 #include <cpu_thread/client.h>
+#include <foc_native_cpu/client.h>
+#include <base/attached_ram_dataspace.h>
 
 /* Rtcr includes */
 #include "../online_storage/cpu_session_info.h"
@@ -70,6 +72,22 @@ private:
 	 * State of parent's RPC object
 	 */
 	Cpu_session_info       _parent_state;
+	/**
+	 * Buffer shared with core for reading and writing the states of all threads at once
+	 */
+	enum { THREAD_STATES_SIZE = 4*4096 };
+	typedef Genode::Foc_native_cpu::Thread_state_buffer Thread_state_buffer;
+	Genode::Attached_ram_dataspace _thread_states;
+	/**
+	 * Index of the last entry found in _thread_states
+	 */
+	unsigned               _thread_states_cursor;
+	/**
+	 * Indicates whether _thread_states contains states to be written by commit_thread_states()
+	 */
+	bool                   _thread_states_staged;
+
+	Thread_state_buffer::Entry *_find_thread_state(Cpu_thread_component &cpu_thread);
 
 	Cpu_thread_component &_create_thread(Genode::Pd_session_capability child_pd_cap, Genode::Pd_session_capability parent_pd_cap,
 			Name const &name, Genode::Affinity::Location affinity, Weight weight, Genode::addr_t utcb);
@@ -88,15 +106,41 @@ public:
 	Cpu_session_component *find_by_badge(Genode::uint16_t badge);
 
 	/**
-	 * Pause all threads
+	 * Pause all threads with a single call to core
 	 */
 	void pause_threads();
 
 	/**
-	 * Resume all threads
+	 * Resume all threads with a single call to core
 	 */
 	void resume_threads();
 
+	/**
+	 * Read the states of all paused threads with a single call to core
+	 *
+	 * The states are obtained by thread_state().
+	 */
+	void fetch_thread_states();
+
+	/**
+	 * Return the state of cpu_thread read by fetch_thread_states()
+	 *
+	 * If core could not provide the state, it is read from the thread itself.
+	 */
+	Genode::Thread_state thread_state(Cpu_thread_component &cpu_thread);
+
+	/**
+	 * Prepare writing state to cpu_thread by commit_thread_states()
+	 */
+	void stage_thread_state(Cpu_thread_component &cpu_thread, Genode::Thread_state const &state);
+
+	/**
+	 * Write all staged states with a single call to core
+	 *
+	 * States which core could not write are written to the threads one by one.
+	 */
+	void commit_thread_states();
+
 	/***************************
 	 ** Cpu_session interface **
 	 ***************************/
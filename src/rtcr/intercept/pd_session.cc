@@ -118,6 +118,7 @@ Genode::Signal_context_capability Pd_session_component::alloc_context(Signal_sou
 	if(verbose_debug) Genode::log("Pd::\033[33m", __func__, "\033[0m(source ", source, ", imprint=", Genode::Hex(imprint), ")");
 
 	auto result_cap = _parent_pd.alloc_context(source, imprint);
+	Event_trace::record(Event_trace::RPC, Event_trace::PD_ALLOC_CONTEXT, result_cap.local_name(), imprint);
 
 	// Create and insert list element to monitor this signal context
 	Signal_context_info *new_sc_info = new (_md_alloc) Signal_context_info(result_cap, source, imprint, _bootstrap_phase);
@@ -133,6 +134,7 @@ Genode::Signal_context_capability Pd_session_component::alloc_context(Signal_sou
 void Pd_session_component::free_context(Genode::Signal_context_capability cap)
 {
 	if(verbose_debug) Genode::log("Pd::\033[33m", __func__, "\033[0m(", cap, ")");
+	Event_trace::record(Event_trace::RPC, Event_trace::PD_FREE_CONTEXT, cap.local_name());
 
 	// Find list element
 	Genode::Lock::Guard guard(_parent_state.signal_contexts_lock);
@@ -159,6 +161,7 @@ void Pd_session_component::free_context(Genode::Signal_context_capability cap)
 void Pd_session_component::submit(Genode::Signal_context_capability context, unsigned cnt)
 {
 	if(verbose_debug) Genode::log("Pd::\033[33m", __func__, "\033[0m(context ", context, ", cnt=", cnt,")");
+	Event_trace::record(Event_trace::RPC, Event_trace::PD_SUBMIT, context.local_name(), cnt);
 
 	_parent_pd.submit(context, cnt);
 }
@@ -169,6 +172,7 @@ Genode::Native_capability Pd_session_component::alloc_rpc_cap(Genode::Native_cap
 	if(verbose_debug) Genode::log("Pd::\033[33m", "alloc_rpc_cap", "\033[0m(", ep, ")");
 
 	auto result_cap = _parent_pd.alloc_rpc_cap(ep);
+	Event_trace::record(Event_trace::RPC, Event_trace::PD_ALLOC_RPC_CAP, result_cap.local_name(), ep.local_name());
 
 	// Create and insert list element to monitor this native_capability
 	Native_capability_info *new_nc_info = new (_md_alloc) Native_capability_info(result_cap, ep, _bootstrap_phase);
@@ -184,6 +188,7 @@ Genode::Native_capability Pd_session_component::alloc_rpc_cap(Genode::Native_cap
 void Pd_session_component::free_rpc_cap(Genode::Native_capability cap)
 {
 	if(verbose_debug) Genode::log("Pd::\033[33m", __func__, "\033[0m(", cap,")");
+	Event_trace::record(Event_trace::RPC, Event_trace::PD_FREE_RPC_CAP, cap.local_name());
 
 	// Find list element
 	Genode::Lock::Guard guard(_parent_state.native_caps_lock);
@@ -18,7 +18,10 @@ Managed_region_map_info *Fault_handler::_find_faulting_mrm_info()
 	while(ramds_info && !result_info)
 	{
 		if(!ramds_info->mrm_info)
+		{
+			ramds_info = ramds_info->next();
 			continue;
+		}
 
 		Genode::Region_map_client rm_client(ramds_info->mrm_info->region_map_cap);
 
@@ -35,11 +38,50 @@ Managed_region_map_info *Fault_handler::_find_faulting_mrm_info()
 }
 
 
+void Fault_handler::_restore_content(Designated_dataspace_info &dd_info)
+{
+	if(verbose_debug) Genode::log("Restoring content of ", dd_info, " from ", dd_info.restore_ds_cap,
+			" at offset ", Genode::Hex(dd_info.restore_offset));
+
+	char *dst = _env.rm().attach(dd_info.cap);
+	char *src = _env.rm().attach(dd_info.restore_ds_cap);
+
+	Genode::memcpy(dst, src + dd_info.restore_offset, dd_info.size);
+
+	_env.rm().detach(src);
+	_env.rm().detach(dst);
+
+	dd_info.restore_ds_cap = Genode::Dataspace_capability();
+}
+
+
+void Fault_handler::_save_content(Designated_dataspace_info &dd_info)
+{
+	if(verbose_debug) Genode::log("Saving content of ", dd_info, " to ", dd_info.cow_ds_cap,
+			" at offset ", Genode::Hex(dd_info.cow_offset));
+
+	char *src = _env.rm().attach(dd_info.cap);
+	char *dst = _env.rm().attach(dd_info.cow_ds_cap);
+
+	Genode::memcpy(dst + dd_info.cow_offset, src, dd_info.size);
+
+	_env.rm().detach(dst);
+	_env.rm().detach(src);
+
+	dd_info.cow_ds_cap = Genode::Ram_dataspace_capability();
+}
+
+
 void Fault_handler::_handle_fault()
 {
+	Genode::Trace::Timestamp const start = Genode::Trace::timestamp();
+
 	// Find faulting Managed_region_info
 	Managed_region_map_info *faulting_mrm_info = _find_faulting_mrm_info();
 
+	// A coalesced signal or a fault resolved by an attach of the lazy restore leaves no faulting region map
+	if(!faulting_mrm_info) return;
+
 	// Get state of faulting Region_map
 	Genode::Region_map::State state = Genode::Region_map_client{faulting_mrm_info->region_map_cap}.state();
 
@@ -65,8 +107,28 @@ void Fault_handler::_handle_fault()
 		return;
 	}
 
-	// Attach found dataspace to its designated address
-	dd_info->attach();
+	{
+		// The checkpointer shall see the dataspace either detached with its content pending
+		// in restore_ds_cap or attached with its content restored
+		Genode::Lock::Guard guard(dd_info->cow_lock);
+
+		// Copy stored content, if the dataspace is accessed for the first time after a restore
+		if(dd_info->restore_ds_cap.valid()) _restore_content(*dd_info);
+
+		// Save the checkpointed content, before the child can write to the dataspace
+		if(dd_info->cow_ds_cap.valid()) _save_content(*dd_info);
+
+		// Attach found dataspace to its designated address
+		dd_info->attach();
+	}
+
+	Genode::Trace::Timestamp const latency = Genode::Trace::timestamp() - start;
+	faulting_mrm_info->stats.fault(state.type, latency);
+
+	Event_trace::record(Event_trace::FAULT,
+			state.type == Genode::Region_map::State::READ_FAULT  ? Event_trace::FAULT_READ  :
+			state.type == Genode::Region_map::State::WRITE_FAULT ? Event_trace::FAULT_WRITE : Event_trace::FAULT_EXEC,
+			state.addr, latency);
 }
 
 
@@ -74,7 +136,7 @@ Fault_handler::Fault_handler(Genode::Env &env, Genode::Signal_receiver &receiver
 		Genode::List<Ram_dataspace_info> &ramds_infos)
 :
 	Thread(env, "managed dataspace pager", 16*1024),
-	_receiver(receiver), _ramds_infos(ramds_infos)
+	_env(env), _receiver(receiver), _ramds_infos(ramds_infos)
 { }
 
 
@@ -132,6 +194,72 @@ void Ram_session_component::_destroy_ramds_info(Ram_dataspace_info &ramds_info)
 }
 
 
+bool Ram_session_component::_alloc_designated_dataspaces(Managed_region_map_info &mrm_info,
+		Genode::size_t num_dataspaces, Genode::size_t ds_size, Genode::size_t remaining_dataspace_size,
+		Genode::Cache_attribute cached)
+{
+	typedef Genode::Foc_native_pd::Alloc_attach_batch Alloc_attach_batch;
+
+	Genode::Foc_native_pd_client native_pd(_env.pd().native_pd());
+	Alloc_attach_batch batch(cached);
+
+	auto flush = [&] () -> bool
+	{
+		Genode::Ram_dataspace_capability dataspaces[Alloc_attach_batch::MAX_ENTRIES];
+
+		native_pd.alloc_attach_batch(mrm_info.region_map_cap, _parent_ram.cap(), batch,
+				dataspaces[0], dataspaces[1], dataspaces[2]);
+
+		for(unsigned i = 0; i < batch.count; i++)
+		{
+			Alloc_attach_batch::Entry const &entry = batch.entries[i];
+
+			// Dataspaces which core could not allocate are allocated one by one
+			if(!dataspaces[i].valid())
+			{
+				try
+				{
+					dataspaces[i] = _parent_ram.alloc(entry.size, cached);
+				}
+				catch(Genode::Ram_session::Quota_exceeded)
+				{
+					Genode::error("_parent_ram has no memory!");
+
+					for(unsigned j = i + 1; j < batch.count; j++)
+						if(dataspaces[j].valid()) _parent_ram.free(dataspaces[j]);
+
+					return false;
+				}
+			}
+
+			// Create a Designated_dataspace_info and insert it into Managed_region_map_info's list
+			Designated_dataspace_info *new_dd_info =
+					new (_md_alloc) Designated_dataspace_info(mrm_info, dataspaces[i], entry.rel_addr, entry.size, true);
+			mrm_info.dd_infos.insert(new_dd_info);
+
+			// Dataspaces which core could not attach are attached one by one
+			if(entry.attached) new_dd_info->attached = true;
+			else new_dd_info->attach();
+		}
+
+		batch = Alloc_attach_batch(cached);
+		return true;
+	};
+
+	// Designated addresses of the whole dataspaces and of the remaining dataspace, which is the last one
+	for(Genode::size_t i = 0; i < num_dataspaces; ++i)
+	{
+		batch.add(ds_size * i, ds_size);
+		if(batch.full() && !flush()) return false;
+	}
+
+	if(remaining_dataspace_size != 0)
+		batch.add(num_dataspaces * ds_size, remaining_dataspace_size);
+
+	return !batch.count || flush();
+}
+
+
 Ram_session_component::Ram_session_component(Genode::Env &env, Genode::Allocator &md_alloc, Genode::size_t granularity,
 		const char *label, const char *creation_args, bool &bootstrap_phase)
 :
@@ -159,6 +287,9 @@ Ram_session_component::~Ram_session_component()
 		_destroy_ramds_info(*rds_info);
 	}
 
+	// The fault handler is destroyed without leaving its entry()
+	Event_trace::release(&_page_fault_handler);
+
 	if(verbose_debug) Genode::log("\033[33m", "~Ram", "\033[0m ", _parent_ram);
 }
 
@@ -175,6 +306,7 @@ Ram_session_component *Ram_session_component::find_by_badge(Genode::uint16_t bad
 Genode::Ram_dataspace_capability Ram_session_component::alloc(Genode::size_t size, Genode::Cache_attribute cached)
 {
 	if(verbose_debug) Genode::log("Ram::\033[33m", __func__, "\033[0m(size=", Genode::Hex(size),")");
+	Event_trace::record(Event_trace::RPC, Event_trace::RAM_ALLOC, size, _granularity);
 
 	// Use incremental checkpoint
 	if(_granularity > 0)
@@ -216,59 +348,9 @@ Genode::Ram_dataspace_capability Ram_session_component::alloc(Genode::size_t siz
 		// Set our pagefault handler for the Region_map with the  context of the Managed_region_map_info
 		new_rm_client.fault_handler(_receiver.manage(&new_mrm_info->context));
 
-		// Allocate num_dataspaces of Dataspaces and associate them with the Region_map
-		for(Genode::size_t i = 0; i < num_dataspaces; ++i)
-		{
-			Genode::Dataspace_capability ds_cap;
-
-			// Try to allocate a dataspace which will be associated with the new Region_map
-			try
-			{
-				ds_cap = _parent_ram.alloc(ds_size, cached);
-			}
-			catch(Genode::Ram_session::Quota_exceeded)
-			{
-				Genode::error("_parent_ram has no memory!");
-				return Genode::Capability<Genode::Ram_dataspace>();
-			}
-
-			// Compute designated address for the Region_map
-			Genode::addr_t rel_addr = ds_size * i;
-
-			// Create a Designated_dataspace_info
-			Designated_dataspace_info *new_dd_info =
-					new (_md_alloc) Designated_dataspace_info(*new_mrm_info, ds_cap, rel_addr, ds_size);
-
-			// Insert it into Managed_region_map_info's list
-			new_mrm_info->dd_infos.insert(new_dd_info);
-		}
-
-		// Allocate remaining Dataspace and associate it with the Region_map
-		if(remaining_dataspace_size != 0)
-		{
-			Genode::Dataspace_capability ds_cap;
-
-			// Try to allocate a dataspace which will be associated with the new region_map
-			try
-			{
-				ds_cap = _parent_ram.alloc(remaining_dataspace_size, cached);
-			}
-			catch(Genode::Ram_session::Quota_exceeded)
-			{
-				Genode::error("_parent_ram has no memory!");
-				return Genode::Capability<Genode::Ram_dataspace>();
-			}
-
-			// Compute designated address for the Region_map (it will be the last address in the Region_map)
-			Genode::addr_t local_addr = num_dataspaces * ds_size;
-
-			// Create a Designated_dataspace_info
-			Designated_dataspace_info *new_dd_info =
-					new (_md_alloc) Designated_dataspace_info(*new_mrm_info, ds_cap, local_addr, remaining_dataspace_size);
-
-			// Insert it into Managed_region_map_info's list
-			new_mrm_info->dd_infos.insert(new_dd_info);
-		}
+		// Allocate and attach all designated dataspaces in core
+		if(!_alloc_designated_dataspaces(*new_mrm_info, num_dataspaces, ds_size, remaining_dataspace_size, cached))
+			return Genode::Capability<Genode::Ram_dataspace>();
 
 		// Insert new Ram_dataspace_info into the list
 		Genode::Lock::Guard lock_guard(_parent_state.ram_dataspaces_lock);
@@ -306,6 +388,7 @@ Genode::Ram_dataspace_capability Ram_session_component::alloc(Genode::size_t siz
 void Ram_session_component::free(Genode::Ram_dataspace_capability ds_cap)
 {
 	if(verbose_debug) Genode::log("Ram::\033[33m", __func__, "\033[0m(", ds_cap, ")");
+	Event_trace::record(Event_trace::RPC, Event_trace::RAM_FREE, ds_cap.local_name());
 
 	Genode::Lock::Guard lock_guard(_parent_state.ram_dataspaces_lock);
 
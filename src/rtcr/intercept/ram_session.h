@@ -21,6 +21,7 @@
 /* Rtcr includes */
 #include "../online_storage/ram_dataspace_info.h"
 #include "../online_storage/ram_session_info.h"
+#include "../util/event_trace.h"
 
 namespace Rtcr {
 	class Fault_handler;
@@ -47,6 +48,10 @@ private:
 	 * Enable log output for debugging
 	 */
 	static constexpr bool verbose_debug = fh_verbose_debug;
+	/**
+	 * Environment for attaching dataspaces whose content is restored on the first access
+	 */
+	Genode::Env                      &_env;
 	/**
 	 * Signal_receiver on which the page fault handler waits
 	 */
@@ -63,6 +68,15 @@ private:
 	 * \return Pointer to Managed_region_map_info which contains the faulting Region_map
 	 */
 	Managed_region_map_info *_find_faulting_mrm_info();
+	/**
+	 * Copy the stored content of a designated dataspace which was restored on first access
+	 */
+	void _restore_content(Designated_dataspace_info &dd_info);
+	/**
+	 * Copy the content of a designated dataspace, which a budgeted checkpoint did not copy yet,
+	 * to its copy dataspace
+	 */
+	void _save_content(Designated_dataspace_info &dd_info);
 	/**
 	 * Handles the page fault by attaching a designated dataspace into its region map
 	 */
@@ -137,6 +151,13 @@ private:
 	 * Destroy rds_info and all its sub infos)
 	 */
 	void _destroy_ramds_info(Ram_dataspace_info &rds_info);
+	/**
+	 * Let core allocate the designated dataspaces of mrm_info and attach them with a few batched RPCs
+	 *
+	 * \return false, if the parent Ram session has no memory left
+	 */
+	bool _alloc_designated_dataspaces(Managed_region_map_info &mrm_info, Genode::size_t num_dataspaces,
+			Genode::size_t ds_size, Genode::size_t remaining_dataspace_size, Genode::Cache_attribute cached);
 
 public:
 	Ram_session_component(Genode::Env &env, Genode::Allocator &md_alloc, Genode::size_t granularity,
@@ -74,6 +74,7 @@ Genode::Region_map::Local_addr Region_map_component::attach(Genode::Dataspace_ca
 	// Attach dataspace to real Region map
 	Genode::addr_t addr = _parent_region_map.attach(
 			ds_cap, size, offset, use_local_addr, local_addr, executable);
+	Event_trace::record(Event_trace::RPC, Event_trace::RM_ATTACH, ds_cap.local_name(), addr);
 
 	// Actual size of the attached region; page-aligned
 	Genode::size_t actual_size;
@@ -116,6 +117,7 @@ void Region_map_component::detach(Region_map::Local_addr local_addr)
 
 	// Detach from real region map
 	_parent_region_map.detach(local_addr);
+	Event_trace::record(Event_trace::RPC, Event_trace::RM_DETACH, (Genode::addr_t)local_addr);
 
 	// Find region
 	Genode::Lock::Guard lock_guard(_parent_state.attached_regions_lock);
@@ -9,9 +9,16 @@
 #include <base/signal.h>
 #include <base/sleep.h>
 #include <base/log.h>
+#include <os/attached_rom_dataspace.h>
+#include <util/xml_node.h>
 
 /* Rtcr includes */
 #include "target_child.h"
+#include "target_registry.h"
+#include "checkpoint_scheduler.h"
+#include "calibration.h"
+#include "fault_telemetry.h"
+#include "trace_dump.h"
 #include "rtcr_root.h"
 
 namespace Rtcr {
@@ -25,7 +32,99 @@ struct Rtcr::Main
 	Genode::Heap              md_heap;
 	Genode::Service_registry  parent_services;
 	Genode::Entrypoint        root_ep;
+	/**
+	 * Costs measured at startup for predicting checkpoints
+	 */
+	Rtcr::Calibration         calibration;
+	Rtcr::Target_registry     registry;
 	Rtcr::Root                root;
+	Rtcr::Checkpoint_scheduler *scheduler = nullptr;
+	Rtcr::Fault_telemetry      *telemetry = nullptr;
+	Rtcr::Trace_dump           *trace_dump = nullptr;
+
+	/**
+	 * Start the targets listed in the config, e.g. <target name="sheep_counter" granularity="1"/>;
+	 * a target with warm_boot="yes" is checkpointed at its first request of the ready_service,
+	 * the generations attribute bounds the older checkpoints kept for restore and clone,
+	 * a <standby cadence_ms="200"/> node keeps a replica fed by the checkpoints of the target,
+	 * a <restore workers="2" first_cpu="1"/> node configures the threads copying its memory on restore,
+	 * checkpoint the targets with a <schedule> node periodically, report their fault
+	 * statistics, if there is a <telemetry> node, and trace the categories of events
+	 * listed by a <trace> node
+	 */
+	void start_configured_targets()
+	{
+		try
+		{
+			Genode::Attached_rom_dataspace config(env, "config");
+
+			unsigned tick_ms = 100;
+			unsigned workers = 1;
+			try
+			{
+				Genode::Xml_node scheduler_node = config.xml().sub_node("scheduler");
+				tick_ms = scheduler_node.attribute_value("tick_ms", tick_ms);
+				workers = scheduler_node.attribute_value("workers", workers);
+			}
+			catch(Genode::Xml_node::Nonexistent_sub_node) { }
+
+			if(config.xml().has_sub_node("telemetry"))
+			{
+				unsigned const period_ms = config.xml().sub_node("telemetry").attribute_value("period_ms", 1000U);
+				telemetry = new (md_heap) Fault_telemetry(env, registry, calibration.costs().ticks_per_us, period_ms);
+			}
+
+			if(config.xml().has_sub_node("trace"))
+			{
+				Genode::Xml_node trace_node = config.xml().sub_node("trace");
+				Genode::String<64> const categories = trace_node.attribute_value("categories", Genode::String<64>("all"));
+				unsigned const period_ms = trace_node.attribute_value("period_ms", 1000U);
+				trace_dump = new (md_heap) Trace_dump(env, calibration.costs().ticks_per_us,
+						Event_trace::parse_categories(categories.string()), period_ms);
+			}
+
+			config.xml().for_each_sub_node("target", [&] (Genode::Xml_node target) {
+				Target_registry::Name name = target.attribute_value("name", Target_registry::Name());
+				Genode::size_t granularity = target.attribute_value("granularity", (Genode::size_t)0);
+				bool const warm_boot = target.attribute_value("warm_boot", false);
+				Genode::String<32> const ready_service = target.attribute_value("ready_service", Genode::String<32>());
+				unsigned const generations = target.attribute_value("generations",
+						(unsigned)Target_registry::Target::DEFAULT_GENERATIONS);
+
+				if(warm_boot && !ready_service.valid())
+				{
+					Genode::warning("Target ", name, " is warm-booted without ready_service");
+					return;
+				}
+
+				Parallel_copy::Config copy_config;
+				if(target.has_sub_node("restore"))
+					copy_config = Parallel_copy::Config::from_xml(target.sub_node("restore"));
+
+				Standby::Config standby;
+				if(target.has_sub_node("standby"))
+					standby = Standby::Config::from_xml(target.sub_node("standby"));
+
+				try
+				{
+					registry.start(name, granularity, warm_boot ? ready_service.string() : nullptr, copy_config,
+							generations, standby);
+				}
+				catch(Rtcr::Session::Exception)
+				{
+					Genode::warning("Could not start target ", name);
+					return;
+				}
+
+				if(!target.has_sub_node("schedule")) return;
+
+				if(!scheduler) scheduler = new (md_heap) Checkpoint_scheduler(env, md_heap, registry, calibration,
+						tick_ms, workers);
+				scheduler->schedule(name, Checkpoint_scheduler::Policy::from_xml(target.sub_node("schedule")));
+			});
+		}
+		catch(Genode::Rom_connection::Rom_connection_failed) { }
+	}
 
 	Main(Genode::Env &env)
 	:
@@ -33,8 +132,12 @@ struct Rtcr::Main
 		md_heap         (env.ram(), env.rm()),
 		parent_services (),
 		root_ep         (env, ROOT_STACK_SIZE, "rtcr_root_ep"),
-		root            (root_ep, md_heap)
+		calibration     (env),
+		registry        (env, md_heap, parent_services),
+		root            (env, md_heap, registry, calibration)
 	{
+		start_configured_targets();
+
 		env.parent().announce(root_ep.manage(root));
 
 		//Genode::sleep_forever();
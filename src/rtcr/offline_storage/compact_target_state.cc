@@ -0,0 +1,488 @@
+/*
+ * \brief  Compact representation of a Target_state
+ * \author agent
+ * \date   2026-10-18
+ */
+
+/* Genode includes */
+#include <dataspace/client.h>
+
+/* Rtcr includes */
+#include "compact_target_state.h"
+#include "../target_state.h"
+
+using namespace Rtcr;
+
+
+/**
+ * djb2 hash of str
+ */
+static unsigned string_hash(char const *str)
+{
+	unsigned hash = 5381;
+	for(; *str; str++) hash = hash*33 + (unsigned char)*str;
+	return hash;
+}
+
+
+Compact_target_state::Index Compact_target_state::_intern(Interning &interning, char const *str)
+{
+	unsigned const hash = string_hash(str);
+
+	Index const found = interning.strings.find(hash, [&] (Index string) {
+		return !Genode::strcmp(&_strings[interning.string_offsets[string]], str); });
+	if(found != INVALID_INDEX) return interning.string_offsets[found];
+
+	// Append new string
+	Index const offset = _strings.size();
+	do { _strings.append(*str); } while(*str++);
+
+	interning.strings.insert(hash, interning.string_offsets.append(offset));
+
+	return offset;
+}
+
+
+Genode::Ram_dataspace_capability Compact_target_state::_copy(Genode::Ram_dataspace_capability ds_cap,
+		Genode::size_t size) const
+{
+	Genode::Ram_dataspace_capability copy_cap = _env.ram().alloc(size);
+
+	char *dst = _env.rm().attach(copy_cap);
+	char *src = _env.rm().attach(ds_cap);
+	Genode::memcpy(dst, src, size);
+	_env.rm().detach(src);
+	_env.rm().detach(dst);
+
+	return copy_cap;
+}
+
+
+Compact_target_state::Index Compact_target_state::_content(Interning &interning,
+		Genode::Ram_dataspace_capability ds_cap)
+{
+	if(!ds_cap.valid()) return INVALID_INDEX;
+
+	// The stored attached regions share the memory content with the stored RAM dataspaces
+	Genode::uint16_t const badge = ds_cap.local_name();
+	Index const found = interning.contents.find(badge, [&] (Index content) {
+		return interning.content_badges[content] == badge; });
+	if(found != INVALID_INDEX) return found;
+
+	Genode::size_t const size = Genode::Dataspace_client(ds_cap).size();
+
+	interning.content_badges.append(badge);
+	_content_size.append(size);
+	Index const content = _contents.append(_copy(ds_cap, size));
+	interning.contents.insert(badge, content);
+
+	return content;
+}
+
+
+Compact_target_state::Index Compact_target_state::_add_session(Interning &interning, Session_type type,
+		Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped, char const *creation_args,
+		char const *upgrade_args, Genode::uint8_t flags, Genode::uint16_t sigh_badge, Genode::uint16_t ref_badge,
+		Genode::uint32_t value)
+{
+	_session_type.append(type);
+	_session_flags.append(flags | (bootstrapped ? BOOTSTRAPPED : 0));
+	_session_badge.append(badge);
+	_session_sigh_badge.append(sigh_badge);
+	_session_ref_badge.append(ref_badge);
+	_session_kcap.append(kcap);
+	_session_creation_args.append(_intern(interning, creation_args));
+	_session_upgrade_args.append(_intern(interning, upgrade_args));
+
+	return _session_value.append(value);
+}
+
+
+Compact_target_state::Index Compact_target_state::_add_object(Object_type type, Genode::addr_t kcap,
+		Genode::uint16_t badge, bool bootstrapped, Index owner, Genode::uint8_t flags, Genode::uint16_t ref_badge,
+		Genode::uint16_t sigh_badge, Genode::addr_t addr, Genode::size_t size, Genode::addr_t value, Index extra)
+{
+	_object_type.append(type);
+	_object_flags.append(flags | (bootstrapped ? BOOTSTRAPPED : 0));
+	_object_badge.append(badge);
+	_object_ref_badge.append(ref_badge);
+	_object_sigh_badge.append(sigh_badge);
+	_object_kcap.append(kcap);
+	_object_owner.append(owner);
+	_object_addr.append(addr);
+	_object_size.append(size);
+	_object_value.append(value);
+
+	return _object_extra.append(extra);
+}
+
+
+void Compact_target_state::_add_region_map(Interning &interning, Object_type type,
+		Stored_region_map_info const &region_map, Index owner)
+{
+	// ref_badge = dataspace of the region map
+	Index const rm_index = _add_object(type, region_map.kcap, region_map.badge, region_map.bootstrapped,
+			owner, 0, region_map.ds_badge, region_map.sigh_badge, 0, region_map.size);
+
+	// ref_badge = attached dataspace, addr = relative address, value = offset, extra = content
+	Stored_attached_region_info const *ar = region_map.stored_attached_region_infos.first();
+	for(; ar; ar = ar->next())
+		_add_object(ATTACHED_REGION, ar->kcap, ar->badge, ar->bootstrapped, rm_index,
+				ar->executable ? EXECUTABLE : 0, ar->attached_ds_badge, 0, ar->rel_addr, ar->size,
+				ar->offset, _content(interning, ar->memory_content));
+}
+
+
+Compact_target_state::Compact_target_state(Genode::Env &env, Genode::Allocator &alloc, Target_state const &state)
+:
+	_env(env), _alloc(alloc), _strings(alloc),
+	_session_type(alloc), _session_flags(alloc), _session_badge(alloc), _session_sigh_badge(alloc),
+	_session_ref_badge(alloc), _session_kcap(alloc), _session_creation_args(alloc), _session_upgrade_args(alloc),
+	_session_value(alloc),
+	_object_type(alloc), _object_flags(alloc), _object_badge(alloc), _object_ref_badge(alloc),
+	_object_sigh_badge(alloc), _object_kcap(alloc), _object_owner(alloc), _object_addr(alloc),
+	_object_size(alloc), _object_value(alloc), _object_extra(alloc),
+	_thread_affinity(alloc), _thread_state(alloc),
+	_contents(alloc), _content_size(alloc),
+	_cap_idx_alloc_addr(state._cap_idx_alloc_addr), _cap_map_layout(state._cap_map_layout)
+{
+	Interning interning(alloc);
+
+	// PD sessions with their signal sources, signal contexts, native capabilities, and region maps
+	Stored_pd_session_info const *pd = state._stored_pd_sessions.first();
+	for(; pd; pd = pd->next())
+	{
+		Index const pd_index = _add_session(interning, PD, pd->kcap, pd->badge, pd->bootstrapped,
+				pd->creation_args.string(), pd->upgrade_args.string());
+
+		Stored_signal_source_info const *ss = pd->stored_source_infos.first();
+		for(; ss; ss = ss->next())
+			_add_object(SIGNAL_SOURCE, ss->kcap, ss->badge, ss->bootstrapped, pd_index);
+
+		// ref_badge = signal source, value = imprint
+		Stored_signal_context_info const *sc = pd->stored_context_infos.first();
+		for(; sc; sc = sc->next())
+			_add_object(SIGNAL_CONTEXT, sc->kcap, sc->badge, sc->bootstrapped, pd_index, 0,
+					sc->signal_source_badge, 0, 0, 0, sc->imprint);
+
+		// ref_badge = entrypoint
+		Stored_native_capability_info const *nc = pd->stored_native_cap_infos.first();
+		for(; nc; nc = nc->next())
+			_add_object(NATIVE_CAP, nc->kcap, nc->badge, nc->bootstrapped, pd_index, 0, nc->ep_badge);
+
+		_add_region_map(interning, ADDRESS_SPACE, pd->stored_address_space, pd_index);
+		_add_region_map(interning, STACK_AREA, pd->stored_stack_area, pd_index);
+		_add_region_map(interning, LINKER_AREA, pd->stored_linker_area, pd_index);
+	}
+
+	// CPU sessions with their threads
+	Stored_cpu_session_info const *cpu = state._stored_cpu_sessions.first();
+	for(; cpu; cpu = cpu->next())
+	{
+		Index const cpu_index = _add_session(interning, CPU, cpu->kcap, cpu->badge, cpu->bootstrapped,
+				cpu->creation_args.string(), cpu->upgrade_args.string(), 0, cpu->sigh_badge);
+
+		// ref_badge = PD session, addr = UTCB, size = weight, value = name, extra = thread table
+		Stored_cpu_thread_info const *thread = cpu->stored_cpu_thread_infos.first();
+		for(; thread; thread = thread->next())
+		{
+			Genode::uint8_t const flags = (thread->started ? STARTED : 0) | (thread->paused ? PAUSED : 0)
+					| (thread->single_step ? SINGLE_STEP : 0);
+
+			_thread_affinity.append(thread->affinity);
+			Index const extra = _thread_state.append(thread->ts);
+
+			_add_object(CPU_THREAD, thread->kcap, thread->badge, thread->bootstrapped, cpu_index, flags,
+					thread->pd_session_badge, thread->sigh_badge, thread->utcb, thread->weight.value,
+					_intern(interning, thread->name.string()), extra);
+		}
+	}
+
+	// RAM sessions with their dataspaces
+	Stored_ram_session_info const *ram = state._stored_ram_sessions.first();
+	for(; ram; ram = ram->next())
+	{
+		Index const ram_index = _add_session(interning, RAM, ram->kcap, ram->badge, ram->bootstrapped,
+				ram->creation_args.string(), ram->upgrade_args.string());
+
+		// addr = cache attribute, value = timestamp, extra = content
+		Stored_ram_dataspace_info const *ramds = ram->stored_ramds_infos.first();
+		for(; ramds; ramds = ramds->next())
+			_add_object(RAM_DATASPACE, ramds->kcap, ramds->badge, ramds->bootstrapped, ram_index,
+					ramds->managed ? MANAGED : 0, 0, 0, ramds->cached, ramds->size, ramds->timestamp,
+					_content(interning, ramds->memory_content));
+	}
+
+	// ROM sessions; ref_badge = dataspace
+	Stored_rom_session_info const *rom = state._stored_rom_sessions.first();
+	for(; rom; rom = rom->next())
+		_add_session(interning, ROM, rom->kcap, rom->badge, rom->bootstrapped,
+				rom->creation_args.string(), rom->upgrade_args.string(), 0, rom->sigh_badge, rom->dataspace_badge);
+
+	// RM sessions with their region maps
+	Stored_rm_session_info const *rm = state._stored_rm_sessions.first();
+	for(; rm; rm = rm->next())
+	{
+		Index const rm_index = _add_session(interning, RM, rm->kcap, rm->badge, rm->bootstrapped,
+				rm->creation_args.string(), rm->upgrade_args.string());
+
+		Stored_region_map_info const *region_map = rm->stored_region_map_infos.first();
+		for(; region_map; region_map = region_map->next())
+			_add_region_map(interning, REGION_MAP, *region_map, rm_index);
+	}
+
+	// LOG sessions
+	Stored_log_session_info const *log = state._stored_log_sessions.first();
+	for(; log; log = log->next())
+		_add_session(interning, LOG, log->kcap, log->badge, log->bootstrapped,
+				log->creation_args.string(), log->upgrade_args.string());
+
+	// Timer sessions; value = timeout
+	Stored_timer_session_info const *timer = state._stored_timer_sessions.first();
+	for(; timer; timer = timer->next())
+		_add_session(interning, TIMER, timer->kcap, timer->badge, timer->bootstrapped,
+				timer->creation_args.string(), timer->upgrade_args.string(),
+				timer->periodic ? PERIODIC : 0, timer->sigh_badge, 0, timer->timeout);
+}
+
+
+Compact_target_state::~Compact_target_state()
+{
+	for(Index i = 0; i < _contents.size(); i++) _env.ram().free(_contents[i]);
+}
+
+
+void Compact_target_state::expand(Target_state &state) const
+{
+	Genode::Allocator &alloc = state._alloc;
+
+	// The expanded infos of the sessions and region maps by their index; the owners are expanded first
+	Column<void*>                            sessions(alloc);
+	Column<Stored_region_map_info*>          region_maps(alloc);
+	Column<Genode::Ram_dataspace_capability> contents(alloc);
+	// Address space, stack area, and linker area of each session; only used for PD sessions
+	Column<Index>                            areas(alloc);
+
+	for(Index i = 0; i < _contents.size(); i++)
+		contents.append(_copy(_contents[i], _content_size[i]));
+
+	for(Index i = 0; i < 3*num_sessions(); i++) areas.append(INVALID_INDEX);
+	for(Index j = 0; j < num_objects(); j++)
+	{
+		Genode::uint8_t const type = _object_type[j];
+		if(type == ADDRESS_SPACE || type == STACK_AREA || type == LINKER_AREA)
+			areas[3*_object_owner[j] + type - ADDRESS_SPACE] = j;
+	}
+
+	auto content = [&] (Index i) {
+		return i == INVALID_INDEX ? Genode::Ram_dataspace_capability() : contents[i]; };
+
+	/*
+	 * The lists are filled from the last to the first element, because an inserted
+	 * element becomes the first; thus, the lists keep the order of the checkpoint.
+	 * The sessions are expanded in order first, for their index
+	 */
+	for(Index i = 0; i < num_sessions(); i++)
+	{
+		char const *cargs = &_strings[_session_creation_args[i]];
+		char const *uargs = &_strings[_session_upgrade_args[i]];
+		bool const bootstrapped = _session_flags[i] & BOOTSTRAPPED;
+		void *info = nullptr;
+
+		switch(_session_type[i])
+		{
+		case PD:
+		{
+			// The region maps are copied by the constructor; their attached regions are inserted below
+			Index const address_space = areas[3*i], stack_area = areas[3*i + 1], linker_area = areas[3*i + 2];
+
+			info = new (alloc) Stored_pd_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped,
+					Stored_region_map_info(_object_kcap[address_space], _object_badge[address_space],
+							_bootstrapped(address_space), _object_size[address_space],
+							_object_ref_badge[address_space], _object_sigh_badge[address_space]),
+					Stored_region_map_info(_object_kcap[stack_area], _object_badge[stack_area],
+							_bootstrapped(stack_area), _object_size[stack_area],
+							_object_ref_badge[stack_area], _object_sigh_badge[stack_area]),
+					Stored_region_map_info(_object_kcap[linker_area], _object_badge[linker_area],
+							_bootstrapped(linker_area), _object_size[linker_area],
+							_object_ref_badge[linker_area], _object_sigh_badge[linker_area]));
+			break;
+		}
+		case CPU:
+			info = new (alloc) Stored_cpu_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped, _session_sigh_badge[i]);
+			break;
+		case RAM:
+			info = new (alloc) Stored_ram_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped);
+			break;
+		case ROM:
+			info = new (alloc) Stored_rom_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped, _session_ref_badge[i], _session_sigh_badge[i]);
+			break;
+		case RM:
+			info = new (alloc) Stored_rm_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped);
+			break;
+		case LOG:
+			info = new (alloc) Stored_log_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped);
+			break;
+		case TIMER:
+			info = new (alloc) Stored_timer_session_info(state._args_pool, cargs, uargs, _session_kcap[i],
+					_session_badge[i], bootstrapped, _session_sigh_badge[i], _session_value[i],
+					_session_flags[i] & PERIODIC);
+			break;
+		}
+		sessions.append(info);
+	}
+
+	for(Index i = num_sessions(); i-- > 0; )
+	{
+		switch(_session_type[i])
+		{
+		case PD:    state._stored_pd_sessions.insert((Stored_pd_session_info*)sessions[i]);       break;
+		case CPU:   state._stored_cpu_sessions.insert((Stored_cpu_session_info*)sessions[i]);     break;
+		case RAM:   state._stored_ram_sessions.insert((Stored_ram_session_info*)sessions[i]);     break;
+		case ROM:   state._stored_rom_sessions.insert((Stored_rom_session_info*)sessions[i]);     break;
+		case RM:    state._stored_rm_sessions.insert((Stored_rm_session_info*)sessions[i]);       break;
+		case LOG:   state._stored_log_sessions.insert((Stored_log_session_info*)sessions[i]);     break;
+		case TIMER: state._stored_timer_sessions.insert((Stored_timer_session_info*)sessions[i]); break;
+		}
+	}
+
+	// The region maps are expanded before the attached regions, which reference them by index
+	for(Index i = 0; i < num_objects(); i++)
+	{
+		Stored_region_map_info *region_map = nullptr;
+		Stored_pd_session_info *pd = nullptr;
+
+		switch(_object_type[i])
+		{
+		case ADDRESS_SPACE:
+			pd = (Stored_pd_session_info*)sessions[_object_owner[i]];
+			region_map = &pd->stored_address_space;
+			break;
+		case STACK_AREA:
+			pd = (Stored_pd_session_info*)sessions[_object_owner[i]];
+			region_map = &pd->stored_stack_area;
+			break;
+		case LINKER_AREA:
+			pd = (Stored_pd_session_info*)sessions[_object_owner[i]];
+			region_map = &pd->stored_linker_area;
+			break;
+		case REGION_MAP:
+			region_map = new (alloc) Stored_region_map_info(_object_kcap[i], _object_badge[i], _bootstrapped(i),
+					_object_size[i], _object_ref_badge[i], _object_sigh_badge[i]);
+			break;
+		default: break;
+		}
+		region_maps.append(region_map);
+	}
+
+	for(Index i = num_objects(); i-- > 0; )
+	{
+		Index const owner = _object_owner[i];
+
+		switch(_object_type[i])
+		{
+		case NATIVE_CAP:
+			((Stored_pd_session_info*)sessions[owner])->stored_native_cap_infos.insert(
+					new (alloc) Stored_native_capability_info(_object_kcap[i], _object_badge[i], _bootstrapped(i),
+							_object_ref_badge[i]));
+			break;
+		case SIGNAL_SOURCE:
+			((Stored_pd_session_info*)sessions[owner])->stored_source_infos.insert(
+					new (alloc) Stored_signal_source_info(_object_kcap[i], _object_badge[i], _bootstrapped(i)));
+			break;
+		case SIGNAL_CONTEXT:
+			((Stored_pd_session_info*)sessions[owner])->stored_context_infos.insert(
+					new (alloc) Stored_signal_context_info(_object_kcap[i], _object_badge[i], _bootstrapped(i),
+							_object_ref_badge[i], _object_value[i]));
+			break;
+		case REGION_MAP:
+			((Stored_rm_session_info*)sessions[owner])->stored_region_map_infos.insert(region_maps[i]);
+			break;
+		case ATTACHED_REGION:
+			region_maps[owner]->stored_attached_region_infos.insert(
+					new (alloc) Stored_attached_region_info(_object_kcap[i], _object_badge[i], _bootstrapped(i),
+							_object_ref_badge[i], content(_object_extra[i]), _object_size[i],
+							_object_value[i], _object_addr[i], _object_flags[i] & EXECUTABLE));
+			break;
+		case CPU_THREAD:
+			((Stored_cpu_session_info*)sessions[owner])->stored_cpu_thread_infos.insert(
+					new (alloc) Stored_cpu_thread_info(_object_kcap[i], _object_badge[i], _bootstrapped(i),
+							_object_ref_badge[i], &_strings[_object_value[i]],
+							Genode::Cpu_session::Weight(_object_size[i]), _object_addr[i],
+							_object_flags[i] & STARTED, _object_flags[i] & PAUSED, _object_flags[i] & SINGLE_STEP,
+							_thread_affinity[_object_extra[i]], _object_sigh_badge[i],
+							_thread_state[_object_extra[i]]));
+			break;
+		case RAM_DATASPACE:
+			((Stored_ram_session_info*)sessions[owner])->stored_ramds_infos.insert(
+					new (alloc) Stored_ram_dataspace_info(_object_kcap[i], _object_badge[i], _bootstrapped(i),
+							content(_object_extra[i]), _object_size[i], (Genode::Cache_attribute)_object_addr[i],
+							_object_flags[i] & MANAGED, _object_value[i]));
+			break;
+		default: break;
+		}
+	}
+
+	state._cap_idx_alloc_addr = _cap_idx_alloc_addr;
+	state._cap_map_layout     = _cap_map_layout;
+}
+
+
+Genode::size_t Compact_target_state::memory() const
+{
+	return _strings.memory()
+		+ _session_type.memory() + _session_flags.memory() + _session_badge.memory()
+		+ _session_sigh_badge.memory() + _session_ref_badge.memory() + _session_kcap.memory()
+		+ _session_creation_args.memory() + _session_upgrade_args.memory() + _session_value.memory()
+		+ _object_type.memory() + _object_flags.memory() + _object_badge.memory()
+		+ _object_ref_badge.memory() + _object_sigh_badge.memory() + _object_kcap.memory()
+		+ _object_owner.memory() + _object_addr.memory() + _object_size.memory()
+		+ _object_value.memory() + _object_extra.memory()
+		+ _thread_affinity.memory() + _thread_state.memory()
+		+ _contents.memory() + _content_size.memory();
+}
+
+
+Genode::size_t Compact_target_state::content_bytes() const
+{
+	Genode::size_t bytes = 0;
+	for(Index i = 0; i < _content_size.size(); i++) bytes += _content_size[i];
+	return bytes;
+}
+
+
+void Compact_target_state::print(Genode::Output &output) const
+{
+	using Genode::Hex;
+
+	static char const *session_names[] = { "PD", "CPU", "RAM", "ROM", "RM", "LOG", "Timer" };
+	static char const *object_names[]  = { "native cap", "signal source", "signal context", "address space",
+	                                       "stack area", "linker area", "region map", "attached region",
+	                                       "CPU thread", "RAM dataspace" };
+
+	Genode::print(output, "Compact_target_state: ", num_sessions(), " sessions, ", num_objects(),
+			" objects, ", _strings.size(), " bytes of strings, ", memory(), " bytes of tables, ",
+			content_bytes(), " bytes of content\n");
+
+	for(Index i = 0; i < num_sessions(); i++)
+	{
+		Genode::print(output, " [", i, "] ", session_names[_session_type[i]], " <", Hex(_session_kcap[i]),
+				", ", _session_badge[i], "> flags=", Hex(_session_flags[i]),
+				", cargs='", &_strings[_session_creation_args[i]], "', uargs='",
+				&_strings[_session_upgrade_args[i]], "'\n");
+	}
+
+	for(Index i = 0; i < num_objects(); i++)
+	{
+		Genode::print(output, " [", i, "] ", object_names[_object_type[i]], " <", Hex(_object_kcap[i]),
+				", ", _object_badge[i], "> flags=", Hex(_object_flags[i]),
+				", owner=", _object_owner[i], ", ref_badge=", _object_ref_badge[i],
+				", addr=", Hex(_object_addr[i]), ", size=", Hex(_object_size[i]), "\n");
+	}
+}
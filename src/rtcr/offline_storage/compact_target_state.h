@@ -0,0 +1,301 @@
+/*
+ * \brief  Compact representation of a Target_state
+ * \author agent
+ * \date   2026-10-18
+ *
+ * A Compact_target_state stores a checkpointed Target_state in
+ * structure-of-arrays tables. Objects reference their owner (e.g. a thread its
+ * CPU session) by a 32-bit index into the tables instead of list pointers, and
+ * all strings (session arguments, thread names) are deduplicated into one
+ * string table and referenced by 32-bit offsets. It holds its own copy of the
+ * memory content, thus, it stays valid while the Target_state is overwritten
+ * by the following incremental checkpoints. This allows to keep older
+ * checkpoint generations of a target at a fraction of the metadata of the
+ * list-based Target_state; expand() turns a generation into a Target_state
+ * again for restoring it.
+ */
+
+#ifndef _RTCR_COMPACT_TARGET_STATE_H_
+#define _RTCR_COMPACT_TARGET_STATE_H_
+
+/* Genode includes */
+#include <base/env.h>
+#include <base/allocator.h>
+#include <base/log.h>
+#include <base/affinity.h>
+#include <base/thread_state.h>
+#include <util/string.h>
+
+/* Rtcr includes */
+#include "../util/cap_map_layout.h"
+
+namespace Rtcr {
+	class Compact_target_state;
+
+	// Forward declaration
+	class Target_state;
+	struct Stored_region_map_info;
+}
+
+
+class Rtcr::Compact_target_state
+{
+public:
+	typedef Genode::uint32_t Index;
+
+	enum { INVALID_INDEX = ~0U };
+
+	enum Session_type { PD, CPU, RAM, ROM, RM, LOG, TIMER };
+
+	enum Object_type { NATIVE_CAP, SIGNAL_SOURCE, SIGNAL_CONTEXT, ADDRESS_SPACE, STACK_AREA, LINKER_AREA,
+	                   REGION_MAP, ATTACHED_REGION, CPU_THREAD, RAM_DATASPACE };
+
+	/**
+	 * Bits of the flags columns; the meaning of the upper bits depends on the type
+	 */
+	enum Flag { BOOTSTRAPPED = 1 << 0,
+	            EXECUTABLE = 1 << 1,                                       /* attached region */
+	            MANAGED = 1 << 1,                                          /* RAM dataspace */
+	            STARTED = 1 << 1, PAUSED = 1 << 2, SINGLE_STEP = 1 << 3,   /* CPU thread */
+	            PERIODIC = 1 << 1 };                                       /* Timer session */
+
+private:
+	/**
+	 * Growable array allocated from the Compact_target_state's allocator; the elements are
+	 * relocated by copying their bytes
+	 */
+	template<typename T>
+	class Column
+	{
+	private:
+		Genode::Allocator &_alloc;
+		T                 *_data;
+		Index              _size;
+		Index              _capacity;
+
+		void _grow()
+		{
+			Index const new_capacity = _capacity ? 2*_capacity : 16;
+
+			T *new_data = nullptr;
+			if(!_alloc.alloc(new_capacity*sizeof(T), (void**)&new_data))
+			{
+				Genode::error("Could not grow column to ", new_capacity, " elements");
+				throw Genode::Exception();
+			}
+			if(_data)
+			{
+				Genode::memcpy(new_data, _data, _size*sizeof(T));
+				_alloc.free(_data, _capacity*sizeof(T));
+			}
+			_data     = new_data;
+			_capacity = new_capacity;
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Column(Column const &);
+		Column &operator = (Column const &);
+
+	public:
+		Column(Genode::Allocator &alloc) : _alloc(alloc), _data(nullptr), _size(0), _capacity(0) { }
+		~Column()
+		{
+			for(Index i = 0; i < _size; i++) _data[i].~T();
+			if(_data) _alloc.free(_data, _capacity*sizeof(T));
+		}
+
+		Index append(T const &value)
+		{
+			if(_size == _capacity) _grow();
+			new (&_data[_size]) T(value);
+			return _size++;
+		}
+
+		T       &operator [] (Index i)       { return _data[i]; }
+		T const &operator [] (Index i) const { return _data[i]; }
+
+		Index size() const { return _size; }
+
+		Genode::size_t memory() const { return _capacity*sizeof(T); }
+	};
+
+	/**
+	 * Hash chains for deduplicating the strings and the memory contents while compacting
+	 */
+	struct Chains
+	{
+		enum { BUCKETS = 64 };
+
+		Index         heads[BUCKETS];
+		Column<Index> next;
+
+		Chains(Genode::Allocator &alloc) : next(alloc)
+		{
+			for(unsigned i = 0; i < BUCKETS; i++) heads[i] = INVALID_INDEX;
+		}
+
+		/**
+		 * Return the first entry of the chain of key for which match(entry) is true, or INVALID_INDEX
+		 */
+		template<typename MATCH>
+		Index find(unsigned key, MATCH const &match) const
+		{
+			Index entry = heads[key % BUCKETS];
+			while(entry != INVALID_INDEX && !match(entry)) entry = next[entry];
+			return entry;
+		}
+
+		/**
+		 * Add entry to the chain of key; the entries are added in ascending order from 0
+		 */
+		void insert(unsigned key, Index entry)
+		{
+			next.append(heads[key % BUCKETS]);
+			heads[key % BUCKETS] = entry;
+		}
+	};
+
+	/**
+	 * Lookup tables of the interned strings and contents, needed only while compacting
+	 */
+	struct Interning
+	{
+		Chains                   strings;
+		/**
+		 * Offset of each interned string in _strings; the chains reference the strings by their number
+		 */
+		Column<Index>            string_offsets;
+		Chains                   contents;
+		/**
+		 * Badge of the dataspace of the Target_state copied into each content
+		 */
+		Column<Genode::uint16_t> content_badges;
+
+		Interning(Genode::Allocator &alloc)
+		: strings(alloc), string_offsets(alloc), contents(alloc), content_badges(alloc) { }
+	};
+
+	Genode::Env       &_env;
+	Genode::Allocator &_alloc;
+
+	/**
+	 * Deduplicated, null-terminated strings; a string is referenced by its offset
+	 */
+	Column<char> _strings;
+
+	/*
+	 * Session table
+	 *
+	 * sigh_badge is used by CPU, ROM, and Timer sessions, ref_badge is the
+	 * dataspace of a ROM session, and value is the timeout of a Timer session.
+	 */
+	Column<Genode::uint8_t>  _session_type;
+	Column<Genode::uint8_t>  _session_flags;
+	Column<Genode::uint16_t> _session_badge;
+	Column<Genode::uint16_t> _session_sigh_badge;
+	Column<Genode::uint16_t> _session_ref_badge;
+	Column<Genode::uint32_t> _session_kcap;
+	Column<Index>            _session_creation_args;
+	Column<Index>            _session_upgrade_args;
+	Column<Genode::uint32_t> _session_value;
+
+	/*
+	 * Object table
+	 *
+	 * owner is an index into the session table, except for attached regions,
+	 * which reference their region map in the object table. ref_badge, addr,
+	 * size, value, and extra have an object type specific meaning (see
+	 * _add_object calls in compact_target_state.cc); extra is an index into the
+	 * content table or the thread table.
+	 */
+	Column<Genode::uint8_t>  _object_type;
+	Column<Genode::uint8_t>  _object_flags;
+	Column<Genode::uint16_t> _object_badge;
+	Column<Genode::uint16_t> _object_ref_badge;
+	Column<Genode::uint16_t> _object_sigh_badge;
+	Column<Genode::uint32_t> _object_kcap;
+	Column<Index>            _object_owner;
+	Column<Genode::addr_t>   _object_addr;
+	Column<Genode::size_t>   _object_size;
+	Column<Genode::addr_t>   _object_value;
+	Column<Index>            _object_extra;
+
+	/*
+	 * Thread table; the register state and the affinity of each CPU thread
+	 */
+	Column<Genode::Affinity::Location> _thread_affinity;
+	Column<Genode::Thread_state>       _thread_state;
+
+	/*
+	 * Content table; the copies of the memory content owned by this Compact_target_state
+	 */
+	Column<Genode::Ram_dataspace_capability> _contents;
+	Column<Genode::size_t>                   _content_size;
+
+	Genode::addr_t   _cap_idx_alloc_addr;
+	Cap_map_layout   _cap_map_layout;
+
+	Index _intern(Interning &interning, char const *str);
+	/**
+	 * Return the index of the copy of ds_cap; the content is copied on its first use
+	 */
+	Index _content(Interning &interning, Genode::Ram_dataspace_capability ds_cap);
+	Genode::Ram_dataspace_capability _copy(Genode::Ram_dataspace_capability ds_cap, Genode::size_t size) const;
+
+	Index _add_session(Interning &interning, Session_type type, Genode::addr_t kcap, Genode::uint16_t badge,
+			bool bootstrapped, char const *creation_args, char const *upgrade_args,
+			Genode::uint8_t flags = 0, Genode::uint16_t sigh_badge = 0, Genode::uint16_t ref_badge = 0,
+			Genode::uint32_t value = 0);
+
+	Index _add_object(Object_type type, Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Index owner, Genode::uint8_t flags = 0, Genode::uint16_t ref_badge = 0,
+			Genode::uint16_t sigh_badge = 0, Genode::addr_t addr = 0, Genode::size_t size = 0,
+			Genode::addr_t value = 0, Index extra = INVALID_INDEX);
+
+	void _add_region_map(Interning &interning, Object_type type, Stored_region_map_info const &region_map,
+			Index owner);
+
+	bool _bootstrapped(Index object) const { return _object_flags[object] & BOOTSTRAPPED; }
+
+	/*
+	 * Noncopyable
+	 */
+	Compact_target_state(Compact_target_state const &);
+	Compact_target_state &operator = (Compact_target_state const &);
+
+public:
+	/**
+	 * Create the compact representation of state; the memory content of state is copied
+	 *
+	 * state must be complete, i.e. the memory deferred by a budgeted checkpoint is copied.
+	 */
+	Compact_target_state(Genode::Env &env, Genode::Allocator &alloc, Target_state const &state);
+	~Compact_target_state();
+
+	/**
+	 * Rebuild the checkpointed state into the empty state
+	 *
+	 * The memory content is copied to dataspaces owned by state, thus, this
+	 * Compact_target_state can be expanded again and destroyed independently.
+	 */
+	void expand(Target_state &state) const;
+
+	Index num_sessions() const { return _session_badge.size(); }
+	Index num_objects()  const { return _object_badge.size(); }
+	Index num_contents() const { return _contents.size(); }
+
+	/**
+	 * Memory used by the tables in bytes, without the memory content
+	 */
+	Genode::size_t memory() const;
+	/**
+	 * Memory content held in bytes
+	 */
+	Genode::size_t content_bytes() const;
+
+	void print(Genode::Output &output) const;
+};
+
+#endif /* _RTCR_COMPACT_TARGET_STATE_H_ */
@@ -41,6 +41,22 @@ struct Rtcr::Stored_attached_region_info : Stored_normal_info, Genode::List<Stor
 		executable (info.executable)
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_attached_region_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::uint16_t attached_ds_badge, Genode::Ram_dataspace_capability memory_content,
+			Genode::size_t size, Genode::off_t offset, Genode::addr_t rel_addr, bool executable)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped),
+		attached_ds_badge (attached_ds_badge),
+		memory_content    (memory_content),
+		size       (size),
+		offset     (offset),
+		rel_addr   (rel_addr),
+		executable (executable)
+	{ }
+
 	Stored_attached_region_info *find_by_addr(Genode::addr_t addr)
 	{
 		if((addr >= rel_addr) && (addr <= rel_addr + size))
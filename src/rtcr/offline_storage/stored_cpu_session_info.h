@@ -25,9 +25,9 @@ struct Rtcr::Stored_cpu_session_info : Stored_session_info, Genode::List<Stored_
 	Genode::uint16_t sigh_badge;
 	Genode::List<Stored_cpu_thread_info> stored_cpu_thread_infos;
 
-	Stored_cpu_session_info(Cpu_session_component &cpu_session, Genode::addr_t targets_kcap)
+	Stored_cpu_session_info(String_pool &args_pool, Cpu_session_component &cpu_session, Genode::addr_t targets_kcap)
 	:
-		Stored_session_info(cpu_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, cpu_session.parent_state().creation_args.string(),
 				cpu_session.parent_state().upgrade_args.string(),
 				targets_kcap,
 				cpu_session.cap().local_name(),
@@ -36,6 +36,17 @@ struct Rtcr::Stored_cpu_session_info : Stored_session_info, Genode::List<Stored_
 		stored_cpu_thread_infos()
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_cpu_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped, Genode::uint16_t sigh_badge)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped),
+		sigh_badge(sigh_badge),
+		stored_cpu_thread_infos()
+	{ }
+
 	Stored_cpu_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
@@ -49,6 +49,27 @@ struct Rtcr::Stored_cpu_thread_info : Stored_normal_info, Genode::List<Stored_cp
 		ts          ()
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_cpu_thread_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::uint16_t pd_session_badge, char const *name, Genode::Cpu_session::Weight weight,
+			Genode::addr_t utcb, bool started, bool paused, bool single_step,
+			Genode::Affinity::Location affinity, Genode::uint16_t sigh_badge, Genode::Thread_state const &ts)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped),
+		pd_session_badge(pd_session_badge),
+		name        (name),
+		weight      (weight),
+		utcb        (utcb),
+		started     (started),
+		paused      (paused),
+		single_step (single_step),
+		affinity    (affinity),
+		sigh_badge  (sigh_badge),
+		ts          (ts)
+	{ }
+
 	Stored_cpu_thread_info *find_by_name(const char *name)
 	{
 		if(!Genode::strcmp(name, this->name.string()))
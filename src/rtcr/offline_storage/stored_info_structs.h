@@ -11,6 +11,9 @@
 #include <util/list.h>
 #include <util/string.h>
 
+/* Rtcr includes */
+#include "../offline_storage/string_pool.h"
+
 namespace Rtcr {
 	struct Stored_general_info;
 	struct Stored_session_info;
@@ -51,14 +54,19 @@ struct Rtcr::Stored_general_info
  */
 struct Rtcr::Stored_session_info : Stored_general_info
 {
-	Genode::String<160> const creation_args;
-	Genode::String<160> upgrade_args;
+	/**
+	 * Session arguments are interned in Target_state's String_pool, because they
+	 * are mostly equal across sessions and checkpoints
+	 */
+	Interned_string const creation_args;
+	Interned_string upgrade_args;
 
-	Stored_session_info(const char* creation_args, const char* upgrade_args, Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped)
+	Stored_session_info(String_pool &args_pool, const char* creation_args, const char* upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped)
 	:
 		Stored_general_info (kcap, badge, bootstrapped),
-		creation_args (creation_args),
-		upgrade_args  (upgrade_args)
+		creation_args (args_pool, creation_args),
+		upgrade_args  (args_pool, upgrade_args)
 	{ }
 
 	void print(Genode::Output &output) const
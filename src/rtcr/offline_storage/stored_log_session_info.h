@@ -22,15 +22,24 @@ namespace Rtcr {
 struct Rtcr::Stored_log_session_info : Stored_session_info, Genode::List<Stored_log_session_info>::Element
 {
 
-	Stored_log_session_info(Log_session_component &log_session, Genode::addr_t targets_kcap)
+	Stored_log_session_info(String_pool &args_pool, Log_session_component &log_session, Genode::addr_t targets_kcap)
 	:
-		Stored_session_info(log_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, log_session.parent_state().creation_args.string(),
 				log_session.parent_state().upgrade_args.string(),
 				targets_kcap,
 				log_session.cap().local_name(),
 				log_session.parent_state().bootstrapped)
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_log_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped)
+	{ }
+
 	Stored_log_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
@@ -29,6 +29,16 @@ struct Rtcr::Stored_native_capability_info : Stored_normal_info, Genode::List<St
 		ep_badge(info.ep_cap.local_name())
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_native_capability_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::uint16_t ep_badge)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped),
+		ep_badge(ep_badge)
+	{ }
+
 	Stored_native_capability_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
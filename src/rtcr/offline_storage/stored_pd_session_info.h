@@ -32,10 +32,10 @@ struct Rtcr::Stored_pd_session_info : Stored_session_info, Genode::List<Stored_p
 	Stored_region_map_info stored_stack_area;
 	Stored_region_map_info stored_linker_area;
 
-	Stored_pd_session_info(Pd_session_component &pd_session, Genode::addr_t targets_pd_kcap,
+	Stored_pd_session_info(String_pool &args_pool, Pd_session_component &pd_session, Genode::addr_t targets_pd_kcap,
 			Genode::addr_t targets_add_kcap, Genode::addr_t targets_sta_kcap, Genode::addr_t targets_lin_kcap)
 	:
-		Stored_session_info(pd_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, pd_session.parent_state().creation_args.string(),
 				pd_session.parent_state().upgrade_args.string(),
 				targets_pd_kcap,
 				pd_session.cap().local_name(),
@@ -46,6 +46,26 @@ struct Rtcr::Stored_pd_session_info : Stored_session_info, Genode::List<Stored_p
 		stored_linker_area(pd_session.linker_area_component(), targets_lin_kcap)
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 *
+	 * The region maps are copied without attached regions
+	 */
+	Stored_pd_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Stored_region_map_info const &address_space, Stored_region_map_info const &stack_area,
+			Stored_region_map_info const &linker_area)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped),
+		stored_context_infos(), stored_source_infos(), stored_native_cap_infos(),
+		stored_address_space(address_space.kcap, address_space.badge, address_space.bootstrapped,
+				address_space.size, address_space.ds_badge, address_space.sigh_badge),
+		stored_stack_area(stack_area.kcap, stack_area.badge, stack_area.bootstrapped,
+				stack_area.size, stack_area.ds_badge, stack_area.sigh_badge),
+		stored_linker_area(linker_area.kcap, linker_area.badge, linker_area.bootstrapped,
+				linker_area.size, linker_area.ds_badge, linker_area.sigh_badge)
+	{ }
+
 	Stored_pd_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
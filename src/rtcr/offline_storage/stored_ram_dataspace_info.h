@@ -17,11 +17,18 @@
 
 namespace Rtcr {
 	struct Stored_ram_dataspace_info;
+
+	constexpr bool stored_ramds_verbose_debug = false;
 }
 
 
 struct Rtcr::Stored_ram_dataspace_info : Stored_normal_info, Genode::List<Stored_ram_dataspace_info>::Element
 {
+	/**
+	 * Enable log output for debugging
+	 */
+	static constexpr bool verbose_debug = stored_ramds_verbose_debug;
+
 	Genode::Ram_dataspace_capability const memory_content;
 	Genode::size_t                   const size;
 	Genode::Cache_attribute          const cached;
@@ -37,10 +44,22 @@ struct Rtcr::Stored_ram_dataspace_info : Stored_normal_info, Genode::List<Stored
 		size(info.size), cached(info.cached), managed(info.mrm_info),
 		timestamp(info.timestamp())
 	{
-		Genode::log("  Ram_dataspace_info: ", info.timestamp(), " ", info.timestamp(), " ", info.timestamp());
-		Genode::log("  Stored_ram_dataspace_info: ", timestamp);
+		if(verbose_debug) Genode::log("  Stored_ram_dataspace_info: ", timestamp);
 	}
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_ram_dataspace_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::Ram_dataspace_capability memory_content, Genode::size_t size,
+			Genode::Cache_attribute cached, bool managed, Genode::size_t timestamp)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped),
+		memory_content(memory_content),
+		size(size), cached(cached), managed(managed),
+		timestamp(timestamp)
+	{ }
+
 	Stored_ram_dataspace_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
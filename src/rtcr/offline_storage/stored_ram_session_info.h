@@ -24,9 +24,9 @@ struct Rtcr::Stored_ram_session_info : Stored_session_info, Genode::List<Stored_
 {
 	Genode::List<Stored_ram_dataspace_info> stored_ramds_infos;
 
-	Stored_ram_session_info(Ram_session_component &ram_session, Genode::addr_t targets_kcap)
+	Stored_ram_session_info(String_pool &args_pool, Ram_session_component &ram_session, Genode::addr_t targets_kcap)
 	:
-		Stored_session_info(ram_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, ram_session.parent_state().creation_args.string(),
 				ram_session.parent_state().upgrade_args.string(),
 				targets_kcap,
 				ram_session.cap().local_name(),
@@ -34,6 +34,16 @@ struct Rtcr::Stored_ram_session_info : Stored_session_info, Genode::List<Stored_
 		stored_ramds_infos()
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_ram_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped),
+		stored_ramds_infos()
+	{ }
+
 	Stored_ram_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
@@ -39,6 +39,19 @@ struct Rtcr::Stored_region_map_info : Stored_normal_info, Genode::List<Stored_re
 		stored_attached_region_infos()
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_region_map_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::size_t size, Genode::uint16_t ds_badge, Genode::uint16_t sigh_badge)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped),
+		size(size),
+		ds_badge(ds_badge),
+		sigh_badge(sigh_badge),
+		stored_attached_region_infos()
+	{ }
+
 	Stored_region_map_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
@@ -24,9 +24,9 @@ struct Rtcr::Stored_rm_session_info : Stored_session_info, Genode::List<Stored_r
 {
 	Genode::List<Stored_region_map_info> stored_region_map_infos;
 
-	Stored_rm_session_info(Rm_session_component &rm_session, Genode::addr_t targets_kcap)
+	Stored_rm_session_info(String_pool &args_pool, Rm_session_component &rm_session, Genode::addr_t targets_kcap)
 	:
-		Stored_session_info(rm_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, rm_session.parent_state().creation_args.string(),
 				rm_session.parent_state().upgrade_args.string(),
 				targets_kcap,
 				rm_session.cap().local_name(),
@@ -34,6 +34,16 @@ struct Rtcr::Stored_rm_session_info : Stored_session_info, Genode::List<Stored_r
 		stored_region_map_infos()
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_rm_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped),
+		stored_region_map_infos()
+	{ }
+
 	Stored_rm_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
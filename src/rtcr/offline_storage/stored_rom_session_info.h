@@ -24,10 +24,10 @@ struct Rtcr::Stored_rom_session_info : Stored_session_info, Genode::List<Stored_
 	Genode::uint16_t dataspace_badge;
 	Genode::uint16_t sigh_badge;
 
-	Stored_rom_session_info(Rom_session_component &rom_session, Genode::addr_t targets_kcap,
+	Stored_rom_session_info(String_pool &args_pool, Rom_session_component &rom_session, Genode::addr_t targets_kcap,
 			Genode::Ram_dataspace_capability copy_ds_cap)
 	:
-		Stored_session_info(rom_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, rom_session.parent_state().creation_args.string(),
 				rom_session.parent_state().upgrade_args.string(),
 				targets_kcap,
 				rom_session.cap().local_name(),
@@ -36,6 +36,18 @@ struct Rtcr::Stored_rom_session_info : Stored_session_info, Genode::List<Stored_
 		sigh_badge      (rom_session.parent_state().sigh.local_name())
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_rom_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::uint16_t dataspace_badge, Genode::uint16_t sigh_badge)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped),
+		dataspace_badge (dataspace_badge),
+		sigh_badge      (sigh_badge)
+	{ }
+
 	Stored_rom_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
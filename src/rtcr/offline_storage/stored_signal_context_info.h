@@ -32,6 +32,17 @@ struct Rtcr::Stored_signal_context_info : Stored_normal_info, Genode::List<Store
 		imprint(info.imprint)
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_signal_context_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::uint16_t signal_source_badge, unsigned long imprint)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped),
+		signal_source_badge(signal_source_badge),
+		imprint(imprint)
+	{ }
+
 	Stored_signal_context_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
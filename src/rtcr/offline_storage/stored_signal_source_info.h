@@ -26,6 +26,14 @@ struct Rtcr::Stored_signal_source_info : Stored_normal_info, Genode::List<Stored
 		Stored_normal_info(targets_kcap, info.cap.local_name(), info.bootstrapped)
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_signal_source_info(Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped)
+	:
+		Stored_normal_info(kcap, badge, bootstrapped)
+	{ }
+
 	Stored_signal_source_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
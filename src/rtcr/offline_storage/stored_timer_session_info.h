@@ -25,9 +25,9 @@ struct Rtcr::Stored_timer_session_info : Stored_session_info, Genode::List<Store
 	unsigned         timeout;
 	bool             periodic;
 
-	Stored_timer_session_info(Timer_session_component &timer_session, Genode::addr_t targets_kcap)
+	Stored_timer_session_info(String_pool &args_pool, Timer_session_component &timer_session, Genode::addr_t targets_kcap)
 	:
-		Stored_session_info(timer_session.parent_state().creation_args.string(),
+		Stored_session_info(args_pool, timer_session.parent_state().creation_args.string(),
 				timer_session.parent_state().upgrade_args.string(),
 				targets_kcap,
 				timer_session.cap().local_name(),
@@ -37,6 +37,19 @@ struct Rtcr::Stored_timer_session_info : Stored_session_info, Genode::List<Store
 		periodic   (timer_session.parent_state().periodic)
 	{ }
 
+	/**
+	 * Constructor for the expansion of a Compact_target_state
+	 */
+	Stored_timer_session_info(String_pool &args_pool, char const *creation_args, char const *upgrade_args,
+			Genode::addr_t kcap, Genode::uint16_t badge, bool bootstrapped,
+			Genode::uint16_t sigh_badge, unsigned timeout, bool periodic)
+	:
+		Stored_session_info(args_pool, creation_args, upgrade_args, kcap, badge, bootstrapped),
+		sigh_badge (sigh_badge),
+		timeout    (timeout),
+		periodic   (periodic)
+	{ }
+
 	Stored_timer_session_info *find_by_badge(Genode::uint16_t badge)
 	{
 		if(badge == this->badge)
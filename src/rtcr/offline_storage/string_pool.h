@@ -0,0 +1,189 @@
+/*
+ * \brief  Pool of interned, deduplicated strings for the stored state
+ * \author agent
+ * \date   2026-10-18
+ *
+ * Session arguments of a target are mostly equal across sessions and across
+ * checkpoints. Instead of embedding fixed-size buffers in every stored session,
+ * the stored sessions reference a reference-counted entry of the pool. The
+ * entries are hashed into BUCKETS lists, thus, interning the arguments of all
+ * sessions does not compare each string with all previously interned ones.
+ */
+
+#ifndef _RTCR_STRING_POOL_H_
+#define _RTCR_STRING_POOL_H_
+
+/* Genode includes */
+#include <util/list.h>
+#include <util/string.h>
+#include <base/allocator.h>
+#include <base/lock.h>
+#include <base/log.h>
+
+/* Rtcr includes */
+
+namespace Rtcr {
+	class String_pool;
+	class Interned_string;
+}
+
+
+class Rtcr::String_pool
+{
+public:
+	/**
+	 * Entry of the pool; the null-terminated string follows directly
+	 */
+	struct Entry : Genode::List<Entry>::Element
+	{
+		unsigned       ref_cnt;
+		unsigned const hash;
+		Genode::size_t length;
+
+		Entry(unsigned hash, Genode::size_t length) : ref_cnt(1), hash(hash), length(length) { }
+
+		char const *string() const { return (char const*)(this + 1); }
+		char       *string()       { return (char*)(this + 1); }
+
+		Entry *find_by_string(unsigned hash, char const *str)
+		{
+			if(hash == this->hash && !Genode::strcmp(str, string()))
+				return this;
+			Entry *entry = next();
+			return entry ? entry->find_by_string(hash, str) : 0;
+		}
+	};
+
+private:
+	enum { BUCKETS = 64 };
+
+	Genode::Allocator   &_alloc;
+	Genode::Lock         _lock;
+	Genode::List<Entry>  _buckets[BUCKETS];
+	Genode::size_t       _num_entries;
+
+	/**
+	 * djb2 hash of str
+	 */
+	static unsigned _hash(char const *str)
+	{
+		unsigned hash = 5381;
+		for(; *str; str++) hash = hash*33 + (unsigned char)*str;
+		return hash;
+	}
+
+	Genode::List<Entry> &_bucket(unsigned hash) { return _buckets[hash % BUCKETS]; }
+
+public:
+	String_pool(Genode::Allocator &alloc) : _alloc(alloc), _lock(), _buckets(), _num_entries(0) { }
+
+	~String_pool()
+	{
+		for(unsigned i = 0; i < BUCKETS; i++)
+		{
+			while(Entry *entry = _buckets[i].first())
+			{
+				_buckets[i].remove(entry);
+				_alloc.free(entry, sizeof(Entry) + entry->length + 1);
+			}
+		}
+	}
+
+	/**
+	 * Return the entry for str; the entry is created, if it does not exist
+	 */
+	Entry *intern(char const *str)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		unsigned const hash = _hash(str);
+		Entry *entry = _bucket(hash).first();
+		if(entry) entry = entry->find_by_string(hash, str);
+		if(entry)
+		{
+			entry->ref_cnt++;
+			return entry;
+		}
+
+		Genode::size_t const length = Genode::strlen(str);
+		void *addr = nullptr;
+		if(!_alloc.alloc(sizeof(Entry) + length + 1, &addr))
+		{
+			Genode::error("Could not intern string of length ", length);
+			throw Genode::Exception();
+		}
+		entry = new (addr) Entry(hash, length);
+		Genode::memcpy(entry->string(), str, length + 1);
+
+		_bucket(hash).insert(entry);
+		_num_entries++;
+
+		return entry;
+	}
+
+	void acquire(Entry *entry)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		entry->ref_cnt++;
+	}
+
+	void release(Entry *entry)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		if(--entry->ref_cnt > 0) return;
+
+		_bucket(entry->hash).remove(entry);
+		_num_entries--;
+		_alloc.free(entry, sizeof(Entry) + entry->length + 1);
+	}
+
+	Genode::size_t num_entries() const { return _num_entries; }
+};
+
+
+/**
+ * Reference to a String_pool entry
+ */
+class Rtcr::Interned_string
+{
+private:
+	String_pool        *_pool;
+	String_pool::Entry *_entry;
+
+public:
+	Interned_string(String_pool &pool, char const *str)
+	:
+		_pool(&pool), _entry(pool.intern(str))
+	{ }
+
+	Interned_string(Interned_string const &other)
+	:
+		_pool(other._pool), _entry(other._entry)
+	{
+		_pool->acquire(_entry);
+	}
+
+	Interned_string &operator = (Interned_string const &other)
+	{
+		if(_entry == other._entry) return *this;
+
+		other._pool->acquire(other._entry);
+		_pool->release(_entry);
+		_pool  = other._pool;
+		_entry = other._entry;
+
+		return *this;
+	}
+
+	~Interned_string() { _pool->release(_entry); }
+
+	char const *string() const { return _entry->string(); }
+
+	Genode::size_t length() const { return _entry->length; }
+
+	void print(Genode::Output &output) const { Genode::print(output, string()); }
+};
+
+#endif /* _RTCR_STRING_POOL_H_ */
@@ -9,14 +9,20 @@
 
 /* Genode includes */
 #include <util/list.h>
+#include <util/misc_math.h>
+#include <util/string.h>
+#include <base/lock.h>
+#include <trace/timestamp.h>
 #include <ram_session/ram_session.h>
 #include <region_map/client.h>
+#include <foc_native_pd/client.h>
 
 /* Rtcr includes */
 #include "../online_storage/info_structs.h"
 
 namespace Rtcr {
 	struct Ram_dataspace_info;
+	struct Fault_statistics;
 	struct Managed_region_map_info;
 	struct Designated_dataspace_info;
 
@@ -84,6 +90,58 @@ struct Rtcr::Ram_dataspace_info : Normal_obj_info, private Simple_counter<Ram_da
 };
 
 
+/**
+ * Fault and dirty statistics of a managed Ram dataspace
+ *
+ * The statistics are written by the fault handler and the Checkpointer, and read by the
+ * telemetry without synchronization; a read may be inconsistent by a few faults.
+ */
+struct Rtcr::Fault_statistics
+{
+	enum { LATENCY_BUCKETS = 32 };
+
+	unsigned long read_faults;
+	unsigned long write_faults;
+	unsigned long exec_faults;
+	/**
+	 * Histogram of the fault handling latency; bucket i counts the latencies
+	 * of [2^i, 2^(i+1)) ticks of Genode::Trace::timestamp()
+	 */
+	unsigned long latency[LATENCY_BUCKETS];
+	/**
+	 * Checkpoints (epochs) and the designated dataspaces which were dirty in them
+	 */
+	unsigned long epochs;
+	unsigned      dirty_last;
+	unsigned      dirty_max;
+	unsigned long dirty_sum;
+
+	Fault_statistics() { Genode::memset(this, 0, sizeof(*this)); }
+
+	void fault(Genode::Region_map::State::State_type type, Genode::Trace::Timestamp ticks)
+	{
+		switch(type)
+		{
+		case Genode::Region_map::State::READ_FAULT:  read_faults++;  break;
+		case Genode::Region_map::State::WRITE_FAULT: write_faults++; break;
+		case Genode::Region_map::State::EXEC_FAULT:  exec_faults++;  break;
+		default: break;
+		}
+
+		unsigned const bucket = ticks ? (unsigned)Genode::log2(ticks) : 0;
+		latency[Genode::min(bucket, (unsigned)LATENCY_BUCKETS - 1)]++;
+	}
+
+	void epoch(unsigned dirty)
+	{
+		epochs++;
+		dirty_last = dirty;
+		dirty_max  = Genode::max(dirty_max, dirty);
+		dirty_sum += dirty;
+	}
+};
+
+
 /**
  * This struct holds information about a Region map, its designated Ram dataspaces
  */
@@ -101,12 +159,27 @@ struct Rtcr::Managed_region_map_info
 	 * Signal context for receiving page faults
 	 */
 	Genode::Signal_context context;
+	Fault_statistics       stats;
 
 	Managed_region_map_info(Genode::Capability<Genode::Region_map> region_map_cap)
 	:
-		region_map_cap(region_map_cap), dd_infos(), context()
+		region_map_cap(region_map_cap), dd_infos(), context(), stats()
 	{ }
 
+	/**
+	 * Attach all detached designated dataspaces using batched RPCs
+	 *
+	 * \param native_pd Native PD through which core attaches the dataspaces
+	 */
+	inline void attach_designated_dataspaces(Genode::Capability<Genode::Pd_session::Native_pd> native_pd);
+
+	/**
+	 * Detach all attached designated dataspaces using batched RPCs
+	 *
+	 * \param native_pd Native PD through which core detaches the dataspaces
+	 */
+	inline void detach_designated_dataspaces(Genode::Capability<Genode::Pd_session::Native_pd> native_pd);
+
 };
 
 
@@ -143,17 +216,48 @@ struct Rtcr::Designated_dataspace_info : public Genode::List<Designated_dataspac
 	 * Indicates whether this dataspace is attached to its Region_map
 	 */
 	bool attached;
+	/**
+	 * Stored content which is copied to this dataspace on the first access after a restore;
+	 * invalid, if the dataspace holds its content already
+	 */
+	Genode::Dataspace_capability restore_ds_cap;
+	/**
+	 * Offset of the content within restore_ds_cap
+	 */
+	Genode::addr_t               restore_offset;
+	/**
+	 * Copy dataspace to which the content has to be saved before the dataspace is attached again;
+	 * invalid, if the content is checkpointed already. It is set for the dataspaces which a
+	 * budgeted checkpoint did not copy while the child was paused (copy-on-write)
+	 */
+	Genode::Ram_dataspace_capability cow_ds_cap;
+	/**
+	 * Offset of the content within cow_ds_cap
+	 */
+	Genode::addr_t                   cow_offset;
+	/**
+	 * Serializes restoring, saving, and attaching the content between the fault handler and the checkpointer
+	 */
+	Genode::Lock                     cow_lock;
+	/**
+	 * Number of checkpoints in which the dataspace was dirty
+	 */
+	unsigned long                    dirty_epochs;
 
 	/**
 	 * Constructor
+	 *
+	 * \param deferred_attach If true, the caller attaches the dataspace or marks it as attached by
+	 *                        core, e.g. Managed_region_map_info::attach_designated_dataspaces
 	 */
 	Designated_dataspace_info(Managed_region_map_info &mrm_info, Genode::Dataspace_capability ds_cap,
-			Genode::addr_t addr, Genode::size_t size)
+			Genode::addr_t addr, Genode::size_t size, bool deferred_attach = false)
 	:
-		mrm_info(mrm_info), cap(ds_cap), rel_addr(addr), size(size), attached(false)
+		mrm_info(mrm_info), cap(ds_cap), rel_addr(addr), size(size), attached(false),
+		restore_ds_cap(), restore_offset(0), cow_ds_cap(), cow_offset(0), cow_lock(), dirty_epochs(0)
 	{
 		// Every new dataspace shall be attached and marked
-		attach();
+		if(!deferred_attach) attach();
 	}
 
 	/**
@@ -243,4 +347,104 @@ struct Rtcr::Designated_dataspace_info : public Genode::List<Designated_dataspac
 	}
 };
 
+
+void Rtcr::Managed_region_map_info::attach_designated_dataspaces(
+		Genode::Capability<Genode::Pd_session::Native_pd> native_pd)
+{
+	typedef Genode::Foc_native_pd::Attach_batch Attach_batch;
+
+	Genode::Foc_native_pd_client native_pd_client(native_pd);
+	Attach_batch batch;
+	Designated_dataspace_info *batch_infos[Attach_batch::MAX_ENTRIES];
+
+	auto flush = [&] ()
+	{
+		Genode::Dataspace_capability dataspaces[Attach_batch::MAX_ENTRIES];
+		for(unsigned i = 0; i < batch.count; i++) dataspaces[i] = batch_infos[i]->cap;
+
+		native_pd_client.attach_batch(region_map_cap, batch, dataspaces[0], dataspaces[1], dataspaces[2]);
+
+		for(unsigned i = 0; i < batch.count; i++)
+		{
+			// Dataspaces which core could not attach are attached one by one
+			if(batch.entries[i].attached) batch_infos[i]->attached = true;
+			else batch_infos[i]->attach();
+		}
+
+		batch = Attach_batch();
+	};
+
+	for(Designated_dataspace_info *dd_info = dd_infos.first(); dd_info; dd_info = dd_info->next())
+	{
+		if(dd_info->attached) continue;
+
+		batch_infos[batch.count] = dd_info;
+		batch.add(dd_info->rel_addr, dd_info->size);
+
+		if(batch.full()) flush();
+	}
+
+	if(batch.count) flush();
+}
+
+
+void Rtcr::Managed_region_map_info::detach_designated_dataspaces(
+		Genode::Capability<Genode::Pd_session::Native_pd> native_pd)
+{
+	typedef Genode::Foc_native_pd::Detach_batch Detach_batch;
+
+	Genode::Foc_native_pd_client native_pd_client(native_pd);
+	Detach_batch batch;
+	// First Designated_dataspace_info of each entry; the others follow in the list
+	Designated_dataspace_info *batch_infos[Detach_batch::MAX_ENTRIES];
+
+	auto flush = [&] ()
+	{
+		native_pd_client.detach_batch(region_map_cap, batch);
+
+		for(unsigned i = 0; i < batch.count; i++)
+		{
+			Designated_dataspace_info *dd_info = batch_infos[i];
+			for(unsigned j = 0; j < batch.entries[i].count; j++, dd_info = dd_info->next())
+			{
+				// Regions which core could not detach are detached one by one
+				if(batch.entries[i].detached) dd_info->attached = false;
+				else dd_info->detach();
+			}
+		}
+
+		batch = Detach_batch();
+	};
+
+	/*
+	 * Designated dataspaces are inserted in ascending order of their addresses, thus,
+	 * the list contains them in descending order. A run of adjacent dataspaces is
+	 * described by one entry, which grows towards lower addresses.
+	 */
+	Designated_dataspace_info *last = nullptr;
+	for(Designated_dataspace_info *dd_info = dd_infos.first(); dd_info; last = dd_info, dd_info = dd_info->next())
+	{
+		if(!dd_info->attached) continue;
+
+		Detach_batch::Entry *run = batch.count ? &batch.entries[batch.count - 1] : nullptr;
+
+		if(run && last && last->attached && last->next() == dd_info
+				&& dd_info->rel_addr + dd_info->size == run->rel_addr
+				&& (run->count == 1 || dd_info->size == run->stride))
+		{
+			run->rel_addr = dd_info->rel_addr;
+			run->stride   = dd_info->size;
+			run->count++;
+			continue;
+		}
+
+		if(batch.full()) flush();
+
+		batch_infos[batch.count] = dd_info;
+		batch.add(dd_info->rel_addr, dd_info->size);
+	}
+
+	if(batch.count) flush();
+}
+
 #endif /* _RTCR_RAM_DATASPACE_INFO_H_ */
@@ -0,0 +1,249 @@
+/*
+ * \brief  Restore plan compiled from a Target_state
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#include "restore_plan.h"
+
+using namespace Rtcr;
+
+
+void Restore_plan::_collect_badges(Target_state &state, Badge_set &badges, Badge_set &region_map_ds_badges)
+{
+	if(verbose_debug) Genode::log("Plan::\033[33m", __func__, "\033[0m(...)");
+
+	// Region maps, their dataspaces and the dataspaces attached to them
+	auto add_region_map = [&] (Stored_region_map_info &stored_region_map) {
+		badges.add(stored_region_map.badge);
+		badges.add(stored_region_map.ds_badge);
+		region_map_ds_badges.add(stored_region_map.ds_badge);
+
+		Stored_attached_region_info *stored_attached_region = stored_region_map.stored_attached_region_infos.first();
+		while(stored_attached_region)
+		{
+			badges.add(stored_attached_region->attached_ds_badge);
+			stored_attached_region = stored_attached_region->next();
+		}
+	};
+
+	Stored_pd_session_info *stored_pd_session = state._stored_pd_sessions.first();
+	while(stored_pd_session)
+	{
+		badges.add(stored_pd_session->badge);
+
+		Stored_signal_source_info *stored_source = stored_pd_session->stored_source_infos.first();
+		for(; stored_source; stored_source = stored_source->next()) badges.add(stored_source->badge);
+		Stored_signal_context_info *stored_context = stored_pd_session->stored_context_infos.first();
+		for(; stored_context; stored_context = stored_context->next()) badges.add(stored_context->badge);
+		Stored_native_capability_info *stored_native_cap = stored_pd_session->stored_native_cap_infos.first();
+		for(; stored_native_cap; stored_native_cap = stored_native_cap->next()) badges.add(stored_native_cap->badge);
+
+		add_region_map(stored_pd_session->stored_address_space);
+		add_region_map(stored_pd_session->stored_stack_area);
+		add_region_map(stored_pd_session->stored_linker_area);
+
+		stored_pd_session = stored_pd_session->next();
+	}
+
+	Stored_cpu_session_info *stored_cpu_session = state._stored_cpu_sessions.first();
+	while(stored_cpu_session)
+	{
+		badges.add(stored_cpu_session->badge);
+
+		Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_session->stored_cpu_thread_infos.first();
+		for(; stored_cpu_thread; stored_cpu_thread = stored_cpu_thread->next()) badges.add(stored_cpu_thread->badge);
+
+		stored_cpu_session = stored_cpu_session->next();
+	}
+
+	Stored_ram_session_info *stored_ram_session = state._stored_ram_sessions.first();
+	while(stored_ram_session)
+	{
+		badges.add(stored_ram_session->badge);
+
+		Stored_ram_dataspace_info *stored_ramds = stored_ram_session->stored_ramds_infos.first();
+		for(; stored_ramds; stored_ramds = stored_ramds->next()) badges.add(stored_ramds->badge);
+
+		stored_ram_session = stored_ram_session->next();
+	}
+
+	Stored_rm_session_info *stored_rm_session = state._stored_rm_sessions.first();
+	while(stored_rm_session)
+	{
+		badges.add(stored_rm_session->badge);
+
+		Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
+		for(; stored_region_map; stored_region_map = stored_region_map->next()) add_region_map(*stored_region_map);
+
+		stored_rm_session = stored_rm_session->next();
+	}
+
+	Stored_rom_session_info *stored_rom_session = state._stored_rom_sessions.first();
+	for(; stored_rom_session; stored_rom_session = stored_rom_session->next()) badges.add(stored_rom_session->badge);
+	Stored_log_session_info *stored_log_session = state._stored_log_sessions.first();
+	for(; stored_log_session; stored_log_session = stored_log_session->next()) badges.add(stored_log_session->badge);
+	Stored_timer_session_info *stored_timer_session = state._stored_timer_sessions.first();
+	for(; stored_timer_session; stored_timer_session = stored_timer_session->next()) badges.add(stored_timer_session->badge);
+}
+
+
+void Restore_plan::_collect_extents(Target_state &state, Badge_set const &region_map_ds_badges)
+{
+	if(verbose_debug) Genode::log("Plan::\033[33m", __func__, "\033[0m(...)");
+
+	// Count the upper bound of extents: one per RAM dataspace and one per attached region
+	Stored_ram_session_info *stored_ram_session = state._stored_ram_sessions.first();
+	for(; stored_ram_session; stored_ram_session = stored_ram_session->next())
+	{
+		Stored_ram_dataspace_info *stored_ramds = stored_ram_session->stored_ramds_infos.first();
+		for(; stored_ramds; stored_ramds = stored_ramds->next()) _max_extents++;
+	}
+	auto count_regions = [&] (Stored_region_map_info &stored_region_map) {
+		Stored_attached_region_info *stored_attached_region = stored_region_map.stored_attached_region_infos.first();
+		for(; stored_attached_region; stored_attached_region = stored_attached_region->next()) _max_extents++;
+	};
+	Stored_pd_session_info *stored_pd_session = state._stored_pd_sessions.first();
+	for(; stored_pd_session; stored_pd_session = stored_pd_session->next())
+	{
+		count_regions(stored_pd_session->stored_address_space);
+		count_regions(stored_pd_session->stored_stack_area);
+		count_regions(stored_pd_session->stored_linker_area);
+	}
+	Stored_rm_session_info *stored_rm_session = state._stored_rm_sessions.first();
+	for(; stored_rm_session; stored_rm_session = stored_rm_session->next())
+	{
+		Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
+		for(; stored_region_map; stored_region_map = stored_region_map->next()) count_regions(*stored_region_map);
+	}
+
+	if(!_max_extents) return;
+
+	if(!_alloc.alloc(_max_extents*sizeof(Copy_extent), (void**)&_extents))
+	{
+		Genode::error("Could not allocate ", _max_extents, " copy extents");
+		throw Genode::Exception();
+	}
+
+	// Each stored content is copied once; it is shared by a RAM dataspace and the regions it is attached to
+	Badge_set *copied = new (_alloc) Badge_set();
+
+	auto add_extent = [&] (Genode::uint16_t ds_badge, Genode::Ram_dataspace_capability content, Genode::size_t size) {
+		if(copied->contains(content.local_name())) return;
+		copied->add(content.local_name());
+
+		// The array is raw memory; the capability has to be constructed in place
+		Genode::construct_at<Copy_extent>(&_extents[_num_extents++], ds_badge, content, size);
+	};
+
+	stored_ram_session = state._stored_ram_sessions.first();
+	for(; stored_ram_session; stored_ram_session = stored_ram_session->next())
+	{
+		Stored_ram_dataspace_info *stored_ramds = stored_ram_session->stored_ramds_infos.first();
+		for(; stored_ramds; stored_ramds = stored_ramds->next())
+		{
+			add_extent(stored_ramds->badge, stored_ramds->memory_content, stored_ramds->size);
+			_ram_quota += stored_ramds->size;
+		}
+	}
+	auto add_regions = [&] (Stored_region_map_info &stored_region_map) {
+		Stored_attached_region_info *stored_attached_region = stored_region_map.stored_attached_region_infos.first();
+		for(; stored_attached_region; stored_attached_region = stored_attached_region->next())
+		{
+			// The content of region maps is restored through the dataspaces attached to them
+			if(region_map_ds_badges.contains(stored_attached_region->attached_ds_badge)) continue;
+
+			add_extent(stored_attached_region->attached_ds_badge, stored_attached_region->memory_content,
+					stored_attached_region->size);
+		}
+	};
+	stored_pd_session = state._stored_pd_sessions.first();
+	for(; stored_pd_session; stored_pd_session = stored_pd_session->next())
+	{
+		add_regions(stored_pd_session->stored_address_space);
+		add_regions(stored_pd_session->stored_stack_area);
+		add_regions(stored_pd_session->stored_linker_area);
+	}
+	stored_rm_session = state._stored_rm_sessions.first();
+	for(; stored_rm_session; stored_rm_session = stored_rm_session->next())
+	{
+		Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
+		for(; stored_region_map; stored_region_map = stored_region_map->next()) add_regions(*stored_region_map);
+	}
+
+	Genode::destroy(_alloc, copied);
+}
+
+
+Genode::uint16_t *Restore_plan::_to_array(Badge_set const &set, unsigned &count)
+{
+	count = 0;
+	for(unsigned badge = 0; badge < (1 << 16); badge++)
+		if(set.contains(badge)) count++;
+
+	if(!count) return nullptr;
+
+	Genode::uint16_t *array = nullptr;
+	if(!_alloc.alloc(count*sizeof(Genode::uint16_t), (void**)&array))
+	{
+		Genode::error("Could not allocate array of ", count, " badges");
+		throw Genode::Exception();
+	}
+
+	unsigned i = 0;
+	for(unsigned badge = 0; badge < (1 << 16); badge++)
+		if(set.contains(badge)) array[i++] = badge;
+
+	return array;
+}
+
+
+unsigned Restore_plan::_search(Genode::uint16_t const *array, unsigned count, Genode::uint16_t badge)
+{
+	unsigned lower = 0;
+	unsigned upper = count;
+	while(lower < upper)
+	{
+		unsigned const middle = lower + (upper - lower) / 2;
+		if(array[middle] == badge) return middle;
+		if(array[middle] < badge) lower = middle + 1;
+		else upper = middle;
+	}
+	return INVALID_INDEX;
+}
+
+
+Restore_plan::Restore_plan(Genode::Allocator &alloc, Target_state &state)
+:
+	_alloc(alloc),
+	_badges(nullptr), _num_badges(0),
+	_region_map_ds_badges(nullptr), _num_region_map_ds_badges(0),
+	_extents(nullptr), _num_extents(0), _max_extents(0),
+	_ram_quota(0)
+{
+	if(verbose_debug) Genode::log("\033[33m", "Restore_plan", "\033[0m(...)");
+
+	Badge_set *badges = new (_alloc) Badge_set();
+	Badge_set *region_map_ds_badges = new (_alloc) Badge_set();
+
+	_collect_badges(state, *badges, *region_map_ds_badges);
+	_collect_extents(state, *region_map_ds_badges);
+
+	_badges = _to_array(*badges, _num_badges);
+	_region_map_ds_badges = _to_array(*region_map_ds_badges, _num_region_map_ds_badges);
+
+	Genode::destroy(_alloc, region_map_ds_badges);
+	Genode::destroy(_alloc, badges);
+
+	if(verbose_debug) Genode::log("Restore plan: ", _num_badges, " badges, ", _num_extents, " copy extents, ",
+			"ram_quota=", Genode::Hex(_ram_quota));
+}
+
+
+Restore_plan::~Restore_plan()
+{
+	if(_badges) _alloc.free(_badges, _num_badges*sizeof(Genode::uint16_t));
+	if(_region_map_ds_badges) _alloc.free(_region_map_ds_badges, _num_region_map_ds_badges*sizeof(Genode::uint16_t));
+	for(unsigned i = 0; i < _num_extents; i++) _extents[i].~Copy_extent();
+	if(_extents) _alloc.free(_extents, _max_extents*sizeof(Copy_extent));
+}
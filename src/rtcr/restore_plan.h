@@ -0,0 +1,132 @@
+/*
+ * \brief  Restore plan compiled from a Target_state
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The plan contains the analysis of a Target_state which does not depend on the
+ * restored child: a dense index of all checkpointed badges (used by the Restorer
+ * for translating badges in an array instead of a list), the set of dataspaces
+ * which belong to region maps, the extents of memory to copy, and the RAM quota
+ * needed for the recreated dataspaces. It is compiled once and shared by all
+ * restores of the same Target_state; it has to be recompiled, if the Target_state
+ * is updated by a checkpoint.
+ */
+
+#ifndef _RTCR_RESTORE_PLAN_H_
+#define _RTCR_RESTORE_PLAN_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <util/string.h>
+#include <util/construct_at.h>
+#include <ram_session/ram_session.h>
+
+/* Rtcr includes */
+#include "target_state.h"
+
+namespace Rtcr {
+	class Restore_plan;
+
+	constexpr bool restore_plan_verbose_debug = false;
+}
+
+
+class Rtcr::Restore_plan
+{
+public:
+	enum { INVALID_INDEX = ~0U };
+
+	/**
+	 * Stored content which is copied to the dataspace with the checkpointed badge ds_badge
+	 */
+	struct Copy_extent
+	{
+		Genode::uint16_t                 ds_badge;
+		Genode::Ram_dataspace_capability content;
+		Genode::size_t                   size;
+
+		Copy_extent(Genode::uint16_t ds_badge, Genode::Ram_dataspace_capability content, Genode::size_t size)
+		: ds_badge(ds_badge), content(content), size(size) { }
+	};
+
+private:
+	/**
+	 * Enable log output for debugging
+	 */
+	static constexpr bool verbose_debug = restore_plan_verbose_debug;
+
+	/**
+	 * Set of 16-bit badges; it replaces sorting the badges
+	 */
+	struct Badge_set
+	{
+		enum { NUM_WORDS = (1 << 16) / 32 };
+
+		Genode::uint32_t bits[NUM_WORDS];
+
+		Badge_set() { Genode::memset(bits, 0, sizeof(bits)); }
+
+		void add(Genode::uint16_t badge) { bits[badge / 32] |= 1U << (badge % 32); }
+		bool contains(Genode::uint16_t badge) const { return bits[badge / 32] & (1U << (badge % 32)); }
+	};
+
+	Genode::Allocator &_alloc;
+	/**
+	 * Ascending checkpointed badges; the position of a badge is its index
+	 */
+	Genode::uint16_t  *_badges;
+	unsigned           _num_badges;
+	/**
+	 * Ascending badges of dataspaces which belong to region maps; their content is not copied
+	 */
+	Genode::uint16_t  *_region_map_ds_badges;
+	unsigned           _num_region_map_ds_badges;
+	Copy_extent       *_extents;
+	unsigned           _num_extents;
+	unsigned           _max_extents;
+	Genode::size_t     _ram_quota;
+
+	/*
+	 * Noncopyable
+	 */
+	Restore_plan(Restore_plan const &);
+	Restore_plan &operator = (Restore_plan const &);
+
+	void _collect_badges(Target_state &state, Badge_set &badges, Badge_set &region_map_ds_badges);
+	void _collect_extents(Target_state &state, Badge_set const &region_map_ds_badges);
+
+	Genode::uint16_t *_to_array(Badge_set const &set, unsigned &count);
+	static unsigned _search(Genode::uint16_t const *array, unsigned count, Genode::uint16_t badge);
+
+public:
+	/**
+	 * Compile the plan of state
+	 */
+	Restore_plan(Genode::Allocator &alloc, Target_state &state);
+	~Restore_plan();
+
+	/**
+	 * Number of checkpointed badges; it is the size of arrays indexed by index()
+	 */
+	unsigned num_badges() const { return _num_badges; }
+	/**
+	 * Return the dense index of a checkpointed badge or INVALID_INDEX
+	 */
+	unsigned index(Genode::uint16_t badge) const { return _search(_badges, _num_badges, badge); }
+	/**
+	 * Return whether the checkpointed dataspace badge belongs to a region map
+	 */
+	bool region_map_dataspace(Genode::uint16_t badge) const
+	{
+		return _search(_region_map_ds_badges, _num_region_map_ds_badges, badge) != INVALID_INDEX;
+	}
+
+	unsigned num_extents() const { return _num_extents; }
+	Copy_extent const &extent(unsigned i) const { return _extents[i]; }
+	/**
+	 * RAM quota needed by the child for its recreated RAM dataspaces
+	 */
+	Genode::size_t ram_quota() const { return _ram_quota; }
+};
+
+#endif /* _RTCR_RESTORE_PLAN_H_ */
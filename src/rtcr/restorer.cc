@@ -7,8 +7,6 @@
 #include "restorer.h"
 #include "util/sort.h"
 #include "util/debug.h"
-#include <base/internal/cap_map.h>
-#include <base/internal/cap_alloc.h>
 
 using namespace Rtcr;
 
@@ -18,12 +16,11 @@ void Restorer::_destroy_list(Genode::List<T> &list)
 	while(T *elem = list.first())
 	{
 		list.remove(elem);
-		Genode::destroy(_alloc, elem);
+		Genode::destroy(_arena, elem);
 	}
 }
 template void Restorer::_destroy_list(Genode::List<Ckpt_resto_badge_info> &list);
 template void Restorer::_destroy_list(Genode::List<Orig_copy_resto_info> &list);
-template void Restorer::_destroy_list(Genode::List<Ref_badge> &list);
 template void Restorer::_destroy_list(Genode::List<Cap_kcap_info> &list);
 
 
@@ -38,9 +35,9 @@ Genode::List<Ref_badge> Restorer::_create_region_map_dataspaces(
 	Stored_pd_session_info *stored_pd_session = stored_pd_sessions.first();
 	while(stored_pd_session)
 	{
-		result.insert(new (_alloc) Ref_badge(stored_pd_session->stored_address_space.ds_badge));
-		result.insert(new (_alloc) Ref_badge(stored_pd_session->stored_stack_area.ds_badge));
-		result.insert(new (_alloc) Ref_badge(stored_pd_session->stored_linker_area.ds_badge));
+		result.insert(new (_arena) Ref_badge(stored_pd_session->stored_address_space.ds_badge));
+		result.insert(new (_arena) Ref_badge(stored_pd_session->stored_stack_area.ds_badge));
+		result.insert(new (_arena) Ref_badge(stored_pd_session->stored_linker_area.ds_badge));
 
 		stored_pd_session = stored_pd_session->next();
 	}
@@ -52,7 +49,7 @@ Genode::List<Ref_badge> Restorer::_create_region_map_dataspaces(
 		Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
 		while(stored_region_map)
 		{
-			result.insert(new (_alloc) Ref_badge(stored_region_map->ds_badge));
+			result.insert(new (_arena) Ref_badge(stored_region_map->ds_badge));
 
 			stored_region_map = stored_region_map->next();
 		}
@@ -88,6 +85,18 @@ void Restorer::_identify_recreate_pd_sessions(Pd_root &pd_root, Genode::List<Sto
 		{
 			// Identify bootstrapped PD session
 			pd_session = bootstrapped_pd_session;
+
+			// Without bootstrap, the child did not receive the capabilities of its PD session
+			if(_child._without_bootstrap)
+			{
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_pd_session->kcap, pd_session->cap()));
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(
+						stored_pd_session->stored_address_space.kcap, pd_session->address_space_component().cap()));
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(
+						stored_pd_session->stored_stack_area.kcap, pd_session->stack_area_component().cap()));
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(
+						stored_pd_session->stored_linker_area.kcap, pd_session->linker_area_component().cap()));
+			}
 		}
 		else
 		{
@@ -102,30 +111,24 @@ void Restorer::_identify_recreate_pd_sessions(Pd_root &pd_root, Genode::List<Sto
 				throw Genode::Exception();
 			}
 			// Store kcap for the badge of the newly created RPC object
-			_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_pd_session->kcap, pd_session->cap()));
+			_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_pd_session->kcap, pd_session->cap()));
 		}
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_pd_session->badge, pd_session->cap()));
+		_translate(stored_pd_session->badge, pd_session->cap());
 
 		_identify_recreate_signal_sources(*pd_session, stored_pd_session->stored_source_infos);
 		_identify_recreate_signal_contexts(*pd_session, stored_pd_session->stored_context_infos);
 		// XXX postpone native caps creation, because it needs capabilities from CPU thread
 
-		// Insert region map cap and region map's dataspace cap into _ckpt_to_resto_infos for all three region maps of a PD session
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(
-				stored_pd_session->stored_address_space.badge, pd_session->address_space_component().cap()));
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(
-				stored_pd_session->stored_address_space.ds_badge, pd_session->address_space_component().parent_state().ds_cap));
+		// Translate region map cap and region map's dataspace cap for all three region maps of a PD session
+		_translate(stored_pd_session->stored_address_space.badge, pd_session->address_space_component().cap());
+		_translate(stored_pd_session->stored_address_space.ds_badge, pd_session->address_space_component().parent_state().ds_cap);
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(
-				stored_pd_session->stored_stack_area.badge, pd_session->stack_area_component().cap()));
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(
-				stored_pd_session->stored_stack_area.ds_badge, pd_session->stack_area_component().parent_state().ds_cap));
+		_translate(stored_pd_session->stored_stack_area.badge, pd_session->stack_area_component().cap());
+		_translate(stored_pd_session->stored_stack_area.ds_badge, pd_session->stack_area_component().parent_state().ds_cap);
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(
-				stored_pd_session->stored_linker_area.badge, pd_session->linker_area_component().cap()));
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(
-				stored_pd_session->stored_linker_area.ds_badge, pd_session->linker_area_component().parent_state().ds_cap));
+		_translate(stored_pd_session->stored_linker_area.badge, pd_session->linker_area_component().cap());
+		_translate(stored_pd_session->stored_linker_area.ds_badge, pd_session->linker_area_component().parent_state().ds_cap);
 
 		stored_pd_session = stored_pd_session->next();
 	}
@@ -139,19 +142,20 @@ void Restorer::_identify_recreate_signal_sources(Pd_session_component &pd_sessio
 	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
 
 	// There shall be only one signal source by now (created by bootstrap)
+	// Without bootstrap, there is none and the bootstrapped signal source is recreated
 	Signal_source_info *bootstrapped_info = pd_session.parent_state().signal_sources.first();
-	if(!bootstrapped_info)
+	if(!bootstrapped_info && !_child._without_bootstrap)
 	{
 		Genode::error("There is no bootstrapped Signal source info");
 		throw Genode::Exception();
 	}
-	if(bootstrapped_info->next()) Genode::warning("There are more than 1 bootstrapped PD sessions");
+	if(bootstrapped_info && bootstrapped_info->next()) Genode::warning("There are more than 1 bootstrapped PD sessions");
 
 	Signal_source_info *signal_source = nullptr;
 	Stored_signal_source_info *stored_signal_source = stored_signal_sources.first();
 	while(stored_signal_source)
 	{
-		if(stored_signal_source->bootstrapped)
+		if(stored_signal_source->bootstrapped && bootstrapped_info)
 		{
 			// Identify bootstrapped signal source
 			signal_source = bootstrapped_info;
@@ -168,10 +172,10 @@ void Restorer::_identify_recreate_signal_sources(Pd_session_component &pd_sessio
 				throw Genode::Exception();
 			}
 			// Store kcap for the badge of the newly created RPC object
-			_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_signal_source->kcap, signal_source->cap));
+			_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_signal_source->kcap, signal_source->cap));
 		}
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_signal_source->badge, signal_source->cap));
+		_translate(stored_signal_source->badge, signal_source->cap);
 
 		stored_signal_source = stored_signal_source->next();
 	}
@@ -195,8 +199,7 @@ void Restorer::_identify_recreate_signal_contexts(Pd_session_component &pd_sessi
 		Genode::Capability<Genode::Signal_source> ss_cap;
 		if(stored_signal_context->signal_source_badge != 0)
 		{
-			Ckpt_resto_badge_info *info = _ckpt_to_resto_infos.first();
-			if(info) info = info->find_by_ckpt_badge(stored_signal_context->signal_source_badge);
+			Ckpt_resto_badge_info *info = _find_translation(stored_signal_context->signal_source_badge);
 			ss_cap = Genode::reinterpret_cap_cast<Genode::Signal_source>(info->resto_cap);
 		}
 
@@ -209,9 +212,9 @@ void Restorer::_identify_recreate_signal_contexts(Pd_session_component &pd_sessi
 			throw Genode::Exception();
 		}
 		// Store kcap for the badge of the newly created RPC object
-		_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_signal_context->kcap, signal_context->cap));
+		_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_signal_context->kcap, signal_context->cap));
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_signal_context->badge, signal_context->cap));
+		_translate(stored_signal_context->badge, signal_context->cap);
 
 		stored_signal_context = stored_signal_context->next();
 	}
@@ -241,6 +244,9 @@ void Restorer::_identify_recreate_ram_sessions(Ram_root &ram_root, Genode::List<
 		{
 			// Identify bootstrapped RAM session
 			ram_session = bootstrapped_ram_session;
+
+			if(_child._without_bootstrap)
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_ram_session->kcap, ram_session->cap()));
 		}
 		else
 		{
@@ -255,10 +261,10 @@ void Restorer::_identify_recreate_ram_sessions(Ram_root &ram_root, Genode::List<
 				throw Genode::Exception();
 			}
 			// Store kcap for the badge of the newly created RPC object
-			_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_ram_session->kcap, ram_session->cap()));
+			_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_ram_session->kcap, ram_session->cap()));
 		}
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_ram_session->badge, ram_session->cap()));
+		_translate(stored_ram_session->badge, ram_session->cap());
 
 		_identify_recreate_ram_dataspaces(*ram_session, stored_ram_session->stored_ramds_infos);
 
@@ -273,19 +279,24 @@ void Restorer::_identify_recreate_ram_dataspaces(Ram_session_component &ram_sess
 	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
 
 	// There shall be at least 1 RAM dataspace by now (created by bootstrap)
-	Genode::List<Ckpt_resto_badge_info> bootstrapped_ram_dataspaces =
-			_identify_ram_dataspaces(ram_session.parent_state().ram_dataspaces, stored_ram_dataspaces);
-	if(!bootstrapped_ram_dataspaces.first())
+	// Without bootstrap, there is none and all RAM dataspaces are recreated
+	Genode::List<Ckpt_resto_badge_info> bootstrapped_ram_dataspaces;
+	if(!_child._without_bootstrap)
 	{
-		Genode::error("There is no bootstrapped RAM dataspace");
-		throw Genode::Exception();
+		bootstrapped_ram_dataspaces =
+				_identify_ram_dataspaces(ram_session.parent_state().ram_dataspaces, stored_ram_dataspaces);
+		if(!bootstrapped_ram_dataspaces.first())
+		{
+			Genode::error("There is no bootstrapped RAM dataspace");
+			throw Genode::Exception();
+		}
 	}
 
 	Ram_dataspace_info *ramds = nullptr;
 	Stored_ram_dataspace_info *stored_ramds = stored_ram_dataspaces.first();
 	while(stored_ramds)
 	{
-		if(stored_ramds->bootstrapped)
+		if(stored_ramds->bootstrapped && !_child._without_bootstrap)
 		{
 			// Identify
 			Ckpt_resto_badge_info *cr_info = bootstrapped_ram_dataspaces.first();
@@ -310,10 +321,10 @@ void Restorer::_identify_recreate_ram_dataspaces(Ram_session_component &ram_sess
 				throw Genode::Exception();
 			}
 			// Store kcap for the badge of the newly created RPC object
-			_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_ramds->kcap, ramds->cap));
+			_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_ramds->kcap, ramds->cap));
 		}
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_ramds->badge, ramds->cap));
+		_translate(stored_ramds->badge, ramds->cap);
 
 		stored_ramds = stored_ramds->next();
 	}
@@ -322,7 +333,7 @@ void Restorer::_identify_recreate_ram_dataspaces(Ram_session_component &ram_sess
 	while(Ckpt_resto_badge_info *info = bootstrapped_ram_dataspaces.first())
 	{
 		bootstrapped_ram_dataspaces.remove(info);
-		Genode::destroy(_alloc, info);
+		Genode::destroy(_arena, info);
 	}
 }
 
@@ -389,7 +400,7 @@ Genode::List<Ckpt_resto_badge_info> Restorer::_identify_ram_dataspaces(
 		stored_ramds = stored_ram_dataspaces.first()->find_by_timestamp(stored_array[i]);
 		ramds = ram_dataspaces.first()->find_by_timestamp(array[i]);
 
-		result.insert(new (_alloc) Ckpt_resto_badge_info(stored_ramds->badge, ramds->cap));
+		result.insert(new (_arena) Ckpt_resto_badge_info(stored_ramds->badge, ramds->cap));
 	}
 
 	return result;
@@ -421,6 +432,9 @@ void Restorer::_identify_recreate_cpu_sessions(Cpu_root &cpu_root, Genode::List<
 			// Identify
 			cpu_session = bootstrapped_cpu_session;
 
+			if(_child._without_bootstrap)
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_cpu_session->kcap, cpu_session->cap()));
+
 		}
 		else
 		{
@@ -435,10 +449,10 @@ void Restorer::_identify_recreate_cpu_sessions(Cpu_root &cpu_root, Genode::List<
 				throw Genode::Exception();
 			}
 			// Store kcap for the badge of the newly created RPC object
-			_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_cpu_session->kcap, cpu_session->cap()));
+			_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_cpu_session->kcap, cpu_session->cap()));
 		}
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_cpu_session->badge, cpu_session->cap()));
+		_translate(stored_cpu_session->badge, cpu_session->cap());
 
 		_identify_recreate_cpu_threads(*cpu_session, stored_cpu_session->stored_cpu_thread_infos, pd_sessions);
 
@@ -455,27 +469,31 @@ void Restorer::_identify_recreate_cpu_threads(Cpu_session_component &cpu_session
 
 	// There shall be only 3 CPU threads by now (created by bootstrap)
 
+	// Without bootstrap, there is only the initial thread, which was not started;
+	// the other bootstrapped threads are recreated
 	Cpu_thread_component *cpu_thread = nullptr;
 	Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_threads.first();
 	while(stored_cpu_thread)
 	{
+		cpu_thread = nullptr;
 		if(stored_cpu_thread->bootstrapped)
 		{
 			// Identify
 			cpu_thread = cpu_session.parent_state().cpu_threads.first();
 			if(cpu_thread) cpu_thread = cpu_thread->find_by_name(stored_cpu_thread->name.string());
-			if(!cpu_thread)
+			if(!cpu_thread && !_child._without_bootstrap)
 			{
 				Genode::error("Could not find bootstrapped CPU thread for name=", stored_cpu_thread->name);
 				throw Genode::Exception();
 			}
+			if(cpu_thread && _child._without_bootstrap)
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_cpu_thread->kcap, cpu_thread->cap()));
 		}
-		else
+		if(!cpu_thread)
 		{
 			// Recreate
 			// First, find translation of PD session badge used for creating the CPU thread
-			Ckpt_resto_badge_info *cr_info = _ckpt_to_resto_infos.first();
-			if(cr_info) cr_info = cr_info->find_by_ckpt_badge(stored_cpu_thread->pd_session_badge);
+			Ckpt_resto_badge_info *cr_info = _find_translation(stored_cpu_thread->pd_session_badge);
 			if(!cr_info)
 			{
 				Genode::error("Could not find translation for stored PD session badge=", stored_cpu_thread->pd_session_badge);
@@ -501,10 +519,10 @@ void Restorer::_identify_recreate_cpu_threads(Cpu_session_component &cpu_session
 				throw Genode::Exception();
 			}
 			// Store kcap for the badge of the newly created RPC object
-			_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_cpu_thread->kcap, cpu_thread->cap()));
+			_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_cpu_thread->kcap, cpu_thread->cap()));
 		}
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_cpu_thread->badge, cpu_thread->cap()));
+		_translate(stored_cpu_thread->badge, cpu_thread->cap());
 
 		stored_cpu_thread = stored_cpu_thread->next();
 	}
@@ -535,9 +553,9 @@ void Restorer::_identify_recreate_rm_sessions(Rm_root &rm_root, Genode::List<Sto
 			throw Genode::Exception();
 		}
 		// Store kcap for the badge of the newly created RPC object
-		_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_rm_session->kcap, rm_session->cap()));
+		_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_rm_session->kcap, rm_session->cap()));
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_rm_session->badge, rm_session->cap()));
+		_translate(stored_rm_session->badge, rm_session->cap());
 
 		_identify_recreate_region_maps(*rm_session, stored_rm_session->stored_region_map_infos);
 
@@ -570,12 +588,12 @@ void Restorer::_identify_recreate_region_maps(
 			throw Genode::Exception();
 		}
 		// Store kcap for the badge of the newly created RPC object
-		_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_region_map->kcap, region_map->cap()));
+		_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_region_map->kcap, region_map->cap()));
 
 		// Insert region map badge/cap
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_region_map->badge, region_map->cap()));
+		_translate(stored_region_map->badge, region_map->cap());
 		// Insert region map's dataspace badge/cap for _restore_state_attached_regions
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_region_map->ds_badge, region_map->parent_state().ds_cap));
+		_translate(stored_region_map->ds_badge, region_map->parent_state().ds_cap);
 
 
 		stored_region_map = stored_region_map->next();
@@ -607,9 +625,9 @@ void Restorer::_identify_recreate_log_sessions(Log_root &log_root, Genode::List<
 			throw Genode::Exception();
 		}
 		// Store kcap for the badge of the newly created RPC object
-		_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_log_session->kcap, log_session->cap()));
+		_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_log_session->kcap, log_session->cap()));
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_log_session->badge, log_session->cap()));
+		_translate(stored_log_session->badge, log_session->cap());
 
 		stored_log_session = stored_log_session->next();
 	}
@@ -640,9 +658,9 @@ void Restorer::_identify_recreate_timer_sessions(Timer_root &timer_root, Genode:
 			throw Genode::Exception();
 		}
 		// Store kcap for the badge of the newly created RPC object
-		_capability_map_infos.insert(new (_alloc) Cap_kcap_info(stored_timer_session->kcap, timer_session->cap()));
+		_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_timer_session->kcap, timer_session->cap()));
 
-		_ckpt_to_resto_infos.insert(new (_alloc) Ckpt_resto_badge_info(stored_timer_session->badge, timer_session->cap()));
+		_translate(stored_timer_session->badge, timer_session->cap());
 
 		stored_timer_session = stored_timer_session->next();
 	}
@@ -728,10 +746,13 @@ void Restorer::_restore_state_ram_dataspaces(
 		}
 
 		// Restore state
-		// Postpone memory copy to a latter time
-		Orig_copy_resto_info *info = new (_alloc) Orig_copy_resto_info(
-				ram_dataspace->cap, stored_ram_dataspace->memory_content, 0, stored_ram_dataspace->size);
-		_memory_to_restore.insert(info);
+		// Postpone memory copy to a latter time; with a restore plan, the plan's copy extents are used
+		if(!_plan)
+		{
+			Orig_copy_resto_info *info = new (_arena) Orig_copy_resto_info(
+					ram_dataspace->cap, stored_ram_dataspace->memory_content, 0, stored_ram_dataspace->size);
+			_memory_to_restore.insert(info);
+		}
 
 		stored_ram_dataspace = stored_ram_dataspace->next();
 	}
@@ -841,12 +862,14 @@ void Restorer::_restore_state_cpu_threads(Cpu_session_component &cpu_session, Ge
 		{
 			cpu_thread->single_step(true);
 		}
-		// Thread state
-		cpu_thread->state(stored_cpu_thread->ts);
+		// Thread state; written for all threads at once after the loop
+		cpu_session.stage_thread_state(*cpu_thread, stored_cpu_thread->ts);
 
 
 		stored_cpu_thread = stored_cpu_thread->next();
 	}
+
+	cpu_session.commit_thread_states();
 }
 
 
@@ -934,7 +957,8 @@ void Restorer::_restore_state_attached_regions(Region_map_component &region_map,
 		Attached_region_info *attached_region = nullptr;
 
 		// Find corresponding attached region by the position in the region map or recreate it
-		if(stored_attached_region->bootstrapped)
+		// Without bootstrap, the region maps are empty and all attached regions are recreated
+		if(stored_attached_region->bootstrapped && !_child._without_bootstrap)
 		{
 			// Identify
 			attached_region = region_map.parent_state().attached_regions.first();
@@ -953,8 +977,7 @@ void Restorer::_restore_state_attached_regions(Region_map_component &region_map,
 			// (e.g. dataspaces from RAM sessions, region map's dataspaces),
 			// still there could be attached dataspaces whose origin is unknown and, thus, shall be allocated here
 			Genode::Dataspace_capability ds_cap;
-			Ckpt_resto_badge_info *cr_info = _ckpt_to_resto_infos.first();
-			if(cr_info) cr_info = cr_info->find_by_ckpt_badge(stored_attached_region->attached_ds_badge);
+			Ckpt_resto_badge_info *cr_info = _find_translation(stored_attached_region->attached_ds_badge);
 			if(cr_info)
 			{
 				ds_cap = Genode::reinterpret_cap_cast<Genode::Dataspace>(cr_info->resto_cap);
@@ -964,8 +987,7 @@ void Restorer::_restore_state_attached_regions(Region_map_component &region_map,
 				ds_cap = _child._env.ram().alloc(stored_attached_region->size);
 
 				// Store kcap for the badge of the newly created RPC object
-				_capability_map_infos.insert(new (_alloc) Cap_kcap_info(
-						stored_attached_region->kcap, attached_region->attached_ds_cap));
+				_capability_map_infos.insert(new (_arena) Cap_kcap_info(stored_attached_region->kcap, ds_cap));
 			}
 
 			region_map.attach(ds_cap, stored_attached_region->size, stored_attached_region->offset,
@@ -981,11 +1003,14 @@ void Restorer::_restore_state_attached_regions(Region_map_component &region_map,
 			}
 		}
 
+		// Dataspaces of unknown origin are translated by their attachment
+		if(!_find_translation(stored_attached_region->attached_ds_badge))
+			_translate(stored_attached_region->attached_ds_badge, attached_region->attached_ds_cap);
+
 		// Find out whether the attached region's memory needs to be restored
 		// Find out whether the attached region is a known region map (do not remember region maps)
-		Ref_badge *badge = _region_map_dataspaces_from_stored.first();
-		if(badge) badge = badge->find_by_badge(stored_attached_region->attached_ds_badge);
-		if(!badge)
+		// With a restore plan, the memory to restore is taken from the plan's copy extents
+		if(!_plan && !_region_map_dataspace(stored_attached_region->attached_ds_badge))
 		{
 			// Find out whether the cap is already in memory to restore (only add new dataspaces)
 			Orig_copy_resto_info *info = _memory_to_restore.first();
@@ -993,7 +1018,7 @@ void Restorer::_restore_state_attached_regions(Region_map_component &region_map,
 			if(!info)
 			{
 				// If not in list, then insert it
-				info = new (_alloc) Orig_copy_resto_info(
+				info = new (_arena) Orig_copy_resto_info(
 						attached_region->attached_ds_cap, stored_attached_region->memory_content, 0, stored_attached_region->size);
 				_memory_to_restore.insert(info);
 			}
@@ -1098,16 +1123,29 @@ void Restorer::_resolve_inc_checkpoint_dataspaces(
 					memory_infos.remove(memory_info);
 
 					Designated_dataspace_info *dd_info = ramds_info->mrm_info->dd_infos.first();
-					if(dd_info && dd_info->attached)
+					while(dd_info)
 					{
-						Orig_copy_resto_info *new_oc_info = new (_alloc) Orig_copy_resto_info(dd_info->cap,
-								memory_info->copy_ds_cap, dd_info->rel_addr, dd_info->size);
-						memory_infos.insert(new_oc_info);
+						if(_memory_restore == ON_FIRST_ACCESS)
+						{
+							// The page fault handler copies the content on the first access
+							dd_info->restore_ds_cap = memory_info->copy_ds_cap;
+							dd_info->restore_offset = dd_info->rel_addr;
+						}
+						else if(dd_info->attached)
+						{
+							Orig_copy_resto_info *new_oc_info = new (_arena) Orig_copy_resto_info(dd_info->cap,
+									memory_info->copy_ds_cap, dd_info->rel_addr, dd_info->size);
+							memory_infos.insert(new_oc_info);
+						}
 
 						dd_info = dd_info->next();
 					}
 
-					Genode::destroy(_alloc, memory_info);
+					// Let the first access of each designated dataspace fault
+					if(_memory_restore == ON_FIRST_ACCESS)
+						ramds_info->mrm_info->detach_designated_dataspaces(_state._env.pd().native_pd());
+
+					Genode::destroy(_arena, memory_info);
 				}
 
 			}
@@ -1130,8 +1168,27 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 
 	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
 
-	addr_t child_cap_idx_alloc_addr = Genode::Foc_native_pd_client(child.pd().native_pd()).cap_map_info();
-	addr_t state_cap_idx_alloc_addr = state._cap_idx_alloc_addr;
+	// Layouts of the capability maps of the child and of the checkpointed child
+	Cap_map_layout const child_layout = cap_map_layout(child.pd().native_pd());
+	Cap_map_layout state_layout = state._cap_map_layout;
+	if(!state_layout.num_slots)
+	{
+		// Checkpoint without layout information: assume the child's layout at the stored address
+		state_layout             = child_layout;
+		state_layout.struct_addr = state._cap_idx_alloc_addr;
+		state_layout.array_addr  = state._cap_idx_alloc_addr + (child_layout.array_addr - child_layout.struct_addr);
+	}
+	if(state_layout.num_slots != child_layout.num_slots || state_layout.element_size != child_layout.element_size
+			|| state_layout.badge_offset != child_layout.badge_offset)
+	{
+		Genode::error("Capability map layouts of child and checkpoint differ: ",
+				child_layout.num_slots, "x", child_layout.element_size, " vs. ",
+				state_layout.num_slots, "x", state_layout.element_size);
+		throw Genode::Exception();
+	}
+
+	addr_t child_cap_idx_alloc_addr = child_layout.struct_addr;
+	addr_t state_cap_idx_alloc_addr = state_layout.struct_addr;
 	//log("Cap_idx_alloc: child addr=", Hex(child_cap_idx_alloc_addr), ", state addr=", Hex(state_cap_idx_alloc_addr));
 
 	// Find attached region containing child's cap_idx_alloc struct
@@ -1164,9 +1221,10 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 		}
 	}
 
-	size_t const struct_size    = sizeof(Genode::Cap_index_allocator_tpl<Genode::Cap_index,4096>);
-	size_t const array_ele_size = sizeof(Genode::Cap_index);
-	size_t const array_size     = array_ele_size*4096;
+	size_t const array_ele_size = child_layout.element_size;
+	size_t const num_slots      = child_layout.num_slots;
+	size_t const array_size     = array_ele_size*num_slots;
+	size_t const struct_size    = (child_layout.array_addr - child_layout.struct_addr) + array_size;
 
 	/**
 	 * Array element layout as a list element (Changed from AVL node)
@@ -1180,27 +1238,29 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 	 * r_cnt        is a number counting the references of the Cap_index
 	 * res          is padding
 	 * badge        is the system global identifier for Cap_indices
+	 *
+	 * The offsets of r_cnt and badge are taken from the reported layout.
 	 */
 
 	addr_t const remote_child_ds_start = attached_region->rel_addr;
 	addr_t const remote_child_ds_end   = remote_child_ds_start + attached_region->size;
 	addr_t const remote_child_struct_start = child_cap_idx_alloc_addr;
 	addr_t const remote_child_struct_end   = remote_child_struct_start + struct_size;
-	addr_t const remote_child_array_start = remote_child_struct_start + 8;
+	addr_t const remote_child_array_start = child_layout.array_addr;
 	addr_t const remote_child_array_end   = remote_child_array_start + array_size;
 
 	addr_t const local_child_ds_start = state._env.rm().attach(attached_region->attached_ds_cap);
 	addr_t const local_child_ds_end   = local_child_ds_start + attached_region->size;
 	addr_t const local_child_struct_start = local_child_ds_start + (remote_child_struct_start - remote_child_ds_start);
 	addr_t const local_child_struct_end   = local_child_struct_start + struct_size;
-	addr_t const local_child_array_start = local_child_struct_start + 8;
+	addr_t const local_child_array_start = local_child_ds_start + (remote_child_array_start - remote_child_ds_start);
 	addr_t const local_child_array_end   = local_child_array_start + array_size;
 
 	addr_t const local_state_ds_start = state._env.rm().attach(stored_attached_region->memory_content);
 	addr_t const local_state_ds_end   = local_state_ds_start + stored_attached_region->size;
 	addr_t const local_state_struct_start = local_state_ds_start + (state_cap_idx_alloc_addr - remote_child_ds_start);
 	addr_t const local_state_struct_end   = local_state_struct_start + struct_size;
-	addr_t const local_state_array_start = local_state_struct_start + 8;
+	addr_t const local_state_array_start = local_state_ds_start + (state_layout.array_addr - remote_child_ds_start);
 	addr_t const local_state_array_end   = local_state_array_start + array_size;
 
 	if(verbose_debug)
@@ -1235,13 +1295,15 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 
 	// Replace badges and list pointers in state
 	{
-		// Find Cap_index with valid list pointer where the new Cap_indices will be attached to
+		// Find Cap_index with valid list pointer where the new Cap_indices will be attached to;
+		// it is searched among the first slots after the reserved ones, which are used since the
+		// startup of the child. The list pointer is the first word of a Cap_index
+		addr_t const anchor_first = child_layout.user_slot;
+		addr_t const anchor_end   = Genode::min(anchor_first + CAP_MAP_ANCHOR_SLOTS, num_slots);
 		addr_t previous_cap_index = 0;
-		for(unsigned cap_index = 0x200; cap_index < 0x280; ++cap_index)
+		for(addr_t cap_index = anchor_first; cap_index < anchor_end; ++cap_index)
 		{
-			addr_t const current_pos = local_state_array_start + cap_index*array_ele_size;
-			//log("offset=", Hex(offset), ": ", Hex(*(Genode::uint32_t*) current_pos));
-			if(*(Genode::uint32_t*) current_pos)
+			if(*(addr_t*)(local_state_array_start + cap_index*array_ele_size))
 			{
 				previous_cap_index = cap_index;
 				break;
@@ -1259,7 +1321,7 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 			else
 			{
 				addr_t const previous_pos = local_state_array_start + previous_cap_index*array_ele_size;
-				addr_t const current_cap_index = cap_info->kcap >> 12;
+				addr_t const current_cap_index = Cap_map_scanner::slot(cap_info->kcap);
 				addr_t const current_pos = local_state_array_start + current_cap_index*array_ele_size;
 
 				// Sanity check: Check whether the addresses point to the local array
@@ -1279,20 +1341,20 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 				//dump_mem((void*)current_pos, 8);
 				//dump_mem((void*)previous_pos, 8);
 
-				if(*(Genode::uint16_t*) (current_pos+6))
+				if(*(Genode::uint16_t*) (current_pos + child_layout.badge_offset))
 				{
 					Genode::warning("Overriding existing badge at cap_index=", Hex(current_cap_index));
 				}
 
 				// Insert List pointer, thus, current points to next
-				*(Genode::uint32_t*) current_pos = *(Genode::uint32_t*)previous_pos;
+				*(addr_t*) current_pos = *(addr_t*)previous_pos;
 				// Insert ref_count
-				*(Genode::uint8_t*) (current_pos+4) = 2;
+				*(Genode::uint8_t*) (current_pos + child_layout.ref_cnt_offset) = 2;
 				// Insert badge
-				*(Genode::uint16_t*) (current_pos+6) = cap_info->cap.local_name();
+				*(Genode::uint16_t*) (current_pos + child_layout.badge_offset) = cap_info->cap.local_name();
 
 				// Insert List pointer, thus, previous points to current
-				*(Genode::uint32_t*) previous_pos = remote_child_array_start + current_cap_index*array_ele_size;
+				*(addr_t*) previous_pos = remote_child_array_start + current_cap_index*array_ele_size;
 
 				// State now: previous -> current -> next
 				//log("\nAfter:");
@@ -1313,10 +1375,122 @@ void Restorer::_restore_cap_map(Target_child &child, Target_state &state)
 }
 
 
+void Restorer::_translate_cap_map(Target_child &child, Target_state &state)
+{
+	using Genode::size_t;
+	using Genode::addr_t;
+	using Genode::uint16_t;
+
+	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
+
+	// Without bootstrap, the child did not report a layout; it is the layout of the checkpointed child
+	Cap_map_layout const layout = state._cap_map_layout.num_slots ? state._cap_map_layout
+			: default_cap_map_layout(state._cap_idx_alloc_addr);
+
+	// Find attached region containing child's cap_idx_alloc struct
+	Attached_region_info *attached_region = child.pd().address_space_component().parent_state().attached_regions.first();
+	if(attached_region) attached_region = attached_region->find_by_addr(layout.struct_addr);
+	if(!attached_region)
+	{
+		Genode::error("Could not find child's dataspace containing the cap_idx_alloc struct with the address ",
+				Genode::Hex(layout.struct_addr));
+		throw Genode::Exception();
+	}
+
+	// The content of the dataspace is already restored (or is restored on the first access)
+	addr_t const local_ds_start    = state._env.rm().attach(attached_region->attached_ds_cap);
+	addr_t const local_array_start = local_ds_start + (layout.array_addr - attached_region->rel_addr);
+
+	// The parent capability is installed by core at a fixed slot
+	size_t const parent_slot = Cap_map_scanner::slot(Fiasco::PARENT_CAP);
+
+	unsigned untranslated = 0;
+	for(size_t slot = 0; slot < layout.num_slots; slot++)
+	{
+		uint16_t *badge = (uint16_t*)(local_array_start + slot*layout.element_size + layout.badge_offset);
+		if(!*badge) continue;
+
+		if(slot == parent_slot)
+		{
+			*badge = child._child->parent_cap().local_name();
+			continue;
+		}
+
+		Ckpt_resto_badge_info *cr_info = _find_translation(*badge);
+		if(cr_info) *badge = cr_info->resto_cap.local_name();
+		else untranslated++;
+	}
+
+	state._env.rm().detach(local_ds_start);
+
+	if(untranslated) Genode::warning(untranslated, " capabilities of the child are not known to the restorer");
+}
+
+
+void Restorer::_start_cpu_threads(Cpu_root &cpu_root, Genode::List<Stored_cpu_session_info> &stored_cpu_sessions)
+{
+	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
+
+	Stored_cpu_session_info *stored_cpu_session = stored_cpu_sessions.first();
+	while(stored_cpu_session)
+	{
+		Cpu_session_component *cpu_session = _find_child_object(stored_cpu_session->badge, cpu_root.session_infos());
+		if(!cpu_session)
+		{
+			Genode::error("Could not find child CPU session for ckpt badge ", stored_cpu_session->badge);
+			throw Genode::Exception();
+		}
+
+		Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_session->stored_cpu_thread_infos.first();
+		while(stored_cpu_thread)
+		{
+			Cpu_thread_component *cpu_thread =
+					_find_child_object(stored_cpu_thread->badge, cpu_session->parent_state().cpu_threads);
+			if(!cpu_thread)
+			{
+				Genode::error("Could not find child CPU thread for ckpt badge ", stored_cpu_thread->badge);
+				throw Genode::Exception();
+			}
+
+			// The remaining registers were written by _restore_state_cpu_threads
+			if(stored_cpu_thread->started && !cpu_thread->parent_state().started)
+				cpu_thread->start(stored_cpu_thread->ts.ip, stored_cpu_thread->ts.sp);
+
+			stored_cpu_thread = stored_cpu_thread->next();
+		}
+
+		stored_cpu_session = stored_cpu_session->next();
+	}
+}
+
+
+void Restorer::_install_batch(Genode::Foc_native_pd_client &native_pd,
+		Genode::Foc_native_pd::Install_batch &batch, Cap_kcap_info **batch_infos)
+{
+	Genode::Native_capability caps[Genode::Foc_native_pd::Install_batch::MAX_ENTRIES];
+	for(unsigned i = 0; i < batch.count; i++) caps[i] = batch_infos[i]->cap;
+
+	native_pd.install_batch(batch, caps[0], caps[1], caps[2], caps[3]);
+
+	// Install capabilities one by one, which core could not install from the batch
+	for(unsigned i = 0; i < batch.count; i++)
+	{
+		if(!batch.entries[i].installed)
+			native_pd.install(batch_infos[i]->cap, batch_infos[i]->kcap);
+	}
+
+	batch = Genode::Foc_native_pd::Install_batch();
+}
+
+
 void Restorer::_restore_cap_space(Target_child &child)
 {
 	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
 
+	Genode::Foc_native_pd_client native_pd(child.pd().native_pd());
+	Genode::Foc_native_pd::Install_batch batch;
+	Cap_kcap_info *batch_infos[Genode::Foc_native_pd::Install_batch::MAX_ENTRIES];
+
 	Cap_kcap_info *ck_info = _capability_map_infos.first();
 	while(ck_info)
 	{
@@ -1326,12 +1500,17 @@ void Restorer::_restore_cap_space(Target_child &child)
 		}
 		else
 		{
-			// Install capabilities to the child's cap space
-			Genode::Foc_native_pd_client(child.pd().native_pd()).install(ck_info->cap, ck_info->kcap);
+			// Install capabilities to the child's cap space in batches
+			batch_infos[batch.count] = ck_info;
+			batch.add(ck_info->kcap);
+
+			if(batch.full()) _install_batch(native_pd, batch, batch_infos);
 		}
 
 		ck_info = ck_info->next();
 	}
+
+	if(batch.count) _install_batch(native_pd, batch, batch_infos);
 }
 
 
@@ -1351,6 +1530,9 @@ void Restorer::_restore_dataspaces(Genode::List<Orig_copy_resto_info> &memory_in
 
 		memory_info = memory_info->next();
 	}
+
+	// Copy the queued content with all workers
+	_copy.run();
 }
 
 
@@ -1361,26 +1543,128 @@ void Restorer::_restore_dataspace_content(Genode::Dataspace_capability orig_ds_c
 			", copy ", copy_ds_cap, ", copy_rel_addr=", Genode::Hex(copy_rel_addr),
 			", copy_size=", Genode::Hex(copy_size), ")");
 
-	char *orig = _state._env.rm().attach(orig_ds_cap);
-	char *copy = _state._env.rm().attach(copy_ds_cap);
+	// The stored copy is read by every restore of this Target_state, thus, its mapping is kept
+	_copy.copy(orig_ds_cap, 0, copy_ds_cap, copy_rel_addr, copy_size, true);
+}
+
+
+void Restorer::_translate(Genode::uint16_t ckpt_badge, Genode::Native_capability resto_cap)
+{
+	Ckpt_resto_badge_info *info = new (_arena) Ckpt_resto_badge_info(ckpt_badge, resto_cap);
+	_ckpt_to_resto_infos.insert(info);
+
+	if(_translations)
+	{
+		unsigned const index = _plan->index(ckpt_badge);
+		if(index != Restore_plan::INVALID_INDEX) _translations[index] = info;
+	}
+}
+
+
+Ckpt_resto_badge_info *Restorer::_find_translation(Genode::uint16_t ckpt_badge)
+{
+	if(_translations)
+	{
+		unsigned const index = _plan->index(ckpt_badge);
+		if(index != Restore_plan::INVALID_INDEX) return _translations[index];
+	}
+
+	Ckpt_resto_badge_info *info = _ckpt_to_resto_infos.first();
+	return info ? info->find_by_ckpt_badge(ckpt_badge) : nullptr;
+}
+
+
+bool Restorer::_region_map_dataspace(Genode::uint16_t ckpt_badge)
+{
+	if(_plan) return _plan->region_map_dataspace(ckpt_badge);
+
+	Ref_badge *badge = _region_map_dataspaces_from_stored.first();
+	return badge && badge->find_by_badge(ckpt_badge);
+}
+
+
+void Restorer::_preallocate_quota()
+{
+	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
+
+	Genode::Ram_session_client child_ram(_child.ram().parent_cap());
+	Genode::size_t const avail = child_ram.avail();
+	if(_plan->ram_quota() <= avail) return;
+
+	Genode::size_t const amount = _plan->ram_quota() - avail;
+	if(_child._env.ram().transfer_quota(_child.ram().parent_cap(), amount))
+		Genode::warning("Could not preallocate RAM quota of ", Genode::Hex(amount), " for the child");
+}
+
+
+void Restorer::_plan_memory_to_restore()
+{
+	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m(...)");
 
-	Genode::memcpy(copy + copy_rel_addr, orig, copy_size);
+	for(unsigned i = 0; i < _plan->num_extents(); i++)
+	{
+		Restore_plan::Copy_extent const &extent = _plan->extent(i);
+
+		Ckpt_resto_badge_info *cr_info = _find_translation(extent.ds_badge);
+		if(!cr_info)
+		{
+			Genode::warning("Could not find child dataspace for ckpt badge ", extent.ds_badge);
+			continue;
+		}
 
-	_state._env.rm().detach(copy);
-	_state._env.rm().detach(orig);
+		_memory_to_restore.insert(new (_arena) Orig_copy_resto_info(
+				Genode::reinterpret_cap_cast<Genode::Dataspace>(cr_info->resto_cap), extent.content, 0, extent.size));
+	}
 }
 
 
-Restorer::Restorer(Genode::Allocator &alloc, Target_child &child, Target_state &state)
-: _alloc(alloc), _child(child), _state(state) { }
+Restorer::Restorer(Genode::Allocator &alloc, Target_child &child, Target_state &state,
+		Parallel_copy::Config const &copy_config, Memory_restore memory_restore, Restore_plan const *plan,
+		Parallel_copy *copy)
+:
+	_alloc(alloc), _arena(alloc), _child(child), _state(state),
+	_own_copy(copy ? nullptr : new (alloc) Parallel_copy(state._env, alloc, copy_config)),
+	_copy(copy ? *copy : *_own_copy), _copied_before(_copy.bytes_copied()),
+	_memory_restore(memory_restore), _plan(plan), _translations(nullptr), _deferred_start(false),
+	_phase_log(nullptr)
+{ }
 
 
 Restorer::~Restorer()
 {
+	if(_own_copy) Genode::destroy(_alloc, _own_copy);
+
 	_destroy_list(_capability_map_infos);
 	_destroy_list(_ckpt_to_resto_infos);
 	_destroy_list(_memory_to_restore);
-	_destroy_list(_region_map_dataspaces_from_stored);
+	_region_map_dataspaces_from_stored = Genode::List<Ref_badge>();
+}
+
+
+Genode::Native_capability Restorer::translation(Genode::uint16_t ckpt_badge)
+{
+	Ckpt_resto_badge_info *cr_info = _find_translation(ckpt_badge);
+	return cr_info ? cr_info->resto_cap : Genode::Native_capability();
+}
+
+
+void Restorer::start_deferred()
+{
+	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m()");
+
+	if(!_child._without_bootstrap)
+	{
+		Genode::warning("Child ", _child.name(), " was restored with bootstrap; its threads are already started");
+		return;
+	}
+
+	Phase_log::Timestamp t = Phase_log::now();
+	_translate_cap_map(_child, _state);
+	t = _phase(Phase_log::Phase_record::RESTORE_CAP_MAP, t);
+
+	// Start the threads, which were started in the checkpointed child
+	_start_cpu_threads(*_child.custom_services().cpu_root, _state._stored_cpu_sessions);
+	_phase(Phase_log::Phase_record::START_THREADS, t);
 }
 
 
@@ -1388,12 +1672,37 @@ void Restorer::restore()
 {
 	if(verbose_debug) Genode::log("Resto::\033[33m", __func__, "\033[0m()");
 
-	Genode::log("Before: \n", _child);
+	Phase_log::Timestamp t = Phase_log::now();
+
+	// Release the translations of the previous restore
+	_destroy_list(_ckpt_to_resto_infos);
+	_translations = nullptr;
+	_arena.reset();
+
+	if(verbose_debug) Genode::log("Before: \n", _child);
 
-	// Create a list of known region map's dataspace capabilities
-	// It is used to identify region maps which are attached to region maps
-	// when bookmarking dataspace content for restoration
-	_region_map_dataspaces_from_stored = _create_region_map_dataspaces(_state._stored_pd_sessions, _state._stored_rm_sessions);
+	if(_plan)
+	{
+		// Translate badges through the plan's dense index
+		Genode::size_t const size = _plan->num_badges()*sizeof(Ckpt_resto_badge_info*);
+		if(size && !_arena.alloc(size, (void**)&_translations))
+		{
+			Genode::error("Could not allocate translation table for ", _plan->num_badges(), " badges");
+			throw Genode::Exception();
+		}
+		if(_translations) Genode::memset(_translations, 0, size);
+
+		// Provide the quota for the recreated RAM dataspaces at once
+		_preallocate_quota();
+	}
+	else
+	{
+		// Create a list of known region map's dataspace capabilities
+		// It is used to identify region maps which are attached to region maps
+		// when bookmarking dataspace content for restoration
+		_region_map_dataspaces_from_stored = _create_region_map_dataspaces(_state._stored_pd_sessions, _state._stored_rm_sessions);
+	}
+	t = _phase(Phase_log::Phase_record::PREPARE_RESTORE, t);
 
 	if(verbose_debug)
 	{
@@ -1430,6 +1739,7 @@ void Restorer::restore()
 		_child.custom_services().find("Timer"); // Implicitly creates root object
 		_identify_recreate_timer_sessions(*_child.custom_services().timer_root, _state._stored_timer_sessions);
 	}
+	t = _phase(Phase_log::Phase_record::IDENTIFY_RECREATE, t, Phase_log::count(_ckpt_to_resto_infos));
 
 
 	if(verbose_debug)
@@ -1465,6 +1775,7 @@ void Restorer::restore()
 		_restore_state_timer_sessions(*_child.custom_services().timer_root, _state._stored_timer_sessions,
 				_child.custom_services().pd_root->session_infos());
 	}
+	t = _phase(Phase_log::Phase_record::RESTORE_STATE, t, Phase_log::count(_capability_map_infos));
 
 
 	if(verbose_debug)
@@ -1480,11 +1791,20 @@ void Restorer::restore()
 	}
 
 
+	if(_plan) _plan_memory_to_restore();
+
 	// Resolve inc checkpoint dataspaces in memory to restore
 	_resolve_inc_checkpoint_dataspaces(_child.custom_services().ram_root->session_infos(), _memory_to_restore);
+	unsigned const num_memory_infos = Phase_log::count(_memory_to_restore);
+	t = _phase(Phase_log::Phase_record::RESTORE_MEMORY_LIST, t, num_memory_infos);
 
 	// Replace old badges with new in capability map
-	_restore_cap_map(_child, _state);
+	// Without bootstrap, there is no capability map of the child yet; the stored one is translated after restoring the memory
+	if(!_child._without_bootstrap)
+	{
+		_restore_cap_map(_child, _state);
+		t = _phase(Phase_log::Phase_record::RESTORE_CAP_MAP, t);
+	}
 
 	if(verbose_debug)
 	{
@@ -1500,16 +1820,24 @@ void Restorer::restore()
 
 	// Insert capabilities of all objects into capability space
 	_restore_cap_space(_child);
+	t = _phase(Phase_log::Phase_record::RESTORE_CAP_SPACE, t, Phase_log::count(_capability_map_infos));
 
 	// Copy stored content to child content
+	Genode::size_t const copied_before = bytes_copied();
 	_restore_dataspaces(_memory_to_restore);
+	t = _phase(Phase_log::Phase_record::RESTORE_MEMORY, t, num_memory_infos, bytes_copied() - copied_before);
 
-	// Clean up
+	if(_child._without_bootstrap && !_deferred_start) start_deferred();
+
+	// Clean up; the lists holding capabilities are destroyed to release the references,
+	// the remaining memory is released at once by resetting _arena in the next restore.
+	// The translations are kept in _ckpt_to_resto_infos for translation() and start_deferred();
+	// the plan's index may be dropped with the plan meanwhile
 	_destroy_list(_capability_map_infos);
-	_destroy_list(_ckpt_to_resto_infos);
 	_destroy_list(_memory_to_restore);
-	_destroy_list(_region_map_dataspaces_from_stored);
+	_region_map_dataspaces_from_stored = Genode::List<Ref_badge>();
+	_translations = nullptr;
 
-	Genode::log("After: \n", _child);
+	if(verbose_debug) Genode::log("After: \n", _child);
 
 }
@@ -9,6 +9,8 @@
 
 /* Genode includes */
 #include <foc_native_pd/client.h>
+#include <foc/native_capability.h>
+#include <ram_session/client.h>
 
 /* Rtcr includes */
 #include "target_state.h"
@@ -17,15 +19,33 @@
 #include "util/orig_copy_resto_info.h"
 #include "util/ref_badge.h"
 #include "util/cap_kcap_info.h"
+#include "util/arena.h"
+#include "util/cap_map_layout.h"
+#include "util/cap_map_scanner.h"
+#include "util/parallel_copy.h"
+#include "util/phase_log.h"
+#include "util/event_trace.h"
+#include "restore_plan.h"
 
 namespace Rtcr {
 	class Restorer;
 
-	constexpr bool restorer_verbose_debug = true;
+	constexpr bool restorer_verbose_debug = false;
 }
 
 class Rtcr::Restorer
 {
+public:
+	/**
+	 * Point in time at which the content of managed (incrementally checkpointed) dataspaces is restored
+	 *
+	 * EAGER:           all content is copied before the child is started
+	 * ON_FIRST_ACCESS: the designated dataspaces are left detached and the content of a designated
+	 *                  dataspace is copied by the page fault handler when the child first accesses it;
+	 *                  the Target_state has to keep the stored content until then
+	 */
+	enum Memory_restore { EAGER, ON_FIRST_ACCESS };
+
 private:
 
 	/**
@@ -37,8 +57,25 @@ private:
 	 * are created with the allocator of Target_state
 	 */
 	Genode::Allocator &_alloc;
+	/**
+	 * Allocator for the temporary lists of a single restore. It is reset at the start of the next restore()
+	 */
+	Arena              _arena;
 	Target_child &_child;
 	Target_state &_state;
+	/**
+	 * Copy engine owned by the restorer, if none is passed to the constructor
+	 */
+	Parallel_copy     *_own_copy;
+	/**
+	 * Copies the stored memory content to the child's dataspaces
+	 */
+	Parallel_copy     &_copy;
+	/**
+	 * Bytes copied by _copy before this restorer
+	 */
+	Genode::size_t const _copied_before;
+	Memory_restore const _memory_restore;
 	/**
 	 * Contains kcap which are needed to be mapped
 	 * They belong to RPC objects which are not bootstrapped and had to be recreated.
@@ -47,6 +84,35 @@ private:
 	Genode::List<Ckpt_resto_badge_info> _ckpt_to_resto_infos;
 	Genode::List<Orig_copy_resto_info>  _memory_to_restore;
 	Genode::List<Ref_badge>             _region_map_dataspaces_from_stored;
+	/**
+	 * Optional plan of _state compiled ahead of time
+	 */
+	Restore_plan const                 *_plan;
+	/**
+	 * Translations indexed by the plan's badge index; valid during restore() with a plan
+	 */
+	Ckpt_resto_badge_info             **_translations;
+	/**
+	 * Without bootstrap, leave the capability map and the threads to start_deferred()
+	 */
+	bool                                _deferred_start;
+	/**
+	 * Ring recording the phases of each restore; may be null
+	 */
+	Phase_log                          *_phase_log;
+
+	Phase_log::Timestamp _phase(Phase_log::Phase_record::Phase phase, Phase_log::Timestamp start,
+			unsigned objects = 0, Genode::uint64_t bytes = 0)
+	{
+		Event_trace::record(Event_trace::PHASE, Event_trace::PHASE_END, phase, objects);
+		return _phase_log ? _phase_log->phase(phase, start, objects, bytes) : Phase_log::now();
+	}
+
+	void _translate(Genode::uint16_t ckpt_badge, Genode::Native_capability resto_cap);
+	Ckpt_resto_badge_info *_find_translation(Genode::uint16_t ckpt_badge);
+	bool _region_map_dataspace(Genode::uint16_t ckpt_badge);
+	void _preallocate_quota();
+	void _plan_memory_to_restore();
 
 	template<typename T>
 	void _destroy_list(Genode::List<T> &list);
@@ -107,6 +173,8 @@ private:
 	void _restore_state_cpu_threads(
 			Cpu_session_component &cpu_session, Genode::List<Stored_cpu_thread_info> &stored_cpu_threads,
 			Genode::List<Pd_session_component> &pd_sessions);
+	void _start_cpu_threads(
+			Cpu_root &cpu_root, Genode::List<Stored_cpu_session_info> &stored_cpu_sessions);
 
 	void _restore_state_rm_sessions(
 			Rm_root &rm_root, Genode::List<Stored_rm_session_info> &stored_rm_sessions,
@@ -127,8 +195,7 @@ private:
 	template<typename RESTO>
 	RESTO *_find_child_object(Genode::uint16_t badge, Genode::List<RESTO> &child_objects)
 	{
-		Ckpt_resto_badge_info *cr_info = _ckpt_to_resto_infos.first();
-		if(cr_info) cr_info = cr_info->find_by_ckpt_badge(badge);
+		Ckpt_resto_badge_info *cr_info = _find_translation(badge);
 		if(!cr_info)
 		{
 			Genode::error("Could not translate stored badge ", badge);
@@ -145,7 +212,10 @@ private:
 			Genode::List<Ram_session_component> &ram_sessions, Genode::List<Orig_copy_resto_info> &memory_infos);
 
 	void _restore_cap_map(Target_child &child, Target_state &state);
+	void _translate_cap_map(Target_child &child, Target_state &state);
 	void _restore_cap_space(Target_child &child);
+	void _install_batch(Genode::Foc_native_pd_client &native_pd,
+			Genode::Foc_native_pd::Install_batch &batch, Cap_kcap_info **batch_infos);
 
 	void _restore_dataspaces(Genode::List<Orig_copy_resto_info> &memory_infos);
 	void _restore_dataspace_content(Genode::Dataspace_capability orig_ds_cap,
@@ -153,10 +223,48 @@ private:
 
 
 public:
-	Restorer(Genode::Allocator &alloc, Target_child &child, Target_state &state);
+	/**
+	 * Constructor
+	 *
+	 * \param copy_config    Number of worker threads, their CPUs, and the chunk size for restoring memory
+	 * \param memory_restore Point in time at which the content of managed dataspaces is restored
+	 * \param plan           Plan compiled from state; it has to be recompiled when state changes
+	 * \param copy           If not null, the memory is copied by copy instead of an own copy engine
+	 *                       configured by copy_config; its mappings of the stored memory are kept
+	 *                       for the following restorers of state
+	 */
+	Restorer(Genode::Allocator &alloc, Target_child &child, Target_state &state,
+			Parallel_copy::Config const &copy_config = Parallel_copy::Config(),
+			Memory_restore memory_restore = EAGER, Restore_plan const *plan = nullptr,
+			Parallel_copy *copy = nullptr);
 	~Restorer();
 
 	void restore();
+
+	/**
+	 * Without bootstrap, let restore() leave the child stopped until start_deferred() is called
+	 */
+	void defer_start(bool defer) { _deferred_start = defer; }
+	/**
+	 * Record the phases of the restores to log; the operations are begun and ended by the caller
+	 */
+	void phase_log(Phase_log *log) { _phase_log = log; }
+	/**
+	 * Translate the child's capability map and start the threads which were started in the checkpointed child
+	 *
+	 * Content of state copied to the child after restore() has to contain the untranslated capability map.
+	 */
+	void start_deferred();
+	/**
+	 * Return the capability of the child object restored for a checkpointed badge or an invalid capability
+	 *
+	 * The translations of the last restore() are kept until the next restore().
+	 */
+	Genode::Native_capability translation(Genode::uint16_t ckpt_badge);
+	/**
+	 * Bytes of memory copied to the child so far
+	 */
+	Genode::size_t bytes_copied() const { return _copy.bytes_copied() - _copied_before; }
 };
 
 #endif /* _RTCR_RESTORER_H_ */
@@ -0,0 +1,518 @@
+/*
+ * \brief  In-place rollback of a running Target_child to its last checkpoint
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#include "rollback.h"
+
+using namespace Rtcr;
+
+
+bool Rollback::_present_pd_sessions(Genode::List<Stored_pd_session_info> &stored_pd_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Stored_pd_session_info *stored_pd_session = stored_pd_sessions.first();
+	while(stored_pd_session)
+	{
+		Pd_session_component *pd_session = _child.custom_services().pd_root->session_infos().first();
+		if(pd_session) pd_session = pd_session->find_by_badge(stored_pd_session->badge);
+		if(!pd_session)
+		{
+			Genode::warning("PD session ", stored_pd_session->badge, " was closed since the checkpoint");
+			return false;
+		}
+
+		Stored_signal_source_info *stored_source = stored_pd_session->stored_source_infos.first();
+		while(stored_source)
+		{
+			Signal_source_info *source = pd_session->parent_state().signal_sources.first();
+			if(source) source = source->find_by_badge(stored_source->badge);
+			if(!source)
+			{
+				Genode::warning("Signal source ", stored_source->badge, " was freed since the checkpoint");
+				return false;
+			}
+			stored_source = stored_source->next();
+		}
+
+		Stored_signal_context_info *stored_context = stored_pd_session->stored_context_infos.first();
+		while(stored_context)
+		{
+			Signal_context_info *context = pd_session->parent_state().signal_contexts.first();
+			if(context) context = context->find_by_badge(stored_context->badge);
+			if(!context)
+			{
+				Genode::warning("Signal context ", stored_context->badge, " was freed since the checkpoint");
+				return false;
+			}
+			stored_context = stored_context->next();
+		}
+
+		if(!_present_attached_regions(pd_session->address_space_component(),
+				stored_pd_session->stored_address_space.stored_attached_region_infos)) return false;
+		if(!_present_attached_regions(pd_session->stack_area_component(),
+				stored_pd_session->stored_stack_area.stored_attached_region_infos)) return false;
+		if(!_present_attached_regions(pd_session->linker_area_component(),
+				stored_pd_session->stored_linker_area.stored_attached_region_infos)) return false;
+
+		stored_pd_session = stored_pd_session->next();
+	}
+
+	return true;
+}
+
+
+bool Rollback::_present_ram_sessions(Genode::List<Stored_ram_session_info> &stored_ram_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Stored_ram_session_info *stored_ram_session = stored_ram_sessions.first();
+	while(stored_ram_session)
+	{
+		Ram_session_component *ram_session = _child.custom_services().ram_root->session_infos().first();
+		if(ram_session) ram_session = ram_session->find_by_badge(stored_ram_session->badge);
+		if(!ram_session)
+		{
+			Genode::warning("RAM session ", stored_ram_session->badge, " was closed since the checkpoint");
+			return false;
+		}
+
+		Stored_ram_dataspace_info *stored_ramds = stored_ram_session->stored_ramds_infos.first();
+		while(stored_ramds)
+		{
+			Ram_dataspace_info *ramds = ram_session->parent_state().ram_dataspaces.first();
+			if(ramds) ramds = ramds->find_by_badge(stored_ramds->badge);
+			if(!ramds)
+			{
+				Genode::warning("RAM dataspace ", stored_ramds->badge, " was freed since the checkpoint");
+				return false;
+			}
+			stored_ramds = stored_ramds->next();
+		}
+
+		stored_ram_session = stored_ram_session->next();
+	}
+
+	return true;
+}
+
+
+bool Rollback::_present_cpu_sessions(Genode::List<Stored_cpu_session_info> &stored_cpu_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Stored_cpu_session_info *stored_cpu_session = stored_cpu_sessions.first();
+	while(stored_cpu_session)
+	{
+		Cpu_session_component *cpu_session = _child.custom_services().cpu_root->session_infos().first();
+		if(cpu_session) cpu_session = cpu_session->find_by_badge(stored_cpu_session->badge);
+		if(!cpu_session)
+		{
+			Genode::warning("CPU session ", stored_cpu_session->badge, " was closed since the checkpoint");
+			return false;
+		}
+
+		Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_session->stored_cpu_thread_infos.first();
+		while(stored_cpu_thread)
+		{
+			Cpu_thread_component *cpu_thread = cpu_session->parent_state().cpu_threads.first();
+			if(cpu_thread) cpu_thread = cpu_thread->find_by_badge(stored_cpu_thread->badge);
+			if(!cpu_thread)
+			{
+				Genode::warning("CPU thread ", stored_cpu_thread->name, " was killed since the checkpoint");
+				return false;
+			}
+			stored_cpu_thread = stored_cpu_thread->next();
+		}
+
+		stored_cpu_session = stored_cpu_session->next();
+	}
+
+	return true;
+}
+
+
+bool Rollback::_present_rm_sessions(Genode::List<Stored_rm_session_info> &stored_rm_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Stored_rm_session_info *stored_rm_session = stored_rm_sessions.first();
+	while(stored_rm_session)
+	{
+		Rm_session_component *rm_session = nullptr;
+		if(_child.custom_services().rm_root) rm_session = _child.custom_services().rm_root->session_infos().first();
+		if(rm_session) rm_session = rm_session->find_by_badge(stored_rm_session->badge);
+		if(!rm_session)
+		{
+			Genode::warning("RM session ", stored_rm_session->badge, " was closed since the checkpoint");
+			return false;
+		}
+
+		Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
+		while(stored_region_map)
+		{
+			Region_map_component *region_map = rm_session->parent_state().region_maps.first();
+			if(region_map) region_map = region_map->find_by_badge(stored_region_map->badge);
+			if(!region_map)
+			{
+				Genode::warning("Region map ", stored_region_map->badge, " was destroyed since the checkpoint");
+				return false;
+			}
+			if(!_present_attached_regions(*region_map, stored_region_map->stored_attached_region_infos)) return false;
+
+			stored_region_map = stored_region_map->next();
+		}
+
+		stored_rm_session = stored_rm_session->next();
+	}
+
+	return true;
+}
+
+
+bool Rollback::_present_attached_regions(Region_map_component &region_map,
+		Genode::List<Stored_attached_region_info> &stored_attached_regions)
+{
+	Stored_attached_region_info *stored_attached_region = stored_attached_regions.first();
+	while(stored_attached_region)
+	{
+		// Regions which were detached since the checkpoint are reattached; their dataspace has to exist
+		Attached_region_info *attached_region = region_map.parent_state().attached_regions.first();
+		if(attached_region) attached_region = attached_region->find_by_addr(stored_attached_region->rel_addr);
+		bool const unchanged = attached_region && attached_region->rel_addr == stored_attached_region->rel_addr
+				&& attached_region->attached_ds_cap.local_name() == stored_attached_region->attached_ds_badge;
+
+		if(!unchanged && !_find_dataspace(stored_attached_region->attached_ds_badge).valid())
+		{
+			Genode::warning("Dataspace ", stored_attached_region->attached_ds_badge, " attached at ",
+					Genode::Hex(stored_attached_region->rel_addr), " does not exist anymore");
+			return false;
+		}
+
+		stored_attached_region = stored_attached_region->next();
+	}
+
+	return true;
+}
+
+
+Genode::Dataspace_capability Rollback::_find_dataspace(Genode::uint16_t badge)
+{
+	// RAM dataspaces
+	Ram_session_component *ram_session = _child.custom_services().ram_root->session_infos().first();
+	while(ram_session)
+	{
+		Ram_dataspace_info *ramds = ram_session->parent_state().ram_dataspaces.first();
+		if(ramds) ramds = ramds->find_by_badge(badge);
+		if(ramds) return ramds->cap;
+
+		ram_session = ram_session->next();
+	}
+
+	// Dataspaces of region maps
+	Pd_session_component *pd_session = _child.custom_services().pd_root->session_infos().first();
+	while(pd_session)
+	{
+		Genode::Dataspace_capability caps[] = {
+			pd_session->address_space_component().parent_state().ds_cap,
+			pd_session->stack_area_component().parent_state().ds_cap,
+			pd_session->linker_area_component().parent_state().ds_cap };
+		for(unsigned i = 0; i < sizeof(caps)/sizeof(caps[0]); i++)
+			if(caps[i].local_name() == badge) return caps[i];
+
+		pd_session = pd_session->next();
+	}
+	Rm_session_component *rm_session = nullptr;
+	if(_child.custom_services().rm_root) rm_session = _child.custom_services().rm_root->session_infos().first();
+	while(rm_session)
+	{
+		Region_map_component *region_map = rm_session->parent_state().region_maps.first();
+		while(region_map)
+		{
+			if(region_map->parent_state().ds_cap.local_name() == badge) return region_map->parent_state().ds_cap;
+			region_map = region_map->next();
+		}
+
+		rm_session = rm_session->next();
+	}
+
+	return Genode::Dataspace_capability();
+}
+
+
+void Rollback::_rollback_attached_regions(Region_map_component &region_map,
+		Genode::List<Stored_attached_region_info> &stored_attached_regions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	// Detach regions which were attached since the checkpoint
+	Attached_region_info *attached_region = region_map.parent_state().attached_regions.first();
+	while(attached_region)
+	{
+		Attached_region_info *next = attached_region->next();
+
+		Stored_attached_region_info *stored_attached_region = stored_attached_regions.first();
+		if(stored_attached_region) stored_attached_region = stored_attached_region->find_by_addr(attached_region->rel_addr);
+		bool const unchanged = stored_attached_region && stored_attached_region->rel_addr == attached_region->rel_addr
+				&& stored_attached_region->attached_ds_badge == attached_region->attached_ds_cap.local_name();
+
+		if(!unchanged) region_map.detach(attached_region->rel_addr);
+
+		attached_region = next;
+	}
+
+	// Reattach regions which were detached since the checkpoint
+	Stored_attached_region_info *stored_attached_region = stored_attached_regions.first();
+	while(stored_attached_region)
+	{
+		attached_region = region_map.parent_state().attached_regions.first();
+		if(attached_region) attached_region = attached_region->find_by_addr(stored_attached_region->rel_addr);
+
+		if(!attached_region)
+		{
+			region_map.attach(_find_dataspace(stored_attached_region->attached_ds_badge), stored_attached_region->size,
+					stored_attached_region->offset, true, stored_attached_region->rel_addr, stored_attached_region->executable);
+		}
+
+		stored_attached_region = stored_attached_region->next();
+	}
+}
+
+
+void Rollback::_rollback_pd_sessions(Genode::List<Stored_pd_session_info> &stored_pd_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Pd_session_component *pd_session = _child.custom_services().pd_root->session_infos().first();
+	while(pd_session)
+	{
+		Stored_pd_session_info *stored_pd_session = stored_pd_sessions.first();
+		if(stored_pd_session) stored_pd_session = stored_pd_session->find_by_badge(pd_session->cap().local_name());
+		if(!stored_pd_session)
+		{
+			// The session stays open until the child is destroyed
+			Genode::warning("PD session ", pd_session->cap(), " was opened since the checkpoint");
+			pd_session = pd_session->next();
+			continue;
+		}
+
+		_rollback_attached_regions(pd_session->address_space_component(),
+				stored_pd_session->stored_address_space.stored_attached_region_infos);
+		_rollback_attached_regions(pd_session->stack_area_component(),
+				stored_pd_session->stored_stack_area.stored_attached_region_infos);
+		_rollback_attached_regions(pd_session->linker_area_component(),
+				stored_pd_session->stored_linker_area.stored_attached_region_infos);
+
+		// Free signal contexts and sources which were allocated since the checkpoint
+		Signal_context_info *context = pd_session->parent_state().signal_contexts.first();
+		while(context)
+		{
+			Signal_context_info *next = context->next();
+
+			Stored_signal_context_info *stored_context = stored_pd_session->stored_context_infos.first();
+			if(stored_context) stored_context = stored_context->find_by_badge(context->cap.local_name());
+			if(!stored_context) pd_session->free_context(context->cap);
+
+			context = next;
+		}
+		Signal_source_info *source = pd_session->parent_state().signal_sources.first();
+		while(source)
+		{
+			Signal_source_info *next = source->next();
+
+			Stored_signal_source_info *stored_source = stored_pd_session->stored_source_infos.first();
+			if(stored_source) stored_source = stored_source->find_by_badge(source->cap.local_name());
+			if(!stored_source) pd_session->free_signal_source(source->cap);
+
+			source = next;
+		}
+
+		pd_session = pd_session->next();
+	}
+}
+
+
+void Rollback::_rollback_rm_sessions(Genode::List<Stored_rm_session_info> &stored_rm_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	if(!_child.custom_services().rm_root) return;
+
+	Rm_session_component *rm_session = _child.custom_services().rm_root->session_infos().first();
+	while(rm_session)
+	{
+		Stored_rm_session_info *stored_rm_session = stored_rm_sessions.first();
+		if(stored_rm_session) stored_rm_session = stored_rm_session->find_by_badge(rm_session->cap().local_name());
+		if(!stored_rm_session)
+		{
+			// The session stays open until the child is destroyed
+			Genode::warning("RM session ", rm_session->cap(), " was opened since the checkpoint");
+			rm_session = rm_session->next();
+			continue;
+		}
+
+		Region_map_component *region_map = rm_session->parent_state().region_maps.first();
+		while(region_map)
+		{
+			Region_map_component *next = region_map->next();
+
+			Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
+			if(stored_region_map) stored_region_map = stored_region_map->find_by_badge(region_map->cap().local_name());
+			if(stored_region_map)
+				_rollback_attached_regions(*region_map, stored_region_map->stored_attached_region_infos);
+			else
+				rm_session->destroy(region_map->cap());
+
+			region_map = next;
+		}
+
+		rm_session = rm_session->next();
+	}
+}
+
+
+void Rollback::_rollback_ram_sessions(Genode::List<Stored_ram_session_info> &stored_ram_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Ram_session_component *ram_session = _child.custom_services().ram_root->session_infos().first();
+	while(ram_session)
+	{
+		Stored_ram_session_info *stored_ram_session = stored_ram_sessions.first();
+		if(stored_ram_session) stored_ram_session = stored_ram_session->find_by_badge(ram_session->cap().local_name());
+		if(!stored_ram_session)
+		{
+			// The session stays open until the child is destroyed
+			Genode::warning("RAM session ", ram_session->cap(), " was opened since the checkpoint");
+			ram_session = ram_session->next();
+			continue;
+		}
+
+		Ram_dataspace_info *ramds = ram_session->parent_state().ram_dataspaces.first();
+		while(ramds)
+		{
+			Ram_dataspace_info *next = ramds->next();
+
+			Stored_ram_dataspace_info *stored_ramds = stored_ram_session->stored_ramds_infos.first();
+			if(stored_ramds) stored_ramds = stored_ramds->find_by_badge(ramds->cap.local_name());
+
+			if(!stored_ramds)
+			{
+				// Allocated since the checkpoint; the regions using it are already detached
+				ram_session->free(ramds->cap);
+			}
+			else if(ramds->mrm_info)
+			{
+				// Only the attached designated dataspaces were written since the checkpoint
+				Designated_dataspace_info *dd_info = ramds->mrm_info->dd_infos.first();
+				while(dd_info)
+				{
+					if(dd_info->attached)
+						_copy.copy(dd_info->cap, 0, stored_ramds->memory_content, dd_info->rel_addr, dd_info->size, true);
+
+					dd_info = dd_info->next();
+				}
+			}
+			else
+			{
+				_copy.copy(ramds->cap, 0, stored_ramds->memory_content, 0, stored_ramds->size, true);
+			}
+
+			ramds = next;
+		}
+
+		ram_session = ram_session->next();
+	}
+
+	_copy.run();
+
+	// The reverted content equals the checkpoint; mark the designated dataspaces clean again
+	ram_session = _child.custom_services().ram_root->session_infos().first();
+	while(ram_session)
+	{
+		Ram_dataspace_info *ramds = ram_session->parent_state().ram_dataspaces.first();
+		while(ramds)
+		{
+			if(ramds->mrm_info) ramds->mrm_info->detach_designated_dataspaces(_state._env.pd().native_pd());
+			ramds = ramds->next();
+		}
+		ram_session = ram_session->next();
+	}
+}
+
+
+void Rollback::_rollback_cpu_sessions(Genode::List<Stored_cpu_session_info> &stored_cpu_sessions)
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m(...)");
+
+	Cpu_session_component *cpu_session = _child.custom_services().cpu_root->session_infos().first();
+	while(cpu_session)
+	{
+		Stored_cpu_session_info *stored_cpu_session = stored_cpu_sessions.first();
+		if(stored_cpu_session) stored_cpu_session = stored_cpu_session->find_by_badge(cpu_session->cap().local_name());
+		if(!stored_cpu_session)
+		{
+			// The session stays open until the child is destroyed
+			Genode::warning("CPU session ", cpu_session->cap(), " was opened since the checkpoint");
+			cpu_session = cpu_session->next();
+			continue;
+		}
+
+		Cpu_thread_component *cpu_thread = cpu_session->parent_state().cpu_threads.first();
+		while(cpu_thread)
+		{
+			Cpu_thread_component *next = cpu_thread->next();
+
+			Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_session->stored_cpu_thread_infos.first();
+			if(stored_cpu_thread) stored_cpu_thread = stored_cpu_thread->find_by_badge(cpu_thread->cap().local_name());
+
+			if(!stored_cpu_thread)
+				cpu_session->kill_thread(cpu_thread->cap());
+			else
+				cpu_session->stage_thread_state(*cpu_thread, stored_cpu_thread->ts);
+
+			cpu_thread = next;
+		}
+
+		cpu_session->commit_thread_states();
+
+		cpu_session = cpu_session->next();
+	}
+}
+
+
+Rollback::Rollback(Genode::Allocator &alloc, Target_child &child, Target_state &state,
+		Parallel_copy::Config const &copy_config)
+:
+	_alloc(alloc), _child(child), _state(state), _copy(state._env, alloc, copy_config)
+{ }
+
+
+bool Rollback::rollback()
+{
+	if(verbose_debug) Genode::log("Rollback::\033[33m", __func__, "\033[0m()");
+
+	_child.pause();
+
+	// Objects destroyed since the checkpoint cannot be recreated with their old capabilities
+	if(!_present_ram_sessions(_state._stored_ram_sessions) || !_present_pd_sessions(_state._stored_pd_sessions)
+			|| !_present_cpu_sessions(_state._stored_cpu_sessions) || !_present_rm_sessions(_state._stored_rm_sessions)
+			|| !_present_sessions(_state._stored_log_sessions, _child.custom_services().log_root, "LOG")
+			|| !_present_sessions(_state._stored_timer_sessions, _child.custom_services().timer_root, "Timer"))
+	{
+		_child.resume();
+		return false;
+	}
+
+	// Regions first, thus, dataspaces allocated since the checkpoint are not attached anymore when they are freed
+	_rollback_pd_sessions(_state._stored_pd_sessions);
+	_rollback_rm_sessions(_state._stored_rm_sessions);
+	_rollback_ram_sessions(_state._stored_ram_sessions);
+	_rollback_cpu_sessions(_state._stored_cpu_sessions);
+
+	_child.resume();
+
+	return true;
+}
@@ -0,0 +1,125 @@
+/*
+ * \brief  In-place rollback of a running Target_child to its last checkpoint
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The rollback reuses the live child: only the designated dataspaces which were
+ * attached (i.e. dirtied) since the last checkpoint are reverted from the stored
+ * copies, RPC objects created since the checkpoint are destroyed, and regions
+ * attached or detached since the checkpoint are detached or reattached. RAM
+ * dataspaces which are not managed by the incremental checkpointing are reverted
+ * as a whole.
+ *
+ * Objects which were destroyed since the checkpoint cannot be recreated with their
+ * old capabilities; in this case, the rollback is refused and the target has to
+ * be restored into a new Target_child.
+ */
+
+#ifndef _RTCR_ROLLBACK_H_
+#define _RTCR_ROLLBACK_H_
+
+/* Genode includes */
+#include <util/list.h>
+
+/* Rtcr includes */
+#include "target_state.h"
+#include "target_child.h"
+#include "util/parallel_copy.h"
+
+namespace Rtcr {
+	class Rollback;
+
+	constexpr bool rollback_verbose_debug = false;
+}
+
+
+class Rtcr::Rollback
+{
+private:
+	/**
+	 * Enable log output for debugging
+	 */
+	static constexpr bool verbose_debug = rollback_verbose_debug;
+
+	Genode::Allocator &_alloc;
+	Target_child      &_child;
+	Target_state      &_state;
+	/**
+	 * Copies the stored content of dirtied memory back to the child's dataspaces
+	 */
+	Parallel_copy      _copy;
+
+	/*
+	 * Noncopyable
+	 */
+	Rollback(Rollback const &);
+	Rollback &operator = (Rollback const &);
+
+	/**********************************************************
+	 *** Check whether all stored objects are still present ***
+	 **********************************************************/
+	bool _present_pd_sessions(Genode::List<Stored_pd_session_info> &stored_pd_sessions);
+	bool _present_ram_sessions(Genode::List<Stored_ram_session_info> &stored_ram_sessions);
+	bool _present_cpu_sessions(Genode::List<Stored_cpu_session_info> &stored_cpu_sessions);
+	bool _present_rm_sessions(Genode::List<Stored_rm_session_info> &stored_rm_sessions);
+	bool _present_attached_regions(Region_map_component &region_map,
+			Genode::List<Stored_attached_region_info> &stored_attached_regions);
+
+	template<typename STORED, typename ROOT>
+	bool _present_sessions(Genode::List<STORED> &stored_sessions, ROOT *root, char const *service)
+	{
+		STORED *stored_session = stored_sessions.first();
+		while(stored_session)
+		{
+			auto *session = root ? root->session_infos().first() : nullptr;
+			if(session) session = session->find_by_badge(stored_session->badge);
+			if(!session)
+			{
+				Genode::warning(service, " session ", stored_session->badge, " was closed since the checkpoint");
+				return false;
+			}
+			stored_session = stored_session->next();
+		}
+		return true;
+	}
+
+	/**
+	 * Return a dataspace of the child for a badge or an invalid capability
+	 */
+	Genode::Dataspace_capability _find_dataspace(Genode::uint16_t badge);
+
+	/******************************************
+	 *** Revert the child to the checkpoint ***
+	 ******************************************/
+	void _rollback_attached_regions(Region_map_component &region_map,
+			Genode::List<Stored_attached_region_info> &stored_attached_regions);
+	void _rollback_pd_sessions(Genode::List<Stored_pd_session_info> &stored_pd_sessions);
+	void _rollback_rm_sessions(Genode::List<Stored_rm_session_info> &stored_rm_sessions);
+	void _rollback_ram_sessions(Genode::List<Stored_ram_session_info> &stored_ram_sessions);
+	void _rollback_cpu_sessions(Genode::List<Stored_cpu_session_info> &stored_cpu_sessions);
+
+public:
+	/**
+	 * Constructor
+	 *
+	 * \param state Last checkpoint of child; it has to be created from child
+	 */
+	Rollback(Genode::Allocator &alloc, Target_child &child, Target_state &state,
+			Parallel_copy::Config const &copy_config = Parallel_copy::Config());
+
+	/**
+	 * Revert the child to the last checkpoint
+	 *
+	 * The child is paused during the rollback and resumed afterwards.
+	 *
+	 * \return false, if objects of the checkpoint were destroyed by the child; the child is left unchanged
+	 */
+	bool rollback();
+
+	/**
+	 * Bytes of memory reverted so far
+	 */
+	Genode::size_t bytes_copied() const { return _copy.bytes_copied(); }
+};
+
+#endif /* _RTCR_ROLLBACK_H_ */
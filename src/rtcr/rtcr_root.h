@@ -2,39 +2,96 @@
  * \brief  Rtcr session implementation
  * \author Denis Huber
  * \date   2016-08-26
+ *
+ * Unlike Genode::Root_component, the root does not manage the sessions at its
+ * own entrypoint; each session is served by its own entrypoint.
  */
 
 #ifndef _RTCR__RTCR_ROOT_H_
 #define _RTCR__RTCR_ROOT_H_
 
 /* Genode includes */
-#include <root/component.h>
+#include <root/root.h>
+#include <base/rpc_server.h>
+#include <base/lock.h>
+#include <util/list.h>
+#include <util/arg_string.h>
 
 /* Rtcr includes */
 #include "rtcr_session_component.h"
+#include "target_registry.h"
+#include "calibration.h"
 
 namespace Rtcr { class Root; }
 
-class Rtcr::Root : public Genode::Root_component<Rtcr::Session_component>
+class Rtcr::Root : public Genode::Rpc_object<Genode::Typed_root<Rtcr::Session>>
 {
 	private:
 
-	protected:
-
-		Session_component *_create_session(const char *args)
-		{
-			return new (md_alloc()) Session_component();
-		}
+		Genode::Env                      &_env;
+		Genode::Allocator                &_md_alloc;
+		Target_registry                  &_registry;
+		Calibration const                &_calibration;
+		Genode::Lock                      _lock;
+		Genode::List<Session_component>   _sessions;
 
 	public:
 
 		/**
 		 * Constructor
 		 */
-		Root(Genode::Entrypoint &session_ep, Genode::Allocator &md_alloc)
+		Root(Genode::Env &env, Genode::Allocator &md_alloc, Target_registry &registry,
+				Calibration const &calibration)
 		:
-			Root_component<Session_component>(session_ep, md_alloc)
+			_env(env), _md_alloc(md_alloc), _registry(registry), _calibration(calibration),
+			_lock(), _sessions()
 		{ }
+
+		~Root()
+		{
+			while(Session_component *session = _sessions.first())
+			{
+				_sessions.remove(session);
+				Genode::destroy(_md_alloc, session);
+			}
+		}
+
+		Genode::Session_capability session(Genode::Root::Session_args const &args,
+				Genode::Affinity const &affinity) override
+		{
+			// The session allocates its entrypoint, Timer session, and pages from Rtcr's RAM
+			Genode::size_t const ram_quota =
+				Genode::Arg_string::find_arg(args.string(), "ram_quota").ulong_value(0);
+			Genode::size_t const needed = sizeof(Session_component)
+				+ _md_alloc.overhead(sizeof(Session_component)) + Session_component::quota();
+			if(needed > ram_quota)
+			{
+				Genode::error("insufficient ram quota, provided=", ram_quota, ", required=", needed);
+				throw Genode::Root::Quota_exceeded();
+			}
+
+			Session_component *session = new (_md_alloc) Session_component(_env, _md_alloc, _registry,
+					_calibration);
+
+			Genode::Lock::Guard guard(_lock);
+			_sessions.insert(session);
+
+			return session->cap();
+		}
+
+		void upgrade(Genode::Session_capability, Genode::Root::Upgrade_args const &) override { }
+
+		void close(Genode::Session_capability session_cap) override
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			Session_component *session = _sessions.first();
+			if(session) session = session->find_by_badge(session_cap.local_name());
+			if(!session) return;
+
+			_sessions.remove(session);
+			Genode::destroy(_md_alloc, session);
+		}
 };
 
 
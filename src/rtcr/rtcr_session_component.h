@@ -7,37 +7,357 @@
 #ifndef _RTCR__RTCR_SESSION_COMPONENT_H_
 #define _RTCR__RTCR_SESSION_COMPONENT_H_
 
-#include <base/allocator_guard.h>
+/* Genode includes */
+#include <util/list.h>
+#include <base/entrypoint.h>
 #include <base/rpc_server.h>
+#include <base/thread.h>
+#include <base/lock.h>
+#include <os/attached_ram_dataspace.h>
+#include <timer_session/connection.h>
 #include <rtcr_session/rtcr_session.h>
 
+/* Rtcr includes */
+#include "target_registry.h"
+#include "calibration.h"
+
 namespace Rtcr {
 	class Session_component;
 }
 
-class Rtcr::Session_component : public Genode::Rpc_object<Rtcr::Session>
+class Rtcr::Session_component : public Genode::Rpc_object<Rtcr::Session>,
+                                public Genode::List<Session_component>::Element
 {
 private:
 	static constexpr bool verbose = true;
 
+	enum { EP_STACK_SIZE = 64*1024, JOB_STACK_SIZE = 64*1024, TIMER_QUOTA = 8*1024 };
+
+	/**
+	 * Thread executing an asynchronous checkpoint or restore
+	 */
+	struct Async_job : Genode::Thread, Genode::List<Async_job>::Element
+	{
+		enum Operation { CHECKPOINT, RESTORE };
+
+		Session_component           &session;
+		Operation             const  operation;
+		Target_registry::Name const  name;
+		/**
+		 * Generation to restore; zero means the last checkpoint
+		 */
+		unsigned              const  generation;
+		Job                   const  job;
+		bool                         finished;
+
+		Async_job(Genode::Env &env, Session_component &session, Operation operation,
+				Target_registry::Name const &name, unsigned generation, Job job)
+		:
+			Thread(env, "rtcr_job", JOB_STACK_SIZE),
+			session(session), operation(operation), name(name), generation(generation), job(job),
+			finished(false)
+		{ }
+
+		void entry() override
+		{
+			Event_trace::Thread_scope trace_scope;
+			session._execute(*this);
+		}
+	};
+
+	/**
+	 * Publishes the bytes copied and the elapsed time of a running job in its Job_status
+	 */
+	struct Job_progress : Phase_log::Progress
+	{
+		Job_status          &status;
+		Timer::Connection   &timer;
+		unsigned long const  start_ms;
+
+		Job_progress(Job_status &status, Timer::Connection &timer, unsigned long start_ms)
+		:
+			status(status), timer(timer), start_ms(start_ms)
+		{ }
+
+		void progress(Genode::uint64_t bytes) override
+		{
+			status.bytes_copied = bytes;
+			status.elapsed_ms   = timer.elapsed_ms() - start_ms;
+		}
+	};
+
+	Genode::Env                      &_env;
+	Genode::Allocator                &_alloc;
+	/**
+	 * Entrypoint serving only this session; thus, clients of different sessions are served concurrently
+	 */
+	Genode::Entrypoint                _ep;
+	Target_registry                  &_registry;
+	Calibration const                &_calibration;
+	Timer::Connection                 _timer;
+	/**
+	 * Status_page shared with the client
+	 */
+	Genode::Attached_ram_dataspace    _status_ds;
+	/**
+	 * Phase_page shared with the client
+	 */
+	Genode::Attached_ram_dataspace    _phase_ds;
+	Genode::Signal_context_capability _completion_sigh;
+	Genode::Lock                      _jobs_lock;
+	Genode::List<Async_job>           _jobs;
+	Job                               _next_job;
+
+	Job_status &_status(Job job)
+	{
+		return _status_ds.local_addr<Status_page>()->jobs[job % Status_page::MAX_JOBS];
+	}
+
+	/**
+	 * Join and destroy the threads of finished jobs
+	 */
+	void _reap_jobs(bool wait)
+	{
+		Genode::Lock::Guard guard(_jobs_lock);
+
+		Async_job *async_job = _jobs.first();
+		while(async_job)
+		{
+			Async_job *next = async_job->next();
+			if(wait || async_job->finished)
+			{
+				async_job->join();
+				_jobs.remove(async_job);
+				Genode::destroy(_alloc, async_job);
+			}
+			async_job = next;
+		}
+	}
+
+	Job _start_job(Async_job::Operation operation, Name const &component, unsigned generation = 0)
+	{
+		_reap_jobs(false);
+
+		// The stacks of the running jobs are covered by the session quota
+		{
+			Genode::Lock::Guard guard(_jobs_lock);
+			if(Phase_log::count(_jobs) >= MAX_RUNNING_JOBS) throw Too_many_jobs();
+		}
+
+		Job const job = _next_job;
+		Job_status &status = _status(job);
+		if(status.phase != Job_status::UNUSED && status.phase != Job_status::DONE && status.phase != Job_status::FAILED)
+			throw Too_many_jobs();
+		_next_job++;
+
+		status.job          = job;
+		status.phase        = Job_status::QUEUED;
+		status.generation   = 0;
+		status.bytes_copied = 0;
+		status.elapsed_ms   = 0;
+
+		Async_job *async_job = new (_alloc) Async_job(_env, *this, operation, component.string(), generation, job);
+		{
+			Genode::Lock::Guard guard(_jobs_lock);
+			_jobs.insert(async_job);
+		}
+		async_job->start();
+
+		return job;
+	}
+
+	void _execute(Async_job &async_job)
+	{
+		if(verbose) Genode::log("job ", async_job.job, "(component=", async_job.name, ")");
+
+		Job_status &status = _status(async_job.job);
+		unsigned long const start = _timer.elapsed_ms();
+		Job_progress progress(status, _timer, start);
+
+		status.phase = Job_status::WAITING_FOR_TARGET;
+		try
+		{
+			_registry.apply(async_job.name, [&] (Target_registry::Target &target) {
+
+				// The operations on the target are serialized, thus, only this job reports to progress
+				target.phases().progress(&progress);
+				try
+				{
+					if(async_job.operation == Async_job::CHECKPOINT)
+					{
+						status.phase      = Job_status::CHECKPOINTING;
+						status.generation = target.checkpoint();
+					}
+					else
+					{
+						status.phase      = Job_status::RESTORING;
+						target.restore(async_job.generation);
+						status.generation = target.snapshot_generation();
+					}
+				}
+				catch(...)
+				{
+					target.phases().progress(nullptr);
+					throw;
+				}
+				target.phases().progress(nullptr);
+
+				status.bytes_copied = target.bytes_copied();
+			});
+			status.phase = Job_status::DONE;
+		}
+		catch(Genode::Exception)
+		{
+			status.phase = Job_status::FAILED;
+		}
+		status.elapsed_ms = _timer.elapsed_ms() - start;
+
+		async_job.finished = true;
+		if(_completion_sigh.valid()) Genode::Signal_transmitter(_completion_sigh).submit();
+	}
+
 public:
-	Session_component()  { }
+	/**
+	 * RAM quota used by a session besides its Session_component object: the stack of its entrypoint,
+	 * its Timer session, the status and phase pages, and the stacks of its running jobs
+	 */
+	static Genode::size_t quota()
+	{
+		return EP_STACK_SIZE + TIMER_QUOTA + sizeof(Status_page) + sizeof(Phase_page)
+				+ MAX_RUNNING_JOBS*JOB_STACK_SIZE;
+	}
 
-	~Session_component() { }
+	Session_component(Genode::Env &env, Genode::Allocator &alloc, Target_registry &registry,
+			Calibration const &calibration)
+	:
+		_env(env), _alloc(alloc),
+		_ep(env, EP_STACK_SIZE, "rtcr_session_ep"), _registry(registry), _calibration(calibration),
+		_timer(env), _status_ds(env.ram(), env.rm(), sizeof(Status_page)),
+		_phase_ds(env.ram(), env.rm(), sizeof(Phase_page)),
+		_completion_sigh(), _jobs_lock(), _jobs(), _next_job(1)
+	{
+		Genode::memset(_status_ds.local_addr<Status_page>(), 0, sizeof(Status_page));
+		_ep.manage(*this);
+	}
+
+	~Session_component()
+	{
+		_ep.dissolve(*this);
+		_reap_jobs(true);
+	}
+
+	Session_component *find_by_badge(Genode::uint16_t badge)
+	{
+		if(badge == cap().local_name())
+			return this;
+		Session_component *session = next();
+		return session ? session->find_by_badge(badge) : 0;
+	}
 
 	/*****************************
 	 ** Rtcr::Session interface **
 	 *****************************/
 
-	void checkpoint(Name const &component) override
+	void start(Name const &component, Genode::size_t granularity) override
+	{
+		if(verbose) Genode::log("start(component=", component.string(), ", granularity=", granularity, ")");
+
+		_registry.start(component.string(), granularity);
+	}
+
+	unsigned checkpoint(Name const &component) override
 	{
 		if(verbose) Genode::log("checkpoint(component=", component.string(),")");
+
+		unsigned generation = 0;
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			generation = target.checkpoint(); });
+
+		return generation;
+	}
+
+	void restore(Name const &component, unsigned generation) override
+	{
+		if(verbose) Genode::log("restore(component=", component.string(), ", generation=", generation, ")");
+
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			target.restore(generation); });
+	}
+
+	unsigned clone(Name const &component, unsigned count, unsigned generation) override
+	{
+		if(verbose) Genode::log("clone(component=", component.string(), ", count=", count,
+				", generation=", generation, ")");
+
+		unsigned result = 0;
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			result = target.clone(count, generation); });
+
+		return result;
+	}
+
+	unsigned destroy_clones(Name const &component) override
+	{
+		if(verbose) Genode::log("destroy_clones(component=", component.string(), ")");
+
+		unsigned result = 0;
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			result = target.destroy_clones(); });
+
+		return result;
+	}
+
+	void failover(Name const &component) override
+	{
+		if(verbose) Genode::log("failover(component=", component.string(), ")");
+
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			target.failover(); });
+	}
+
+	Job checkpoint_async(Name const &component) override
+	{
+		if(verbose) Genode::log("checkpoint_async(component=", component.string(),")");
+
+		return _start_job(Async_job::CHECKPOINT, component);
+	}
+
+	Job restore_async(Name const &component, unsigned generation) override
+	{
+		if(verbose) Genode::log("restore_async(component=", component.string(), ", generation=", generation, ")");
+
+		return _start_job(Async_job::RESTORE, component, generation);
 	}
 
-	void restore(Name const &component) override
+	void completion_sigh(Genode::Signal_context_capability sigh) override { _completion_sigh = sigh; }
+
+	Genode::Dataspace_capability status_dataspace() override { return _status_ds.cap(); }
+
+	Prediction predict(Name const &component) override
 	{
-		if(verbose) Genode::log("restore(component=", component.string(),")");
+		if(verbose) Genode::log("predict(component=", component.string(),")");
+
+		Prediction prediction;
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			prediction = target.predict(_calibration); });
+
+		return prediction;
 	}
+
+	unsigned phase_records(Name const &component) override
+	{
+		if(verbose) Genode::log("phase_records(component=", component.string(),")");
+
+		Phase_page &page = *_phase_ds.local_addr<Phase_page>();
+		page.ticks_per_us = _calibration.costs().ticks_per_us;
+
+		_registry.apply(component.string(), [&] (Target_registry::Target &target) {
+			page.count = target.phases().copy(page.operations, Phase_page::MAX_OPERATIONS); });
+
+		return page.count;
+	}
+
+	Genode::Dataspace_capability phase_dataspace() override { return _phase_ds.cap(); }
 };
 
 #endif /* _RTCR__RTCR_SESSION_COMPONENT_H_ */
@@ -0,0 +1,250 @@
+/*
+ * \brief  Hot-standby replica of a registry target fed with its checkpoints
+ * \author agent
+ * \date   2026-10-18
+ */
+
+/* Genode includes */
+#include <base/snprintf.h>
+#include <rtcr_session/rtcr_session.h>
+
+/* Rtcr includes */
+#include "standby.h"
+
+using namespace Rtcr;
+
+
+Genode::uint64_t Standby::_structure_of(Target_state &state)
+{
+	// FNV-1a hash of all checkpointed objects and regions
+	Genode::uint64_t hash = 0xcbf29ce484222325ULL;
+	auto mix = [&] (Genode::uint64_t value) {
+		for(unsigned i = 0; i < 8; i++, value >>= 8)
+		{
+			hash ^= value & 0xff;
+			hash *= 0x100000001b3ULL;
+		}
+	};
+
+	auto mix_region_map = [&] (Stored_region_map_info &stored_region_map) {
+		mix(stored_region_map.badge);
+		Stored_attached_region_info *stored_attached_region = stored_region_map.stored_attached_region_infos.first();
+		for(; stored_attached_region; stored_attached_region = stored_attached_region->next())
+		{
+			mix(stored_attached_region->attached_ds_badge);
+			mix(stored_attached_region->rel_addr);
+			mix(stored_attached_region->size);
+		}
+	};
+
+	Stored_pd_session_info *stored_pd_session = state._stored_pd_sessions.first();
+	for(; stored_pd_session; stored_pd_session = stored_pd_session->next())
+	{
+		mix(stored_pd_session->badge);
+
+		Stored_signal_source_info *stored_source = stored_pd_session->stored_source_infos.first();
+		for(; stored_source; stored_source = stored_source->next()) mix(stored_source->badge);
+		Stored_signal_context_info *stored_context = stored_pd_session->stored_context_infos.first();
+		for(; stored_context; stored_context = stored_context->next()) mix(stored_context->badge);
+		Stored_native_capability_info *stored_native_cap = stored_pd_session->stored_native_cap_infos.first();
+		for(; stored_native_cap; stored_native_cap = stored_native_cap->next()) mix(stored_native_cap->badge);
+
+		mix_region_map(stored_pd_session->stored_address_space);
+		mix_region_map(stored_pd_session->stored_stack_area);
+		mix_region_map(stored_pd_session->stored_linker_area);
+	}
+
+	Stored_cpu_session_info *stored_cpu_session = state._stored_cpu_sessions.first();
+	for(; stored_cpu_session; stored_cpu_session = stored_cpu_session->next())
+	{
+		mix(stored_cpu_session->badge);
+		Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_session->stored_cpu_thread_infos.first();
+		for(; stored_cpu_thread; stored_cpu_thread = stored_cpu_thread->next()) mix(stored_cpu_thread->badge);
+	}
+
+	Stored_ram_session_info *stored_ram_session = state._stored_ram_sessions.first();
+	for(; stored_ram_session; stored_ram_session = stored_ram_session->next())
+	{
+		mix(stored_ram_session->badge);
+		Stored_ram_dataspace_info *stored_ramds = stored_ram_session->stored_ramds_infos.first();
+		for(; stored_ramds; stored_ramds = stored_ramds->next()) mix(stored_ramds->badge);
+	}
+
+	Stored_rm_session_info *stored_rm_session = state._stored_rm_sessions.first();
+	for(; stored_rm_session; stored_rm_session = stored_rm_session->next())
+	{
+		mix(stored_rm_session->badge);
+		Stored_region_map_info *stored_region_map = stored_rm_session->stored_region_map_infos.first();
+		for(; stored_region_map; stored_region_map = stored_region_map->next()) mix_region_map(*stored_region_map);
+	}
+
+	Stored_log_session_info *stored_log_session = state._stored_log_sessions.first();
+	for(; stored_log_session; stored_log_session = stored_log_session->next()) mix(stored_log_session->badge);
+	Stored_timer_session_info *stored_timer_session = state._stored_timer_sessions.first();
+	for(; stored_timer_session; stored_timer_session = stored_timer_session->next()) mix(stored_timer_session->badge);
+
+	return hash;
+}
+
+
+void Standby::_restore_replica(Target_state &state)
+{
+	if(verbose_debug) Genode::log("Standby<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	discard();
+
+	_replica  = new (_alloc) Target_child(_env, _alloc, _parent_services, _name.string(), _granularity,
+			_filename.string());
+	_restorer = new (_alloc) Restorer(_alloc, *_replica, state, Parallel_copy::Config(), Restorer::EAGER,
+			nullptr, &_copy);
+
+	// The replica stays stopped until failover
+	_restorer->defer_start(true);
+	_replica->start_without_bootstrap(*_restorer);
+
+	_state     = &state;
+	_structure = _structure_of(state);
+	_full_restores++;
+}
+
+
+void Standby::_apply_memory()
+{
+	if(verbose_debug) Genode::log("Standby<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	_delta.for_each([&] (Checkpoint_delta::Extent const &extent) {
+
+		// The extents of dataspaces which are not RAM dataspaces of the target, e.g. of rom modules, are not replicated
+		Stored_ram_dataspace_info *stored_ramds = nullptr;
+		Stored_ram_session_info *stored_ram_session = _state->_stored_ram_sessions.first();
+		for(; stored_ram_session && !stored_ramds; stored_ram_session = stored_ram_session->next())
+		{
+			stored_ramds = stored_ram_session->stored_ramds_infos.first();
+			while(stored_ramds && stored_ramds->memory_content.local_name() != extent.content_badge)
+				stored_ramds = stored_ramds->next();
+		}
+		if(!stored_ramds) return;
+
+		Genode::Native_capability const replica_ds = _restorer->translation(stored_ramds->badge);
+		if(!replica_ds.valid())
+		{
+			Genode::warning("Could not find replica dataspace for ckpt badge ", stored_ramds->badge);
+			return;
+		}
+
+		_copy.copy(Genode::reinterpret_cap_cast<Genode::Dataspace>(replica_ds), extent.rel_addr,
+				stored_ramds->memory_content, extent.rel_addr, extent.size, true);
+	});
+
+	_copy.run();
+}
+
+
+void Standby::_apply_thread_states()
+{
+	if(verbose_debug) Genode::log("Standby<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	Stored_cpu_session_info *stored_cpu_session = _state->_stored_cpu_sessions.first();
+	for(; stored_cpu_session; stored_cpu_session = stored_cpu_session->next())
+	{
+		Cpu_session_component *cpu_session = _replica->custom_services().cpu_root->session_infos().first();
+		if(cpu_session) cpu_session = cpu_session->find_by_badge(_restorer->translation(stored_cpu_session->badge).local_name());
+		if(!cpu_session)
+		{
+			Genode::warning("Could not find replica CPU session for ckpt badge ", stored_cpu_session->badge);
+			continue;
+		}
+
+		Stored_cpu_thread_info *stored_cpu_thread = stored_cpu_session->stored_cpu_thread_infos.first();
+		for(; stored_cpu_thread; stored_cpu_thread = stored_cpu_thread->next())
+		{
+			Cpu_thread_component *cpu_thread = cpu_session->parent_state().cpu_threads.first();
+			if(cpu_thread) cpu_thread = cpu_thread->find_by_badge(_restorer->translation(stored_cpu_thread->badge).local_name());
+			if(cpu_thread) cpu_session->stage_thread_state(*cpu_thread, stored_cpu_thread->ts);
+		}
+
+		cpu_session->commit_thread_states();
+	}
+}
+
+
+Standby::Standby(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services,
+		char const *name, char const *filename, Genode::size_t granularity, unsigned cadence_ms,
+		Genode::Signal_context_capability cadence_sigh)
+:
+	_env(env), _alloc(alloc), _parent_services(parent_services),
+	_name(), _filename(filename), _granularity(granularity),
+	_delta(alloc), _copy(env, alloc),
+	_state(nullptr), _replica(nullptr), _restorer(nullptr), _structure(0),
+	_delta_updates(0), _full_restores(0),
+	_timer(env), _cadence_ms(0)
+{
+	if(verbose_debug) Genode::log("\033[33m", "Standby", "\033[0m(", name, ", cadence_ms=", cadence_ms, ")");
+
+	char replica_name[32];
+	Genode::snprintf(replica_name, sizeof(replica_name), "%s.standby", name);
+	_name = Genode::String<32>(replica_name);
+
+	_timer.sigh(cadence_sigh);
+	cadence(cadence_ms);
+}
+
+
+Standby::~Standby()
+{
+	_cadence_ms = 0;
+	discard();
+}
+
+
+void Standby::cadence(unsigned cadence_ms)
+{
+	_cadence_ms = cadence_ms;
+	if(_cadence_ms) _timer.trigger_periodic(_cadence_ms*1000);
+}
+
+
+void Standby::update(Target_state &state)
+{
+	if(verbose_debug) Genode::log("Standby<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	// The restorer of the replica refers to the Target_state it was restored from
+	if(!_replica || &state != _state || _structure_of(state) != _structure)
+	{
+		_restore_replica(state);
+		return;
+	}
+
+	_apply_memory();
+	_apply_thread_states();
+	_delta_updates++;
+}
+
+
+void Standby::discard()
+{
+	if(_restorer) Genode::destroy(_alloc, _restorer);
+	if(_replica)  Genode::destroy(_alloc, _replica);
+	_restorer = nullptr;
+	_replica  = nullptr;
+	_state    = nullptr;
+
+	// The stored dataspaces of the next Target_state may reuse the badges of the kept mappings
+	_copy.detach_all();
+}
+
+
+void Standby::failover(Target_child *&replica, Restorer *&restorer)
+{
+	if(verbose_debug) Genode::log("Standby<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	if(!_replica) throw Rtcr::Session::Checkpoint_does_not_exist();
+
+	_restorer->start_deferred();
+
+	replica  = _replica;
+	restorer = _restorer;
+	_replica  = nullptr;
+	_restorer = nullptr;
+	_state    = nullptr;
+}
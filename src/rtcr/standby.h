@@ -0,0 +1,174 @@
+/*
+ * \brief  Hot-standby replica of a registry target fed with its checkpoints
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The standby keeps a replica of a target restored from the target's
+ * checkpoints without bootstrap. The replica's threads are not started; it is
+ * stopped until failover(). The standby has no Checkpointer of its own: the
+ * Checkpointer of the target records the stored memory it copied to the
+ * standby's Checkpoint_delta, and the target calls update() when the memory of
+ * a checkpoint is complete. Only this delta and the thread states are applied
+ * to the replica. If the structure of the target changed since the last
+ * checkpoint (sessions, RPC objects or attached regions), or the target
+ * checkpoints into another Target_state, the replica is restored anew.
+ *
+ * Failover translates the replica's capability map and starts its threads;
+ * its latency is independent of the memory size of the target.
+ */
+
+#ifndef _RTCR_STANDBY_H_
+#define _RTCR_STANDBY_H_
+
+/* Genode includes */
+#include <util/xml_node.h>
+#include <base/service.h>
+#include <base/signal.h>
+#include <timer_session/connection.h>
+
+/* Rtcr includes */
+#include "target_child.h"
+#include "target_state.h"
+#include "restorer.h"
+#include "util/checkpoint_delta.h"
+#include "util/parallel_copy.h"
+
+namespace Rtcr {
+	class Standby;
+
+	constexpr bool standby_verbose_debug = false;
+}
+
+
+class Rtcr::Standby
+{
+public:
+	/**
+	 * Standby of a target, configured by a <standby cadence_ms="200"/> node of its <target> node
+	 */
+	struct Config
+	{
+		bool     enabled;
+		/**
+		 * Checkpoint cadence in milliseconds; 0 means the replica is fed only by the
+		 * checkpoints of the scheduler and the clients
+		 */
+		unsigned cadence_ms;
+
+		Config() : enabled(false), cadence_ms(0) { }
+
+		static Config from_xml(Genode::Xml_node node)
+		{
+			Config config;
+			config.enabled    = true;
+			config.cadence_ms = node.attribute_value("cadence_ms", config.cadence_ms);
+			return config;
+		}
+	};
+
+private:
+	/**
+	 * Enable log output for debugging
+	 */
+	static constexpr bool verbose_debug = standby_verbose_debug;
+
+	Genode::Env              &_env;
+	Genode::Allocator        &_alloc;
+	Genode::Service_registry &_parent_services;
+	/**
+	 * Name of the replica and rom module of the target
+	 */
+	Genode::String<32>        _name;
+	Genode::String<32> const  _filename;
+	Genode::size_t     const  _granularity;
+	/**
+	 * Stored memory copied by the last checkpoint of the target
+	 */
+	Checkpoint_delta          _delta;
+	/**
+	 * Copies the stored content to the replica
+	 */
+	Parallel_copy             _copy;
+	/**
+	 * Target_state from which the replica was restored
+	 */
+	Target_state             *_state;
+	Target_child             *_replica;
+	Restorer                 *_restorer;
+	/**
+	 * Structure of _state which the replica was restored from
+	 */
+	Genode::uint64_t          _structure;
+
+	unsigned                  _delta_updates;
+	unsigned                  _full_restores;
+
+	Timer::Connection         _timer;
+	unsigned                  _cadence_ms;
+
+	/*
+	 * Noncopyable
+	 */
+	Standby(Standby const &);
+	Standby &operator = (Standby const &);
+
+	Genode::uint64_t _structure_of(Target_state &state);
+	void _restore_replica(Target_state &state);
+	void _apply_memory();
+	void _apply_thread_states();
+
+public:
+	/**
+	 * Constructor
+	 *
+	 * \param name         Name of the target
+	 * \param filename     Rom module of the target
+	 * \param granularity  Size of designated dataspaces in pages of target and replica; it has to be greater than zero
+	 * \param cadence_ms   Checkpoint cadence in milliseconds; 0 means no periodic checkpoints
+	 * \param cadence_sigh Receives the periodic signals; its handler checkpoints the target
+	 */
+	Standby(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services,
+			char const *name, char const *filename, Genode::size_t granularity, unsigned cadence_ms,
+			Genode::Signal_context_capability cadence_sigh);
+	~Standby();
+
+	/**
+	 * Extents to be recorded by the Checkpointer of the target
+	 */
+	Checkpoint_delta &delta() { return _delta; }
+
+	/**
+	 * Set the checkpoint cadence; 0 stops the periodic checkpoints
+	 */
+	void cadence(unsigned cadence_ms);
+	unsigned cadence() const { return _cadence_ms; }
+
+	/**
+	 * Apply the last checkpoint of the target to the replica
+	 *
+	 * \param state Target_state of the checkpoint; its memory has to be complete
+	 */
+	void update(Target_state &state);
+
+	/**
+	 * Drop the replica, because the Target_state it was restored from is going to be destroyed
+	 */
+	void discard();
+
+	/**
+	 * Whether there is a replica to fail over to
+	 */
+	bool ready() const { return _replica; }
+
+	/**
+	 * Start the threads of the replica and hand it over with its restorer
+	 *
+	 * The standby restores a new replica from the next update().
+	 */
+	void failover(Target_child *&replica, Restorer *&restorer);
+
+	unsigned delta_updates() const { return _delta_updates; }
+	unsigned full_restores() const { return _full_restores; }
+};
+
+#endif /* _RTCR_STANDBY_H_ */
@@ -1,21 +1,42 @@
 TARGET = rtcr
 
 SRC_CC += main.cc \
-          cpu_session_component.cc \
-          pd_session_component.cc \
-          ram_session_component.cc \
-          region_map_component.cc \
-          log_session.cc \
+          pd_session.cc \
+          cpu_session.cc \
+          ram_session.cc \
+          rom_session.cc \
           rm_session.cc \
+          log_session.cc \
           timer_session.cc \
-          target_child.cc
-          
+          cpu_thread_component.cc \
+          region_map_component.cc \
+          target_child.cc \
+          target_state.cc \
+          compact_target_state.cc \
+          target_registry.cc \
+          checkpoint_scheduler.cc \
+          calibration.cc \
+          fault_telemetry.cc \
+          trace_dump.cc \
+          checkpointer.cc \
+          restorer.cc \
+          restore_plan.cc \
+          rollback.cc \
+          standby.cc \
+          event_trace.cc
+
 LIBS   += base
 
-vpath cpu_session_component.cc $(PRG_DIR)/intercept
-vpath pd_session_component.cc  $(PRG_DIR)/intercept
-vpath ram_session_component.cc $(PRG_DIR)/intercept
-vpath region_map_component.cc  $(PRG_DIR)/intercept
-vpath log_session.cc           $(PRG_DIR)/intercept
+INC_DIR += $(BASE_DIR)/../base-foc/src/include
+
+vpath pd_session.cc            $(PRG_DIR)/intercept
+vpath cpu_session.cc           $(PRG_DIR)/intercept
+vpath ram_session.cc           $(PRG_DIR)/intercept
+vpath rom_session.cc           $(PRG_DIR)/intercept
 vpath rm_session.cc            $(PRG_DIR)/intercept
+vpath log_session.cc           $(PRG_DIR)/intercept
 vpath timer_session.cc         $(PRG_DIR)/intercept
+vpath cpu_thread_component.cc  $(PRG_DIR)/intercept
+vpath region_map_component.cc  $(PRG_DIR)/intercept
+vpath compact_target_state.cc  $(PRG_DIR)/offline_storage
+vpath event_trace.cc           $(PRG_DIR)/util
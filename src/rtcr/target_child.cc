@@ -96,12 +96,13 @@ Genode::Service *Target_child::Custom_services::find(const char *service_name)
 
 
 
-Target_child::Resources::Resources(Genode::Env &env, const char *label, Custom_services &custom_services)
+Target_child::Resources::Resources(Genode::Env &env, const char *label, const char *filename,
+		Custom_services &custom_services)
 :
 	pd  (init_pd(label, *custom_services.pd_root)),
 	cpu (init_cpu(label, *custom_services.cpu_root)),
 	ram (init_ram(label, *custom_services.ram_root)),
-	rom (env, label)
+	rom (env, filename, label)
 {
 	// Donate ram quota to child
 	// TODO Replace static quota donation with the amount of quota, the child needs
@@ -187,9 +188,11 @@ Ram_session_component &Target_child::Resources::init_ram(const char *label, Ram_
 
 
 Target_child::Target_child(Genode::Env &env, Genode::Allocator &md_alloc,
-		Genode::Service_registry &parent_services, const char *name, Genode::size_t granularity)
+		Genode::Service_registry &parent_services, const char *name, Genode::size_t granularity,
+		const char *filename)
 :
 	_name            (name),
+	_filename        (filename ? filename : name),
 	_env             (env),
 	_md_alloc        (md_alloc),
 	_resources_ep    (_env, 16*1024, "resources ep"),
@@ -197,8 +200,11 @@ Target_child::Target_child(Genode::Env &env, Genode::Allocator &md_alloc,
 	_granularity     (granularity),
 	_restorer        (nullptr),
 	_in_bootstrap    (true),
+	_without_bootstrap (false),
+	_ready_service   (),
+	_ready_sigh      (),
 	_custom_services (_env, _md_alloc, _resources_ep, _granularity, _in_bootstrap),
-	_resources       (_env, _name.string(), _custom_services),
+	_resources       (_env, _name.string(), _filename.string(), _custom_services),
 	_initial_thread  (_resources.cpu, _resources.pd.cap(), _name.string()),
 	_address_space   (_resources.pd.address_space()),
 	_parent_services (parent_services),
@@ -257,6 +263,29 @@ void Target_child::start(Restorer &restorer)
 }
 
 
+void Target_child::start_without_bootstrap(Restorer &restorer)
+{
+	if(verbose_debug) Genode::log("Target_child::\033[33m", __func__, "\033[0m(from_restorer=", &restorer,")");
+
+	_in_bootstrap      = false;
+	_without_bootstrap = true;
+
+	// Without an ELF dataspace, Genode::Child neither loads the binary nor starts the initial thread
+	_child = new (_md_alloc) Genode::Child (
+			Genode::Dataspace_capability(),
+			Genode::Dataspace_capability(),
+			_resources.pd.cap(),  _resources.pd,
+			_resources.ram.cap(), _resources.ram,
+			_resources.cpu.cap(), _initial_thread,
+			_env.rm(), _address_space, _child_ep.rpc_ep(), *this,
+			*_custom_services.pd_service,
+			*_custom_services.ram_service,
+			*_custom_services.cpu_service);
+
+	restorer.restore();
+}
+
+
 void Target_child::print(Genode::Output &output) const
 {
 	using Genode::print;
@@ -498,6 +527,14 @@ Genode::Service *Target_child::resolve_session_request(const char *service_name,
 		_restorer = nullptr;
 	}
 
+	// Ready point hook
+	if(_ready_sigh.valid() && !Genode::strcmp(service_name, _ready_service.string()))
+	{
+		if(verbose_debug) Genode::log("  Ready point reached");
+		Genode::Signal_transmitter(_ready_sigh).submit();
+		_ready_sigh = Genode::Signal_context_capability();
+	}
+
 	Genode::Service *service = 0;
 
 	// Service known from parent?
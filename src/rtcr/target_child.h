@@ -14,6 +14,7 @@
 #include <base/snprintf.h>
 #include <rom_session/connection.h>
 #include <cpu_session/cpu_session.h>
+#include <base/signal.h>
 
 /* Rtcr includes */
 #include "intercept/pd_session.h"
@@ -28,7 +29,7 @@
 namespace Rtcr {
 	class Target_child;
 
-	constexpr bool child_verbose_debug = true;
+	constexpr bool child_verbose_debug = false;
 
 	// Forward declaration
 	class Restorer;
@@ -47,9 +48,13 @@ private:
 	static constexpr bool verbose_debug = child_verbose_debug;
 
 	/**
-	 * Child's unique name and filename of child's rom module
+	 * Child's unique name
 	 */
 	Genode::String<32>  _name;
+	/**
+	 * Filename of child's rom module
+	 */
+	Genode::String<32>  _filename;
 	/**
 	 * Local environment
 	 */
@@ -79,6 +84,18 @@ private:
 	 * Indicator whether child was bootstraped or not
 	 */
 	bool                _in_bootstrap;
+	/**
+	 * Indicator whether child was created without loading its ELF image and without bootstrap
+	 */
+	bool                _without_bootstrap;
+	/**
+	 * Service whose first session request marks the child's ready point
+	 */
+	Genode::String<32>              _ready_service;
+	/**
+	 * Signal context which is notified when the child reaches its ready point
+	 */
+	Genode::Signal_context_capability _ready_sigh;
 	/**
 	 * Struct for custom / intercepted services
 	 */
@@ -139,7 +156,7 @@ private:
 		 */
 		Genode::Rom_connection  rom;
 
-		Resources(Genode::Env &env, const char *label, Custom_services &custom_services);
+		Resources(Genode::Env &env, const char *label, const char *filename, Custom_services &custom_services);
 		~Resources();
 
 		Pd_session_component &init_pd(const char *label, Pd_root &pd_root);
@@ -171,11 +188,11 @@ public:
 	/**
 	 * Constructor
 	 *
-	 * TODO Separate child's name and filename to support multiple child's with the same rom module
+	 * \param filename Name of child's rom module; if it is null, name is used
 	 */
 	Target_child(Genode::Env &env, Genode::Allocator &md_alloc,
 			Genode::Service_registry &parent_services, const char *name,
-			Genode::size_t granularity);
+			Genode::size_t granularity, const char *filename = nullptr);
 
 	~Target_child();
 
@@ -203,10 +220,30 @@ public:
 	 * Start child from a checkpointed state
 	 */
 	void start(Restorer &restorer);
+	/**
+	 * Start child from a checkpointed state without loading its ELF image
+	 *
+	 * The child's PD, address space, threads and sessions are created by the restorer
+	 * directly from the checkpointed state. The child does not bootstrap; its threads
+	 * are started by the restorer after the memory content is restored.
+	 */
+	void start_without_bootstrap(Restorer &restorer);
+	/**
+	 * Register a signal handler for the child's ready point
+	 *
+	 * The ready point is the child's first session request for service, e.g. the
+	 * first service the child requests after its initialization. The handler is
+	 * notified once.
+	 */
+	void ready_sigh(Genode::Signal_context_capability sigh, const char *service)
+	{
+		_ready_service = service;
+		_ready_sigh    = sigh;
+	}
 	/**
 	 * Pause child
 	 */
-	void pause()  { _resources.cpu.pause_threads();  }
+	void pause()  { _resources.cpu.pause_threads(); }
 	/**
 	 * Resume child
 	 */
@@ -221,6 +258,7 @@ public:
 	 ****************************/
 
 	const char *name() const { return _name.string(); }
+	const char *filename() const { return _filename.string(); }
 	Genode::Service *resolve_session_request(const char *service_name, const char *args);
 	void filter_session_args(const char *service, char *args, Genode::size_t args_len);
 
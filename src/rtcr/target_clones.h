@@ -0,0 +1,224 @@
+/*
+ * \brief  Group of targets cloned from one checkpointed Target_state
+ * \author agent
+ * \date   2026-10-18
+ *
+ * Each clone is a Target_child which is restored from the same Target_state.
+ * The clones use incremental checkpointing and restore the content of their
+ * managed dataspaces on the first access (Restorer::ON_FIRST_ACCESS). Thus,
+ * starting a clone is a restore of metadata, and all clones read the memory
+ * content from the shared stored dataspaces of the Target_state. The state is
+ * held by a reference-counted Target_snapshot, which also keeps the analysis
+ * of the state compiled into a Restore_plan for the restorers of all clones.
+ */
+
+#ifndef _RTCR_TARGET_CLONES_H_
+#define _RTCR_TARGET_CLONES_H_
+
+/* Genode includes */
+#include <util/list.h>
+#include <base/service.h>
+#include <base/snprintf.h>
+
+/* Rtcr includes */
+#include "target_child.h"
+#include "target_state.h"
+#include "restorer.h"
+#include "restore_plan.h"
+
+namespace Rtcr {
+	class Target_snapshot;
+	class Target_clones;
+
+	constexpr bool clones_verbose_debug = false;
+}
+
+
+/**
+ * Target_state shared by a target and the clones restored from it
+ *
+ * The snapshot is destroyed by the holder which releases the last reference.
+ * A holder must not change the state while it is shared.
+ */
+class Rtcr::Target_snapshot
+{
+private:
+	Genode::Allocator &_alloc;
+	/**
+	 * Plan of state compiled for the first clone; it is dropped when state changes
+	 */
+	Restore_plan      *_plan;
+	unsigned           _refs;
+
+	/*
+	 * Noncopyable
+	 */
+	Target_snapshot(Target_snapshot const &);
+	Target_snapshot &operator = (Target_snapshot const &);
+
+public:
+	Target_state state;
+
+	/**
+	 * Constructor; the creator holds the first reference
+	 */
+	Target_snapshot(Genode::Env &env, Genode::Allocator &alloc)
+	:
+		_alloc(alloc), _plan(nullptr), _refs(1), state(env, alloc)
+	{ }
+
+	~Target_snapshot() { invalidate_plan(); }
+
+	void acquire() { _refs++; }
+
+	/**
+	 * Release a reference
+	 *
+	 * \return true, if it was the last reference; the caller destroys the snapshot
+	 */
+	bool release() { return !--_refs; }
+
+	bool shared() const { return _refs > 1; }
+
+	Restore_plan const &plan()
+	{
+		if(!_plan) _plan = new (_alloc) Restore_plan(_alloc, state);
+		return *_plan;
+	}
+
+	/**
+	 * Drop the plan, because state is going to change
+	 */
+	void invalidate_plan()
+	{
+		if(_plan) Genode::destroy(_alloc, _plan);
+		_plan = nullptr;
+	}
+};
+
+
+class Rtcr::Target_clones
+{
+public:
+	typedef Genode::String<32> Name;
+
+private:
+	/**
+	 * Enable log output for debugging
+	 */
+	static constexpr bool verbose_debug = clones_verbose_debug;
+
+	struct Clone : Genode::List<Clone>::Element
+	{
+		Name            const  name;
+		/**
+		 * Snapshot from which the clone restores its memory content on the first access
+		 */
+		Target_snapshot       &snapshot;
+		Target_child           child;
+		Restorer               restorer;
+
+		Clone(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services,
+				Name const &name, char const *filename, Genode::size_t granularity, Target_snapshot &snapshot)
+		:
+			name     (name),
+			snapshot (snapshot),
+			child    (env, alloc, parent_services, this->name.string(), granularity, filename),
+			restorer (alloc, child, snapshot.state, Parallel_copy::Config(), Restorer::ON_FIRST_ACCESS,
+			          &snapshot.plan())
+		{ }
+	};
+
+	Genode::Env              &_env;
+	Genode::Allocator        &_alloc;
+	Genode::Service_registry &_parent_services;
+	Genode::List<Clone>       _clones;
+	unsigned                  _next_id;
+
+	/*
+	 * Noncopyable
+	 */
+	Target_clones(Target_clones const &);
+	Target_clones &operator = (Target_clones const &);
+
+	void _destroy(Clone *clone)
+	{
+		Target_snapshot &snapshot = clone->snapshot;
+
+		_clones.remove(clone);
+		Genode::destroy(_alloc, clone);
+
+		if(snapshot.release()) Genode::destroy(_alloc, &snapshot);
+	}
+
+public:
+	Target_clones(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services)
+	:
+		_env(env), _alloc(alloc), _parent_services(parent_services), _clones(), _next_id(0)
+	{ }
+
+	~Target_clones() { destroy(); }
+
+	/**
+	 * Create and start count clones of the checkpointed target
+	 *
+	 * The clones are named "<filename>.<n>". Each clone holds a reference to snapshot.
+	 *
+	 * \param filename    Name of the rom module of the checkpointed target
+	 * \param granularity Size of designated dataspaces in pages; it has to be greater than zero
+	 */
+	void create(char const *filename, unsigned count, Genode::size_t granularity, Target_snapshot &snapshot)
+	{
+		if(verbose_debug) Genode::log("Clones::\033[33m", __func__, "\033[0m(", filename, ", count=", count, ")");
+
+		if(!granularity)
+		{
+			Genode::error("Clones need incremental checkpointing (granularity > 0)");
+			throw Genode::Exception();
+		}
+
+		for(unsigned i = 0; i < count; i++)
+		{
+			char name[32];
+			Genode::snprintf(name, sizeof(name), "%s.%u", filename, _next_id++);
+
+			Clone *clone = new (_alloc) Clone(_env, _alloc, _parent_services, Name(name),
+					filename, granularity, snapshot);
+			snapshot.acquire();
+			_clones.insert(clone);
+
+			// The clone is created directly from the checkpointed state without bootstrap
+			clone->child.start_without_bootstrap(clone->restorer);
+		}
+	}
+
+	/**
+	 * Destroy all clones
+	 *
+	 * \return number of destroyed clones
+	 */
+	unsigned destroy()
+	{
+		if(verbose_debug) Genode::log("Clones::\033[33m", __func__, "\033[0m()");
+
+		unsigned result = 0;
+		for(; _clones.first(); result++) _destroy(_clones.first());
+		return result;
+	}
+
+	unsigned count() const
+	{
+		unsigned result = 0;
+		for(Clone const *clone = _clones.first(); clone; clone = clone->next()) result++;
+		return result;
+	}
+
+	template<typename FUNC>
+	void for_each(FUNC const &func)
+	{
+		for(Clone *clone = _clones.first(); clone; clone = clone->next())
+			func(clone->child);
+	}
+};
+
+#endif /* _RTCR_TARGET_CLONES_H_ */
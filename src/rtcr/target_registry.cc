@@ -0,0 +1,489 @@
+/*
+ * \brief  Registry of the targets managed by Rtcr
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#include "target_registry.h"
+#include "rollback.h"
+
+using namespace Rtcr;
+
+
+void Target_registry::Target::_create_checkpointer()
+{
+	_ckpt = new (_alloc) Checkpointer(_alloc, *_child, _snapshot->state);
+	_ckpt->phase_log(&_phases);
+	if(_standby) _ckpt->delta(&_standby->delta());
+}
+
+
+void Target_registry::Target::_destroy_child()
+{
+	if(_ckpt)     Genode::destroy(_alloc, _ckpt);
+	if(_restorer) Genode::destroy(_alloc, _restorer);
+	if(_child)    Genode::destroy(_alloc, _child);
+	_ckpt     = nullptr;
+	_restorer = nullptr;
+	_child    = nullptr;
+}
+
+
+Target_registry::Target::Target(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services,
+		Name const &name, Genode::size_t granularity, char const *ready_service,
+		Parallel_copy::Config const &copy_config, unsigned generations, Standby::Config const &standby)
+:
+	_env(env), _alloc(alloc), _parent_services(parent_services),
+	_name(name), _granularity(granularity), _copy_config(copy_config), _max_generations(generations),
+	_lock(), _snapshot(new (alloc) Target_snapshot(env, alloc)),
+	_child(nullptr), _ckpt(nullptr), _restorer(nullptr), _copy(nullptr), _clones(nullptr), _standby(nullptr),
+	_generation(0), _snapshot_generation(0), _generations(),
+	_state_of_child(false), _bytes_copied(0), _pause_ms(0), _budget_held(true),
+	_phases(), _copier(nullptr), _deferred_pending(false),
+	_ready_handler(env.ep(), *this, &Target::_handle_ready),
+	_standby_handler(env.ep(), *this, &Target::_handle_standby)
+{
+	if(verbose_debug) Genode::log("\033[33m", "Target", "\033[0m(", _name, ", granularity=", granularity, ")");
+
+	try
+	{
+		_child = new (_alloc) Target_child(_env, _alloc, _parent_services, _name.string(), _granularity);
+	}
+	catch(Genode::Rom_connection::Rom_connection_failed)
+	{
+		Genode::error("Rom module ", _name, " does not exist");
+		throw Rtcr::Session::Rom_module_does_not_exist();
+	}
+
+	// The target is not waited for, thus, a target which never reaches its ready point blocks nobody
+	if(ready_service) _child->ready_sigh(_ready_handler, ready_service);
+
+	// The replica is restored without bootstrap; it needs designated dataspaces
+	if(standby.enabled && !_granularity) Genode::warning("Target ", _name, " has no standby without granularity");
+	else if(standby.enabled) _standby = new (_alloc) Standby(_env, _alloc, _parent_services, _name.string(),
+			_name.string(), _granularity, standby.cadence_ms, _standby_handler);
+
+	_child->start();
+	_create_checkpointer();
+}
+
+
+void Target_registry::Target::_handle_ready()
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	Try_lock::Guard guard(_lock);
+
+	// The checkpoint at the ready point is the image from which the clones skip the initialization
+	if(!_generation) checkpoint();
+}
+
+
+void Target_registry::Target::_handle_standby()
+{
+	// The entrypoint does not wait for a running operation; the next period checkpoints the target
+	if(!_lock.try_lock()) return;
+
+	Try_lock::Taken taken(_lock);
+	if(_standby && _standby->cadence()) checkpoint();
+}
+
+
+Target_registry::Target::~Target()
+{
+	if(_copier)
+	{
+		_copier->shutdown = true;
+		_copier->copy.up();
+		_copier->join();
+		Genode::destroy(_alloc, _copier);
+	}
+	if(_standby)
+	{
+		if(_ckpt) _ckpt->delta(nullptr);
+		Genode::destroy(_alloc, _standby);
+		_standby = nullptr;
+	}
+	_wait_for_deferred();
+
+	if(_clones) Genode::destroy(_alloc, _clones);
+	_destroy_child();
+	if(_copy) Genode::destroy(_alloc, _copy);
+	if(_snapshot->release()) Genode::destroy(_alloc, _snapshot);
+
+	while(Generation *generation = _generations.first())
+	{
+		_generations.remove(generation);
+		Genode::destroy(_alloc, generation);
+	}
+}
+
+
+void Target_registry::Target::_new_snapshot()
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	// The checkpointer and the restorer refer to the old snapshot
+	if(_ckpt)     Genode::destroy(_alloc, _ckpt);
+	if(_restorer) Genode::destroy(_alloc, _restorer);
+	_restorer = nullptr;
+
+	// The snapshot is shared, thus, the clones hold the remaining references; the replica is restored from the new one
+	if(_standby) _standby->discard();
+	_snapshot->release();
+	_snapshot = new (_alloc) Target_snapshot(_env, _alloc);
+
+	_create_checkpointer();
+
+	// The new snapshot holds no content; mark all memory dirty to copy it by the next checkpoint
+	for_each_managed_dataspace([&] (Ram_dataspace_info &ramds) {
+		ramds.mrm_info->attach_designated_dataspaces(_env.pd().native_pd()); });
+
+	_state_of_child = false;
+}
+
+
+void Target_registry::Target::_finish_deferred()
+{
+	Phase_log::Timestamp const t = Phase_log::now();
+
+	Genode::size_t const paused_copied = _ckpt->bytes_copied();
+	_ckpt->finish_deferred();
+	_phases.phase(Phase_log::Phase_record::FINISH_DEFERRED, t, 0, _ckpt->bytes_copied() - paused_copied);
+
+	_phases.end();
+
+	_bytes_copied     = _ckpt->bytes_copied();
+	_deferred_pending = false;
+
+	// The memory of the checkpoint is complete; the standby applies what the checkpoint copied
+	if(_standby) _standby->update(_snapshot->state);
+}
+
+
+void Target_registry::Target::_wait_for_deferred()
+{
+	if(_deferred_pending) _finish_deferred();
+}
+
+
+void Target_registry::Target::_keep_generation()
+{
+	if(!_max_generations || !_snapshot_generation || _find_generation(_snapshot_generation)) return;
+
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__,
+			"\033[0m(generation=", _snapshot_generation, ")");
+
+	Phase_log::Timestamp const t = Phase_log::now();
+
+	Generation *kept = new (_alloc) Generation(_env, _alloc, _snapshot_generation, _snapshot->state);
+	_generations.insert(kept);
+
+	_phases.phase(Phase_log::Phase_record::KEEP_GENERATION, t, kept->state.num_objects(),
+			kept->state.content_bytes());
+
+	// Drop the least recently kept generations beyond the bound
+	Generation *last = kept;
+	for(unsigned count = 1; count < _max_generations && last->next(); count++) last = last->next();
+	while(Generation *dropped = last->next())
+	{
+		_generations.remove(dropped);
+		Genode::destroy(_alloc, dropped);
+	}
+}
+
+
+Target_snapshot *Target_registry::Target::_expand_generation(unsigned number)
+{
+	Generation *generation = _find_generation(number);
+	if(!generation) throw Rtcr::Session::Checkpoint_does_not_exist();
+
+	Phase_log::Timestamp const t = Phase_log::now();
+
+	Target_snapshot *snapshot = new (_alloc) Target_snapshot(_env, _alloc);
+	generation->state.expand(snapshot->state);
+
+	_phases.phase(Phase_log::Phase_record::EXPAND_GENERATION, t, generation->state.num_objects(),
+			generation->state.content_bytes());
+
+	return snapshot;
+}
+
+
+void Target_registry::Target::dirty_set(Genode::size_t &bytes, unsigned &dataspaces)
+{
+	bytes      = 0;
+	dataspaces = 0;
+
+	Ram_session_component *ram_session = _child->custom_services().ram_root->session_infos().first();
+	for(; ram_session; ram_session = ram_session->next())
+	{
+		// The child allocates and frees dataspaces while it runs
+		Genode::Lock::Guard ramds_guard(ram_session->parent_state().ram_dataspaces_lock);
+
+		Ram_dataspace_info *ramds = ram_session->parent_state().ram_dataspaces.first();
+		for(; ramds; ramds = ramds->next())
+		{
+			if(!ramds->mrm_info)
+			{
+				bytes += ramds->size;
+				dataspaces++;
+				continue;
+			}
+
+			Designated_dataspace_info *dd_info = ramds->mrm_info->dd_infos.first();
+			for(; dd_info; dd_info = dd_info->next())
+			{
+				if(!dd_info->attached) continue;
+				bytes += dd_info->size;
+				dataspaces++;
+			}
+		}
+	}
+}
+
+
+Rtcr::Session::Prediction Target_registry::Target::predict(Calibration const &calibration)
+{
+	Genode::size_t bytes = 0;
+	unsigned dataspaces  = 0;
+	dirty_set(bytes, dataspaces);
+
+	Rtcr::Session::Prediction prediction;
+	prediction.dirty_bytes      = bytes;
+	prediction.dirty_dataspaces = dataspaces;
+	prediction.pause_us         = calibration.checkpoint_pause_us(bytes, dataspaces);
+	prediction.refault_us       = calibration.refault_us(dataspaces);
+	prediction.restore_us       = _generation ? calibration.restore_us(_ckpt->checkpointed_bytes(),
+			_ckpt->checkpointed_dataspaces(), _ckpt->capabilities()) : 0;
+
+	return prediction;
+}
+
+
+unsigned Target_registry::Target::checkpoint(unsigned pause_budget_ms)
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__,
+			"\033[0m(pause_budget_ms=", pause_budget_ms, ")");
+
+	// The memory of the previous checkpoint has to be complete before it is overwritten
+	_wait_for_deferred();
+
+	_phases.begin(Phase_log::Operation_record::CHECKPOINT);
+
+	// The previous generation is kept while the target runs; it is compacted before the pause
+	_keep_generation();
+
+	// The clones read their memory content from the snapshot on the first access
+	if(_snapshot->shared()) _new_snapshot();
+	else _snapshot->invalidate_plan();
+
+	// The checkpoint frees and allocates stored dataspaces, whose badges the kept mappings could match
+	if(_copy) _copy->detach_all();
+
+	_snapshot_generation = ++_generation;
+
+	_ckpt->checkpoint(pause_budget_ms);
+
+	Phase_log::Timestamp t = Phase_log::now();
+	_child->resume();
+	_phases.phase(Phase_log::Phase_record::RESUME, t);
+
+	// The pause ends when the child runs again
+	_ckpt->resumed();
+
+	_bytes_copied = _ckpt->bytes_copied();
+	_pause_ms     = _ckpt->pause_ms();
+	_budget_held  = _ckpt->budget_held();
+
+	_state_of_child   = true;
+	_deferred_pending = true;
+
+	// Without a budget, no memory is deferred; the copier keeps the latency of the call bounded otherwise
+	if(!pause_budget_ms)
+	{
+		_finish_deferred();
+		return _generation;
+	}
+
+	if(!_copier)
+	{
+		_copier = new (_alloc) Deferred_copier(_env, *this);
+		_copier->start();
+	}
+	_copier->copy.up();
+
+	return _generation;
+}
+
+
+void Target_registry::Target::restore(unsigned generation)
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__,
+			"\033[0m(generation=", generation, ")");
+
+	if(!_generation) throw Rtcr::Session::Checkpoint_does_not_exist();
+	if(generation == _snapshot_generation) generation = 0;
+	if(generation && !_find_generation(generation)) throw Rtcr::Session::Checkpoint_does_not_exist();
+
+	_wait_for_deferred();
+
+	_phases.begin(Phase_log::Operation_record::RESTORE);
+
+	// An older generation replaces the snapshot; the replaced one is kept for a later restore
+	if(generation)
+	{
+		Target_snapshot *snapshot = _expand_generation(generation);
+		_keep_generation();
+
+		if(_ckpt)     Genode::destroy(_alloc, _ckpt);
+		if(_restorer) Genode::destroy(_alloc, _restorer);
+		_ckpt     = nullptr;
+		_restorer = nullptr;
+
+		// The clones hold the remaining references of a shared snapshot
+		if(_standby) _standby->discard();
+		if(_snapshot->release()) Genode::destroy(_alloc, _snapshot);
+		_snapshot            = snapshot;
+		_snapshot_generation = generation;
+
+		// The kept mappings refer to the stored memory of the replaced snapshot
+		if(_copy) _copy->detach_all();
+
+		// The child was not checkpointed into the expanded snapshot; it is replaced
+		_state_of_child = false;
+	}
+
+	// Rolling back reuses the child and reverts only the memory written since the checkpoint
+	if(_state_of_child)
+	{
+		Phase_log::Timestamp const t = Phase_log::now();
+		Rollback rollback(_alloc, *_child, _snapshot->state);
+		bool const rolled_back = rollback.rollback();
+		_phases.phase(Phase_log::Phase_record::ROLLBACK, t, 0, rollback.bytes_copied());
+		if(rolled_back)
+		{
+			_bytes_copied = rollback.bytes_copied();
+			_phases.end();
+			return;
+		}
+	}
+
+	// Replace the child by a child restored from the checkpoint
+	_destroy_child();
+
+	if(!_copy) _copy = new (_alloc) Parallel_copy(_env, _alloc, _copy_config);
+
+	// The plan is compiled once per checkpoint; repeated restores of the same checkpoint reuse it
+	_child    = new (_alloc) Target_child(_env, _alloc, _parent_services, _name.string(), _granularity);
+	_restorer = new (_alloc) Restorer(_alloc, *_child, _snapshot->state, _copy_config, Restorer::EAGER,
+			&_snapshot->plan(), _copy);
+	_restorer->phase_log(&_phases);
+	_child->start_without_bootstrap(*_restorer);
+	_create_checkpointer();
+
+	_phases.end();
+
+	_bytes_copied = _restorer->bytes_copied();
+
+	// The badges of the new child differ from the checkpoint until the next checkpoint
+	_state_of_child = false;
+}
+
+
+unsigned Target_registry::Target::clone(unsigned count, unsigned generation)
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m(count=", count,
+			", generation=", generation, ")");
+
+	if(!_generation) throw Rtcr::Session::Checkpoint_does_not_exist();
+	if(generation == _snapshot_generation) generation = 0;
+	if(generation && !_find_generation(generation)) throw Rtcr::Session::Checkpoint_does_not_exist();
+
+	// The clones read the memory of the checkpoint
+	_wait_for_deferred();
+
+	if(!_clones) _clones = new (_alloc) Target_clones(_env, _alloc, _parent_services);
+
+	// Clones restore their memory on the first access; they need designated dataspaces
+	if(!generation)
+	{
+		_clones->create(_name.string(), count, _granularity ? _granularity : 1, *_snapshot);
+		return count;
+	}
+
+	// The clones of an older generation share a snapshot expanded for them; they hold its references
+	Target_snapshot *snapshot = _expand_generation(generation);
+	try
+	{
+		_clones->create(_name.string(), count, _granularity ? _granularity : 1, *snapshot);
+	}
+	catch(...)
+	{
+		if(snapshot->release()) Genode::destroy(_alloc, snapshot);
+		throw;
+	}
+	if(snapshot->release()) Genode::destroy(_alloc, snapshot);
+
+	return count;
+}
+
+
+void Target_registry::Target::failover()
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	if(!_standby) throw Rtcr::Session::Checkpoint_does_not_exist();
+
+	// The replica is updated by the completion of the last checkpoint
+	_wait_for_deferred();
+	if(!_standby->ready()) throw Rtcr::Session::Checkpoint_does_not_exist();
+
+	_destroy_child();
+	_standby->failover(_child, _restorer);
+	_create_checkpointer();
+
+	// The badges of the replica differ from the checkpoint until the next checkpoint
+	_state_of_child = false;
+}
+
+
+unsigned Target_registry::Target::destroy_clones()
+{
+	if(verbose_debug) Genode::log("Target<\033[35m", _name, "\033[0m>::\033[33m", __func__, "\033[0m()");
+
+	return _clones ? _clones->destroy() : 0;
+}
+
+
+Target_registry::~Target_registry()
+{
+	while(Target *target = _targets.first())
+	{
+		_targets.remove(target);
+		Genode::destroy(_alloc, target);
+	}
+}
+
+
+void Target_registry::start(Name const &name, Genode::size_t granularity, char const *ready_service,
+		Parallel_copy::Config const &copy_config, unsigned generations, Standby::Config const &standby)
+{
+	if(_find(name)) throw Rtcr::Session::Target_already_exists();
+
+	// The target is started without holding the lock of the registry
+	Target *target = new (_alloc) Target(_env, _alloc, _parent_services, name, granularity, ready_service,
+			copy_config, generations, standby);
+
+	Genode::Lock::Guard guard(_lock);
+
+	Target *existing = _targets.first();
+	if(existing) existing = existing->find_by_name(name);
+	if(existing)
+	{
+		Genode::destroy(_alloc, target);
+		throw Rtcr::Session::Target_already_exists();
+	}
+
+	_targets.insert(target);
+}
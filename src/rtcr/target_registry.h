@@ -0,0 +1,509 @@
+/*
+ * \brief  Registry of the targets managed by Rtcr
+ * \author agent
+ * \date   2026-10-18
+ *
+ * Each target is a Target_child started from its rom module with its own
+ * granularity for incremental checkpointing, its Target_state, and the
+ * generation of the last checkpoint. A bounded number of older generations is
+ * kept as Compact_target_state; they are restored or cloned by their number.
+ * Operations on a target are serialized by the lock of the target; the lock
+ * of the registry only protects the list of targets. Thus, operations on
+ * different targets run concurrently. The signal handlers of the entrypoint
+ * use try_apply() and try_for_each(), which skip a target during its
+ * operation instead of blocking the entrypoint. A target may keep a Standby,
+ * which is fed by the checkpoints of the target and takes over on failover().
+ */
+
+#ifndef _RTCR_TARGET_REGISTRY_H_
+#define _RTCR_TARGET_REGISTRY_H_
+
+/* Genode includes */
+#include <util/list.h>
+#include <util/string.h>
+#include <base/lock.h>
+#include <base/service.h>
+#include <base/signal.h>
+#include <base/thread.h>
+#include <base/semaphore.h>
+#include <rtcr_session/rtcr_session.h>
+
+/* Rtcr includes */
+#include "target_child.h"
+#include "target_state.h"
+#include "target_clones.h"
+#include "checkpointer.h"
+#include "restorer.h"
+#include "calibration.h"
+#include "standby.h"
+#include "offline_storage/compact_target_state.h"
+#include "util/phase_log.h"
+#include "util/try_lock.h"
+
+namespace Rtcr {
+	class Target_registry;
+
+	constexpr bool registry_verbose_debug = false;
+}
+
+
+class Rtcr::Target_registry
+{
+public:
+	typedef Genode::String<32> Name;
+
+	class Target : public Genode::List<Target>::Element
+	{
+	public:
+		enum { DEFAULT_GENERATIONS = 2 };
+
+	private:
+		/**
+		 * Enable log output for debugging
+		 */
+		static constexpr bool verbose_debug = registry_verbose_debug;
+
+		/**
+		 * Older checkpoint generation in compact form
+		 */
+		struct Generation : Genode::List<Generation>::Element
+		{
+			unsigned             const number;
+			Compact_target_state       state;
+
+			Generation(Genode::Env &env, Genode::Allocator &alloc, unsigned number, Target_state const &target_state)
+			:
+				number(number), state(env, alloc, target_state)
+			{ }
+
+			Generation *find_by_number(unsigned number)
+			{
+				if(number == this->number)
+					return this;
+				Generation *generation = next();
+				return generation ? generation->find_by_number(number) : 0;
+			}
+		};
+
+		/**
+		 * Copies the memory deferred by a budgeted checkpoint while the target runs
+		 */
+		struct Deferred_copier : Genode::Thread
+		{
+			Target            &target;
+			Genode::Semaphore  copy;
+			bool               shutdown;
+
+			Deferred_copier(Genode::Env &env, Target &target)
+			:
+				Thread(env, "rtcr_deferred", 32*1024),
+				target(target), copy(0), shutdown(false)
+			{ }
+
+			void entry() override
+			{
+				Event_trace::Thread_scope trace_scope;
+
+				for(;;)
+				{
+					copy.down();
+					if(shutdown) return;
+
+					// The next operation on the target may have finished the copy already
+					Try_lock::Guard guard(target._lock);
+					if(target._deferred_pending) target._finish_deferred();
+				}
+			}
+		};
+
+		Genode::Env              &_env;
+		Genode::Allocator        &_alloc;
+		Genode::Service_registry &_parent_services;
+		Name               const  _name;
+		Genode::size_t     const  _granularity;
+		/**
+		 * Workers and CPUs copying the memory of a restore
+		 */
+		Parallel_copy::Config const _copy_config;
+		/**
+		 * Number of older generations kept in _generations
+		 */
+		unsigned           const  _max_generations;
+		/**
+		 * Serializes the operations on this target
+		 */
+		Try_lock                  _lock;
+		/**
+		 * Checkpoint of the target; the clones restored from it hold references to it
+		 */
+		Target_snapshot          *_snapshot;
+		Target_child             *_child;
+		Checkpointer             *_ckpt;
+		/**
+		 * Restorer of _child, if it replaced the checkpointed child
+		 */
+		Restorer                 *_restorer;
+		/**
+		 * Copy engine of the restores, created by the first restore; its mappings of the stored
+		 * memory are kept until the next checkpoint changes the stored memory
+		 */
+		Parallel_copy            *_copy;
+		Target_clones            *_clones;
+		/**
+		 * Replica fed by the checkpoints of the target; may be null
+		 */
+		Standby                  *_standby;
+		/**
+		 * Generation of the last checkpoint; zero means there is no checkpoint
+		 */
+		unsigned                  _generation;
+		/**
+		 * Generation in _snapshot; it is older than _generation after an older generation was restored
+		 */
+		unsigned                  _snapshot_generation;
+		/**
+		 * Older generations, the most recently kept first
+		 */
+		Genode::List<Generation>  _generations;
+		/**
+		 * Whether _snapshot was checkpointed from _child
+		 */
+		bool                      _state_of_child;
+		/**
+		 * Bytes of memory copied by the last checkpoint or restore
+		 */
+		Genode::size_t            _bytes_copied;
+		/**
+		 * Pause of the target by the last checkpoint, and whether it kept its budget
+		 */
+		unsigned long             _pause_ms;
+		bool                      _budget_held;
+		/**
+		 * Phase timings of the last checkpoints and restores; it persists when _child is replaced
+		 */
+		Phase_log                 _phases;
+		/**
+		 * Created by the first budgeted checkpoint
+		 */
+		Deferred_copier          *_copier;
+		/**
+		 * Whether the memory deferred by the last checkpoint is not yet copied
+		 */
+		bool                      _deferred_pending;
+		/**
+		 * Checkpoints a warm-booted target at its ready point
+		 */
+		Genode::Signal_handler<Target> _ready_handler;
+		/**
+		 * Checkpoints the target at the cadence of its standby
+		 */
+		Genode::Signal_handler<Target> _standby_handler;
+
+		/*
+		 * Noncopyable
+		 */
+		Target(Target const &);
+		Target &operator = (Target const &);
+
+		void _destroy_child();
+		/**
+		 * Create the checkpointer of _child into _snapshot, which records for the phase log and the standby
+		 */
+		void _create_checkpointer();
+		/**
+		 * Leave _snapshot to the clones and checkpoint into a new snapshot
+		 */
+		void _new_snapshot();
+		/**
+		 * Copy the memory deferred by the last checkpoint and end its operation in _phases; _lock has to be held
+		 */
+		void _finish_deferred();
+		/**
+		 * Complete the last checkpoint, if _copier did not yet; _ckpt and _snapshot are complete afterwards
+		 *
+		 * _lock has to be held. The copier takes _lock for the copy, thus, the caller copies the
+		 * remaining memory itself instead of waiting for the copier.
+		 */
+		void _wait_for_deferred();
+		/**
+		 * Checkpoint the target at its ready point; the checkpoint is generation 1
+		 */
+		void _handle_ready();
+		/**
+		 * Checkpoint the target for its standby, unless an operation on the target runs
+		 */
+		void _handle_standby();
+		/**
+		 * Keep the generation in _snapshot in compact form, before the next checkpoint overwrites it
+		 *
+		 * The least recently kept generation is dropped, if there are more than _max_generations.
+		 * The snapshot has to be complete, i.e. _wait_for_deferred() was called.
+		 */
+		void _keep_generation();
+		Generation *_find_generation(unsigned number)
+		{
+			Generation *generation = _generations.first();
+			return generation ? generation->find_by_number(number) : nullptr;
+		}
+		/**
+		 * Return a new snapshot expanded from the kept generation number
+		 *
+		 * \throw Rtcr::Session::Checkpoint_does_not_exist
+		 */
+		Target_snapshot *_expand_generation(unsigned number);
+
+	public:
+		/**
+		 * Constructor; starts the target from its rom module
+		 *
+		 * \param ready_service If not null, the target is warm-booted: when the target requests a
+		 *                      session of ready_service (its ready point), it is checkpointed by a
+		 *                      signal handler of env.ep(); its clones start from this checkpoint
+		 * \param copy_config   Workers and CPUs copying the memory of a restore
+		 * \param generations   Number of older generations kept for restore and clone
+		 * \param standby       Standby of the target; it needs a granularity greater than zero
+		 *
+		 * \throw Rtcr::Session::Rom_module_does_not_exist
+		 */
+		Target(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services,
+				Name const &name, Genode::size_t granularity, char const *ready_service = nullptr,
+				Parallel_copy::Config const &copy_config = Parallel_copy::Config(),
+				unsigned generations = DEFAULT_GENERATIONS,
+				Standby::Config const &standby = Standby::Config());
+		~Target();
+
+		Name const &name() const { return _name; }
+		Genode::size_t granularity() const { return _granularity; }
+		unsigned generation() const { return _generation; }
+		/**
+		 * Generation from which the target continues; it differs from generation() after an
+		 * older generation was restored
+		 */
+		unsigned snapshot_generation() const { return _snapshot_generation; }
+		/**
+		 * Bytes copied by the last checkpoint or restore; the bytes copied by a budgeted
+		 * checkpoint after its target was resumed are added when they are copied
+		 */
+		Genode::size_t bytes_copied() const { return _bytes_copied; }
+		unsigned long pause_ms() const { return _pause_ms; }
+		bool budget_held() const { return _budget_held; }
+		/**
+		 * Memory written by the target since the last checkpoint, i.e. the memory of
+		 * the designated dataspaces attached by faults and the unmanaged RAM dataspaces
+		 */
+		void dirty_set(Genode::size_t &bytes, unsigned &dataspaces);
+		Genode::size_t dirty_bytes()
+		{
+			Genode::size_t bytes = 0;
+			unsigned dataspaces  = 0;
+			dirty_set(bytes, dataspaces);
+			return bytes;
+		}
+		/**
+		 * Predict the cost of the next checkpoint from the dirty set and the calibrated costs
+		 */
+		Rtcr::Session::Prediction predict(Calibration const &calibration);
+		Phase_log &phases() { return _phases; }
+
+		/**
+		 * Call func with each managed Ram_dataspace_info of the target
+		 *
+		 * The RAM sessions of the child may allocate and free dataspaces meanwhile; their
+		 * lists are locked during the calls of func.
+		 */
+		template<typename FUNC>
+		void for_each_managed_dataspace(FUNC const &func)
+		{
+			Ram_session_component *ram_session = _child->custom_services().ram_root->session_infos().first();
+			for(; ram_session; ram_session = ram_session->next())
+			{
+				Genode::Lock::Guard guard(ram_session->parent_state().ram_dataspaces_lock);
+
+				Ram_dataspace_info *ramds = ram_session->parent_state().ram_dataspaces.first();
+				for(; ramds; ramds = ramds->next())
+					if(ramds->mrm_info) func(*ramds);
+			}
+		}
+		Try_lock &lock() { return _lock; }
+
+		/**
+		 * Checkpoint the target into its Target_state
+		 *
+		 * The Target_state holds the last generation; the checkpoint replaces it after the
+		 * previous generation is kept in compact form. If clones share the Target_state, the
+		 * target is checkpointed into a new Target_state; the first checkpoint into it copies
+		 * the whole memory.
+		 *
+		 * \param pause_budget_ms  If not zero, the target is resumed after at most pause_budget_ms, if
+		 *                         possible; the remaining memory is copied by a helper thread while the
+		 *                         target runs, and its designated dataspaces are saved on their first
+		 *                         access. The call returns after the target is resumed; the next
+		 *                         checkpoint, restore, or clone waits for the remaining memory
+		 *
+		 * \return generation of the checkpoint
+		 */
+		unsigned checkpoint(unsigned pause_budget_ms = 0);
+		/**
+		 * Roll back the target in place or replace it by a target restored from the checkpoint
+		 *
+		 * \param generation Generation to restore; zero means the last one. An older generation
+		 *                   is expanded from its compact form, and the target is replaced
+		 *
+		 * \throw Rtcr::Session::Checkpoint_does_not_exist
+		 */
+		void restore(unsigned generation = 0);
+		/**
+		 * Start count clones of the checkpointed target
+		 *
+		 * \param generation Generation from which the clones start; zero means the last one
+		 *
+		 * \throw Rtcr::Session::Checkpoint_does_not_exist
+		 */
+		unsigned clone(unsigned count, unsigned generation = 0);
+		/**
+		 * Replace the target by its standby replica, which continues from the last checkpoint
+		 *
+		 * The standby restores a new replica from the next checkpoint.
+		 *
+		 * \throw Rtcr::Session::Checkpoint_does_not_exist  if the target has no standby or no checkpoint
+		 */
+		void failover();
+		/**
+		 * Destroy the clones of the target
+		 *
+		 * \return number of destroyed clones
+		 */
+		unsigned destroy_clones();
+
+		Target *find_by_name(Name const &name)
+		{
+			if(name == _name)
+				return this;
+			Target *target = next();
+			return target ? target->find_by_name(name) : 0;
+		}
+	};
+
+private:
+	Genode::Env              &_env;
+	Genode::Allocator        &_alloc;
+	Genode::Service_registry &_parent_services;
+	/**
+	 * Protects _targets; it is not held during operations on a target
+	 */
+	Genode::Lock              _lock;
+	Genode::List<Target>      _targets;
+
+	/*
+	 * Noncopyable
+	 */
+	Target_registry(Target_registry const &);
+	Target_registry &operator = (Target_registry const &);
+
+	Target *_find(Name const &name)
+	{
+		Genode::Lock::Guard guard(_lock);
+		Target *target = _targets.first();
+		return target ? target->find_by_name(name) : nullptr;
+	}
+
+	/**
+	 * Return the target following target, or the first target, if target is null
+	 */
+	Target *_find_next(Target *target)
+	{
+		Genode::Lock::Guard guard(_lock);
+		return target ? target->next() : _targets.first();
+	}
+
+public:
+	Target_registry(Genode::Env &env, Genode::Allocator &alloc, Genode::Service_registry &parent_services)
+	:
+		_env(env), _alloc(alloc), _parent_services(parent_services), _lock(), _targets()
+	{ }
+
+	~Target_registry();
+
+	/**
+	 * Start a target from the rom module name
+	 *
+	 * \param ready_service If not null, the target is warm-booted (see Target::Target)
+	 * \param copy_config   Workers and CPUs copying the memory of a restore
+	 * \param generations   Number of older generations kept for restore and clone
+	 * \param standby       Standby of the target
+	 *
+	 * \throw Rtcr::Session::Target_already_exists
+	 * \throw Rtcr::Session::Rom_module_does_not_exist
+	 */
+	void start(Name const &name, Genode::size_t granularity, char const *ready_service = nullptr,
+			Parallel_copy::Config const &copy_config = Parallel_copy::Config(),
+			unsigned generations = Target::DEFAULT_GENERATIONS,
+			Standby::Config const &standby = Standby::Config());
+
+	/**
+	 * Call func with the target name while holding the lock of the target
+	 *
+	 * Targets are not removed from the registry; the target stays valid after the lookup.
+	 *
+	 * \throw Rtcr::Session::Target_does_not_exist
+	 */
+	template<typename FUNC>
+	void apply(Name const &name, FUNC const &func)
+	{
+		Target *target = _find(name);
+		if(!target) throw Rtcr::Session::Target_does_not_exist();
+
+		Try_lock::Guard guard(target->lock());
+		func(*target);
+	}
+
+	/**
+	 * Call func with the target name, if no operation on the target runs or waits
+	 *
+	 * \return whether func was called
+	 *
+	 * \throw Rtcr::Session::Target_does_not_exist
+	 */
+	template<typename FUNC>
+	bool try_apply(Name const &name, FUNC const &func)
+	{
+		Target *target = _find(name);
+		if(!target) throw Rtcr::Session::Target_does_not_exist();
+
+		if(!target->lock().try_lock()) return false;
+
+		Try_lock::Taken taken(target->lock());
+		func(*target);
+		return true;
+	}
+
+	/**
+	 * Call func with each target while holding the lock of the target
+	 */
+	template<typename FUNC>
+	void for_each(FUNC const &func)
+	{
+		for(Target *target = _find_next(nullptr); target; target = _find_next(target))
+		{
+			Try_lock::Guard guard(target->lock());
+			func(*target);
+		}
+	}
+
+	/**
+	 * Call func with each target on which no operation runs or waits; the other targets are skipped
+	 */
+	template<typename FUNC>
+	void try_for_each(FUNC const &func)
+	{
+		for(Target *target = _find_next(nullptr); target; target = _find_next(target))
+		{
+			if(!target->lock().try_lock()) continue;
+
+			Try_lock::Taken taken(target->lock());
+			func(*target);
+		}
+	}
+};
+
+#endif /* _RTCR_TARGET_REGISTRY_H_ */
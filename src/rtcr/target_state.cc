@@ -11,14 +11,133 @@ using namespace Rtcr;
 
 Target_state::Target_state(Genode::Env &env, Genode::Allocator &alloc)
 :
-	_env   (env),
-	_alloc (alloc)
+	_env       (env),
+	_alloc     (alloc),
+	_args_pool (alloc),
+	_cap_idx_alloc_addr (0),
+	_cap_map_layout ()
 { }
 
 
 Target_state::~Target_state()
 {
-// TODO delete all list elements
+	Genode::List<Ref_badge> freed;
+
+	while(Stored_pd_session_info *info = _stored_pd_sessions.first())
+	{
+		_stored_pd_sessions.remove(info);
+
+		while(Stored_signal_context_info *context_info = info->stored_context_infos.first())
+		{
+			info->stored_context_infos.remove(context_info);
+			Genode::destroy(_alloc, context_info);
+		}
+		while(Stored_signal_source_info *source_info = info->stored_source_infos.first())
+		{
+			info->stored_source_infos.remove(source_info);
+			Genode::destroy(_alloc, source_info);
+		}
+		while(Stored_native_capability_info *native_cap_info = info->stored_native_cap_infos.first())
+		{
+			info->stored_native_cap_infos.remove(native_cap_info);
+			Genode::destroy(_alloc, native_cap_info);
+		}
+		// The region maps of the PD session are members of info
+		_destroy_attached_regions(info->stored_address_space, freed);
+		_destroy_attached_regions(info->stored_stack_area, freed);
+		_destroy_attached_regions(info->stored_linker_area, freed);
+
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Stored_cpu_session_info *info = _stored_cpu_sessions.first())
+	{
+		_stored_cpu_sessions.remove(info);
+
+		while(Stored_cpu_thread_info *thread_info = info->stored_cpu_thread_infos.first())
+		{
+			info->stored_cpu_thread_infos.remove(thread_info);
+			Genode::destroy(_alloc, thread_info);
+		}
+
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Stored_ram_session_info *info = _stored_ram_sessions.first())
+	{
+		_stored_ram_sessions.remove(info);
+
+		while(Stored_ram_dataspace_info *ramds_info = info->stored_ramds_infos.first())
+		{
+			info->stored_ramds_infos.remove(ramds_info);
+			_free_memory_content(ramds_info->memory_content, freed);
+			Genode::destroy(_alloc, ramds_info);
+		}
+
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Stored_rom_session_info *info = _stored_rom_sessions.first())
+	{
+		_stored_rom_sessions.remove(info);
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Stored_rm_session_info *info = _stored_rm_sessions.first())
+	{
+		_stored_rm_sessions.remove(info);
+
+		while(Stored_region_map_info *region_map_info = info->stored_region_map_infos.first())
+		{
+			info->stored_region_map_infos.remove(region_map_info);
+			_destroy_attached_regions(*region_map_info, freed);
+			Genode::destroy(_alloc, region_map_info);
+		}
+
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Stored_log_session_info *info = _stored_log_sessions.first())
+	{
+		_stored_log_sessions.remove(info);
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Stored_timer_session_info *info = _stored_timer_sessions.first())
+	{
+		_stored_timer_sessions.remove(info);
+		Genode::destroy(_alloc, info);
+	}
+
+	while(Ref_badge *ref_badge = freed.first())
+	{
+		freed.remove(ref_badge);
+		Genode::destroy(_alloc, ref_badge);
+	}
+}
+
+
+void Target_state::_free_memory_content(Genode::Ram_dataspace_capability ds_cap, Genode::List<Ref_badge> &freed)
+{
+	if(!ds_cap.valid()) return;
+
+	Ref_badge *ref_badge = freed.first();
+	if(ref_badge) ref_badge = ref_badge->find_by_badge(ds_cap.local_name());
+	if(ref_badge) return;
+
+	freed.insert(new (_alloc) Ref_badge(ds_cap.local_name()));
+	_env.ram().free(ds_cap);
+}
+
+
+void Target_state::_destroy_attached_regions(Stored_region_map_info &info, Genode::List<Ref_badge> &freed)
+{
+	while(Stored_attached_region_info *attached_info = info.stored_attached_region_infos.first())
+	{
+		info.stored_attached_region_infos.remove(attached_info);
+		_free_memory_content(attached_info->memory_content, freed);
+		Genode::destroy(_alloc, attached_info);
+	}
 }
 
 
@@ -19,6 +19,9 @@
 #include "offline_storage/stored_rm_session_info.h"
 #include "offline_storage/stored_rom_session_info.h"
 #include "offline_storage/stored_timer_session_info.h"
+#include "offline_storage/string_pool.h"
+#include "util/cap_map_layout.h"
+#include "util/ref_badge.h"
 
 
 namespace Rtcr {
@@ -27,16 +30,28 @@ namespace Rtcr {
 	// Forward declaration
 	class Checkpointer;
 	class Restorer;
+	class Rollback;
+	class Restore_plan;
+	class Compact_target_state;
+	class Standby;
 }
 
 class Rtcr::Target_state
 {
 	friend class Checkpointer;
 	friend class Restorer;
+	friend class Rollback;
+	friend class Restore_plan;
+	friend class Compact_target_state;
+	friend class Standby;
 
 private:
 	Genode::Env       &_env;
 	Genode::Allocator &_alloc;
+	/**
+	 * Interned session arguments of the stored sessions
+	 */
+	String_pool        _args_pool;
 
 	Genode::List<Stored_pd_session_info>    _stored_pd_sessions;
 	Genode::List<Stored_cpu_session_info>   _stored_cpu_sessions;
@@ -47,6 +62,23 @@ private:
 	Genode::List<Stored_timer_session_info> _stored_timer_sessions;
 
 	Genode::addr_t _cap_idx_alloc_addr;
+	/**
+	 * Layout of the capability map at checkpoint time
+	 */
+	Cap_map_layout _cap_map_layout;
+
+	/*
+	 * Helpers for the destructor; freed lists the memory contents already freed,
+	 * because the stored attached regions share them with the stored RAM dataspaces
+	 */
+	void _free_memory_content(Genode::Ram_dataspace_capability ds_cap, Genode::List<Ref_badge> &freed);
+	void _destroy_attached_regions(Stored_region_map_info &info, Genode::List<Ref_badge> &freed);
+
+	/*
+	 * Noncopyable
+	 */
+	Target_state(Target_state const &);
+	Target_state &operator = (Target_state const &);
 
 public:
 	Target_state(Genode::Env &env, Genode::Allocator &alloc);
@@ -0,0 +1,65 @@
+/*
+ * \brief  Periodic decoding of the event trace to the log
+ * \author agent
+ * \date   2026-10-18
+ */
+
+/* Genode includes */
+#include <base/log.h>
+
+/* Rtcr includes */
+#include "trace_dump.h"
+
+using namespace Rtcr;
+
+
+void Trace_dump::_handle_period()
+{
+	for(unsigned i = 0; i < Event_trace::MAX_RINGS; i++)
+	{
+		// A released ring keeps its events until the next owner overwrites them
+		Event_trace::Ring const &ring = Event_trace::ring(i);
+		if(ring.head == _decoded[i]) continue;
+
+		if(ring.head > _decoded[i] + Event_trace::RING_EVENTS)
+			Genode::warning("[trace ", i, "] ", ring.head - _decoded[i] - Event_trace::RING_EVENTS,
+					" events overwritten before decoding");
+
+		_decoded[i] = Event_trace::for_each_event(ring, _decoded[i], [&] (Event_trace::Event const &event) {
+			char const *category = event.category == Event_trace::RPC   ? "rpc"   :
+			                       event.category == Event_trace::FAULT ? "fault" :
+			                       event.category == Event_trace::PHASE ? "phase" : "?";
+
+			Genode::log("[trace ", i, "] ", (event.time - _start) / _ticks_per_us, " us ", category, " ",
+					Event_trace::name((Event_trace::Id)event.id), " ",
+					Genode::Hex(event.arg0), " ", Genode::Hex(event.arg1));
+		});
+	}
+
+	unsigned long const dropped = Event_trace::dropped();
+	if(dropped != _dropped)
+	{
+		Genode::warning("Event trace dropped ", dropped - _dropped, " events of threads without a ring");
+		_dropped = dropped;
+	}
+}
+
+
+Trace_dump::Trace_dump(Genode::Env &env, Genode::uint64_t ticks_per_us, unsigned categories, unsigned period_ms)
+:
+	_ticks_per_us(ticks_per_us ? ticks_per_us : 1), _start(Genode::Trace::timestamp()), _timer(env),
+	_period_handler(env.ep(), *this, &Trace_dump::_handle_period), _decoded(), _dropped(Event_trace::dropped())
+{
+	for(unsigned i = 0; i < Event_trace::MAX_RINGS; i++) _decoded[i] = Event_trace::ring(i).head;
+
+	Event_trace::categories(categories);
+
+	_timer.sigh(_period_handler);
+	_timer.trigger_periodic(period_ms*1000);
+}
+
+
+Trace_dump::~Trace_dump()
+{
+	Event_trace::categories(Event_trace::NONE);
+}
@@ -0,0 +1,63 @@
+/*
+ * \brief  Periodic decoding of the event trace to the log
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The events recorded since the last period are decoded in the entrypoint of
+ * Rtcr, not in the threads which recorded them, e.g.
+ *
+ * [trace 2] 1234567 us rpc ram_alloc 0x4000 0x2a
+ *
+ * shows the ring, the time since the start of the trace, the category, the
+ * event, and its two arguments. It is enabled by
+ * <trace categories="rpc,fault,phase" period_ms="1000"/> in the config.
+ */
+
+#ifndef _RTCR_TRACE_DUMP_H_
+#define _RTCR_TRACE_DUMP_H_
+
+/* Genode includes */
+#include <base/signal.h>
+#include <timer_session/connection.h>
+
+/* Rtcr includes */
+#include "util/event_trace.h"
+
+namespace Rtcr {
+	class Trace_dump;
+}
+
+
+class Rtcr::Trace_dump
+{
+private:
+	Genode::uint64_t                  const  _ticks_per_us;
+	Genode::Trace::Timestamp          const  _start;
+	Timer::Connection                        _timer;
+	Genode::Signal_handler<Trace_dump>       _period_handler;
+	/**
+	 * Position of the next undecoded event of each ring
+	 */
+	unsigned long                            _decoded[Event_trace::MAX_RINGS];
+	unsigned long                            _dropped;
+
+	/*
+	 * Noncopyable
+	 */
+	Trace_dump(Trace_dump const &);
+	Trace_dump &operator = (Trace_dump const &);
+
+	void _handle_period();
+
+public:
+	/**
+	 * Constructor
+	 *
+	 * \param ticks_per_us Ticks of Genode::Trace::timestamp() per microsecond
+	 * \param categories   Mask of the Event_trace::Category to be recorded
+	 */
+	Trace_dump(Genode::Env &env, Genode::uint64_t ticks_per_us, unsigned categories, unsigned period_ms);
+	~Trace_dump();
+};
+
+#endif /* _RTCR_TRACE_DUMP_H_ */
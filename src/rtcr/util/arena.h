@@ -0,0 +1,163 @@
+/*
+ * \brief  Bump-pointer allocator for short-lived datastructures
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The arena requests large chunks from a backing allocator and hands out memory
+ * by incrementing a pointer. Freeing single objects is a no-op. All objects are
+ * released at once by reset(), which only rewinds the pointer to the first chunk.
+ * The chunks are kept for the next usage and are only returned to the backing
+ * allocator when the arena is destroyed.
+ */
+
+#ifndef _RTCR_ARENA_H_
+#define _RTCR_ARENA_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <base/log.h>
+#include <util/misc_math.h>
+
+/* Rtcr includes */
+
+namespace Rtcr {
+	class Arena;
+}
+
+
+class Rtcr::Arena : public Genode::Allocator
+{
+private:
+	enum { CHUNK_SIZE = 16*1024, ALIGN_LOG2 = 4 };
+
+	/**
+	 * Header of a chunk; the usable memory follows directly
+	 */
+	struct Chunk
+	{
+		Chunk          *next;
+		Genode::size_t  size;
+
+		Chunk(Genode::size_t size) : next(nullptr), size(size) { }
+
+		Genode::addr_t start() const
+		{
+			return Genode::align_addr((Genode::addr_t)this + sizeof(Chunk), ALIGN_LOG2);
+		}
+		Genode::addr_t end() const { return (Genode::addr_t)this + size; }
+	};
+
+	Genode::Allocator &_backing;
+	Chunk             *_first;
+	Chunk             *_curr;
+	Genode::addr_t     _top;
+	Genode::size_t     _consumed;
+
+	Chunk *_create_chunk(Genode::size_t min_size)
+	{
+		Genode::size_t const size = Genode::max((Genode::size_t)CHUNK_SIZE,
+				min_size + sizeof(Chunk) + (1 << ALIGN_LOG2));
+
+		void *addr = nullptr;
+		if(!_backing.alloc(size, &addr)) return nullptr;
+
+		return new (addr) Chunk(size);
+	}
+
+	/**
+	 * Make a chunk with at least size bytes the current chunk
+	 *
+	 * Already existing chunks which are large enough are reused. Otherwise, a new chunk
+	 * is inserted after the current one.
+	 */
+	bool _next_chunk(Genode::size_t size)
+	{
+		Chunk *next = _curr ? _curr->next : _first;
+		if(next && next->start() + size <= next->end())
+		{
+			_curr = next;
+			_top  = next->start();
+			return true;
+		}
+
+		Chunk *chunk = _create_chunk(size);
+		if(!chunk) return false;
+
+		if(_curr)
+		{
+			chunk->next = _curr->next;
+			_curr->next = chunk;
+		}
+		else
+		{
+			chunk->next = _first;
+			_first = chunk;
+		}
+		_curr = chunk;
+		_top  = chunk->start();
+
+		return true;
+	}
+
+public:
+	Arena(Genode::Allocator &backing)
+	:
+		_backing(backing), _first(nullptr), _curr(nullptr), _top(0), _consumed(0)
+	{ }
+
+	~Arena()
+	{
+		while(Chunk *chunk = _first)
+		{
+			_first = chunk->next;
+			_backing.free(chunk, chunk->size);
+		}
+	}
+
+	/**
+	 * Release all objects allocated from the arena
+	 *
+	 * The destructors of the objects are not called. Objects which need a destructor
+	 * call (e.g. objects holding capabilities) have to be destroyed before.
+	 */
+	void reset()
+	{
+		_curr     = _first;
+		_top      = _first ? _first->start() : 0;
+		_consumed = 0;
+	}
+
+	/*************************
+	 ** Allocator interface **
+	 *************************/
+
+	bool alloc(Genode::size_t size, void **out_addr) override
+	{
+		size = Genode::align_addr(size, ALIGN_LOG2);
+
+		if(!_curr || _top + size > _curr->end())
+		{
+			if(!_next_chunk(size))
+			{
+				Genode::error("Arena could not allocate a chunk for ", size, " bytes");
+				return false;
+			}
+		}
+
+		*out_addr = (void*)_top;
+		_top += size;
+		_consumed += size;
+
+		return true;
+	}
+
+	void free(void *, Genode::size_t) override { }
+
+	Genode::size_t consumed() const override { return _consumed; }
+
+	Genode::size_t overhead(Genode::size_t) const override { return 0; }
+
+	bool need_size_for_free() const override { return false; }
+};
+
+#endif /* _RTCR_ARENA_H_ */
@@ -0,0 +1,64 @@
+/*
+ * \brief  Retrieval of the capability map layout of a Target_child
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#ifndef _RTCR_CAP_MAP_LAYOUT_H_
+#define _RTCR_CAP_MAP_LAYOUT_H_
+
+/* Genode includes */
+#include <foc_native_pd/client.h>
+
+/* Rtcr includes */
+
+namespace Rtcr {
+	typedef Genode::Foc_native_pd::Cap_map_layout Cap_map_layout;
+
+	enum {
+		/**
+		 * Number of slots following the reserved slots in which the Restorer looks for a used
+		 * Cap_index; the Cap_indices allocated during the startup of a component are there
+		 */
+		CAP_MAP_ANCHOR_SLOTS = 0x80
+	};
+
+	inline Cap_map_layout default_cap_map_layout(Genode::addr_t struct_addr);
+	inline Cap_map_layout cap_map_layout(Genode::Capability<Genode::Pd_session::Native_pd> native_pd);
+}
+
+
+/**
+ * Return the layout of the 4096-slot Cap_index_allocator_tpl of 32-bit Fiasco.OC components
+ * located at struct_addr
+ *
+ * It is assumed for children which did not report a layout (e.g. they were built without the
+ * layout reporting in init_pd).
+ */
+Rtcr::Cap_map_layout Rtcr::default_cap_map_layout(Genode::addr_t struct_addr)
+{
+	Cap_map_layout layout;
+	layout.struct_addr    = struct_addr;
+	layout.array_addr     = struct_addr + 8;
+	layout.num_slots      = 4096;
+	layout.element_size   = 8;
+	layout.ref_cnt_offset = 4;
+	layout.badge_offset   = 6;
+	layout.user_slot      = 0x200;
+
+	return layout;
+}
+
+
+/**
+ * Return the layout of the capability map reported by the child
+ */
+Rtcr::Cap_map_layout Rtcr::cap_map_layout(Genode::Capability<Genode::Pd_session::Native_pd> native_pd)
+{
+	Genode::Foc_native_pd_client client(native_pd);
+
+	Cap_map_layout const layout = client.cap_map_layout();
+	return layout.num_slots ? layout : default_cap_map_layout(client.cap_map_info());
+}
+
+#endif /* _RTCR_CAP_MAP_LAYOUT_H_ */
@@ -0,0 +1,393 @@
+/*
+ * \brief  Incremental scanner for the capability map of a Target_child
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The scanner keeps the memory holding the child's Cap_index array persistently
+ * attached to the local address space and keeps a snapshot of the array from the
+ * previous scan. A scan compares the array with the snapshot word by word in blocks
+ * of several slots and inspects only the slots of changed blocks. The result is
+ * stored in flat tables indexed by capability slot and by badge, and the added and
+ * removed slots of the last scan are available as lists of slot indices.
+ *
+ * If the child's array is located in a managed dataspace of the incremental
+ * checkpoint mechanism, the designated dataspaces are attached directly. Thus,
+ * reading the array neither triggers page faults in the child's region map nor
+ * marks designated dataspaces as accessed.
+ */
+
+#ifndef _RTCR_CAP_MAP_SCANNER_H_
+#define _RTCR_CAP_MAP_SCANNER_H_
+
+/* Genode includes */
+#include <util/list.h>
+#include <util/string.h>
+#include <base/allocator.h>
+#include <base/log.h>
+#include <region_map/region_map.h>
+#include <dataspace/capability.h>
+
+/* Rtcr includes */
+
+namespace Rtcr {
+	class Cap_map_scanner;
+}
+
+
+class Rtcr::Cap_map_scanner
+{
+public:
+	/**
+	 * Index of a Cap_index in the child's array; as wide as an address, thus, the
+	 * number of slots is only limited by the reported layout
+	 */
+	typedef Genode::addr_t Slot;
+
+	enum : Slot { INVALID_SLOT = ~(Slot)0 };
+
+	enum {
+		/**
+		 * Last 12 bits of a kcap are used by Fiasco.OC for IPC parameters
+		 */
+		KCAP_SHIFT   = 12,
+		/**
+		 * Number of slots which are compared at once
+		 */
+		BLOCK_SLOTS  = 8,
+		NUM_BADGES   = 0x10000,
+		UNUSED_BADGE = 0, INVALID_BADGE = 0xffff
+	};
+
+	/**
+	 * Layout of the child's Cap_index array
+	 */
+	struct Layout
+	{
+		Genode::addr_t array_addr;   /* child's address of the first slot */
+		Genode::size_t num_slots;
+		Genode::size_t element_size;
+		Genode::size_t badge_offset; /* offset of the 16-bit badge within a slot */
+
+		bool operator != (Layout const &other) const
+		{
+			return array_addr != other.array_addr || num_slots != other.num_slots
+				|| element_size != other.element_size || badge_offset != other.badge_offset;
+		}
+	};
+
+private:
+	/**
+	 * Locally attached part of the child's memory
+	 */
+	struct Segment : Genode::List<Segment>::Element
+	{
+		Genode::addr_t const child_addr;
+		Genode::size_t const size;
+		Genode::addr_t const local_addr;
+
+		Segment(Genode::addr_t child_addr, Genode::size_t size, Genode::addr_t local_addr)
+		: child_addr(child_addr), size(size), local_addr(local_addr) { }
+	};
+
+	Genode::Allocator     &_alloc;
+	Genode::Region_map    &_rm;
+	Genode::List<Segment>  _segments;
+	Genode::uint16_t       _backing_badge;
+
+	Layout _layout;
+
+	/**
+	 * Raw copy of the array from the previous scan
+	 */
+	Genode::uint8_t  *_snapshot;
+	/**
+	 * Badge for each slot; UNUSED_BADGE, if the slot is not used
+	 */
+	Genode::uint16_t *_badge_by_slot;
+	/**
+	 * Slot for each badge; INVALID_SLOT, if the badge is not in the array
+	 */
+	Slot             *_slot_by_badge;
+
+	Slot             *_added;
+	Slot             *_removed;
+	Genode::size_t    _num_added;
+	Genode::size_t    _num_removed;
+	Genode::size_t    _num_used;
+
+	Genode::size_t _array_size() const { return _layout.num_slots * _layout.element_size; }
+
+	template<typename T>
+	T *_alloc_array(Genode::size_t num)
+	{
+		T *result = nullptr;
+		if(!_alloc.alloc(num*sizeof(T), (void**)&result))
+		{
+			Genode::error("Cap_map_scanner could not allocate ", num*sizeof(T), " bytes");
+			throw Genode::Exception();
+		}
+		return result;
+	}
+
+	template<typename T>
+	void _free_array(T *&array, Genode::size_t num)
+	{
+		if(array) _alloc.free(array, num*sizeof(T));
+		array = nullptr;
+	}
+
+	void _free_tables()
+	{
+		if(!_layout.num_slots) return;
+
+		_free_array(_snapshot, _array_size());
+		_free_array(_badge_by_slot, _layout.num_slots);
+		_free_array(_slot_by_badge, (Genode::size_t)NUM_BADGES);
+		_free_array(_added, _layout.num_slots);
+		_free_array(_removed, _layout.num_slots);
+	}
+
+	/**
+	 * Return local address of the child's address or 0, if the address is not mapped
+	 */
+	Genode::addr_t _local_addr(Genode::addr_t child_addr, Genode::size_t size) const
+	{
+		for(Segment const *seg = _segments.first(); seg; seg = seg->next())
+		{
+			if(child_addr >= seg->child_addr && child_addr + size <= seg->child_addr + seg->size)
+				return seg->local_addr + (child_addr - seg->child_addr);
+		}
+		return 0;
+	}
+
+	static bool _equal(Genode::addr_t const *a, Genode::addr_t const *b, Genode::size_t words)
+	{
+		Genode::addr_t diff = 0;
+		for(Genode::size_t i = 0; i < words; i++) diff |= a[i] ^ b[i];
+		return !diff;
+	}
+
+	void _update_slot(Slot slot, Genode::uint16_t new_badge)
+	{
+		bool const new_used = new_badge != UNUSED_BADGE && new_badge != INVALID_BADGE;
+		Genode::uint16_t const old_badge = _badge_by_slot[slot];
+
+		if(old_badge == (new_used ? new_badge : (Genode::uint16_t)UNUSED_BADGE)) return;
+
+		if(old_badge != UNUSED_BADGE)
+		{
+			if(_slot_by_badge[old_badge] == slot) _slot_by_badge[old_badge] = INVALID_SLOT;
+			_removed[_num_removed++] = slot;
+			_num_used--;
+		}
+		if(new_used)
+		{
+			_slot_by_badge[new_badge] = slot;
+			_added[_num_added++] = slot;
+			_num_used++;
+		}
+		_badge_by_slot[slot] = new_used ? new_badge : (Genode::uint16_t)UNUSED_BADGE;
+	}
+
+	/*
+	 * Noncopyable
+	 */
+	Cap_map_scanner(Cap_map_scanner const &);
+	Cap_map_scanner &operator = (Cap_map_scanner const &);
+
+public:
+	Cap_map_scanner(Genode::Allocator &alloc, Genode::Region_map &rm)
+	:
+		_alloc(alloc), _rm(rm), _segments(), _backing_badge(0), _layout(),
+		_snapshot(nullptr), _badge_by_slot(nullptr), _slot_by_badge(nullptr),
+		_added(nullptr), _removed(nullptr), _num_added(0), _num_removed(0), _num_used(0)
+	{ }
+
+	~Cap_map_scanner()
+	{
+		unmap();
+		_free_tables();
+	}
+
+	/**
+	 * Badge of the child's dataspace which is currently attached
+	 */
+	Genode::uint16_t backing_badge() const { return _backing_badge; }
+
+	bool mapped() const { return _segments.first(); }
+
+	/**
+	 * Attach a part of the child's memory
+	 *
+	 * \param backing_badge  badge of the child's dataspace containing the array
+	 * \param ds_cap         dataspace to attach
+	 * \param ds_offset      offset within ds_cap
+	 * \param size           size of the part
+	 * \param child_addr     child's address of the part
+	 */
+	void map(Genode::uint16_t backing_badge, Genode::Dataspace_capability ds_cap,
+			Genode::off_t ds_offset, Genode::size_t size, Genode::addr_t child_addr)
+	{
+		Genode::addr_t const local_addr = _rm.attach(ds_cap, size, ds_offset);
+		_segments.insert(new (_alloc) Segment(child_addr, size, local_addr));
+		_backing_badge = backing_badge;
+	}
+
+	/**
+	 * Detach all parts of the child's memory
+	 */
+	void unmap()
+	{
+		while(Segment *seg = _segments.first())
+		{
+			_segments.remove(seg);
+			_rm.detach(seg->local_addr);
+			Genode::destroy(_alloc, seg);
+		}
+		_backing_badge = 0;
+	}
+
+	/**
+	 * Set the layout of the array
+	 *
+	 * If the layout changes, all tables are reset and the next scan reports all used
+	 * slots as added.
+	 */
+	void layout(Layout const &layout)
+	{
+		if(!(_layout != layout) && _snapshot) return;
+
+		_free_tables();
+		_layout = layout;
+
+		_snapshot      = _alloc_array<Genode::uint8_t>(_array_size());
+		_badge_by_slot = _alloc_array<Genode::uint16_t>(_layout.num_slots);
+		_slot_by_badge = _alloc_array<Slot>(NUM_BADGES);
+		_added         = _alloc_array<Slot>(_layout.num_slots);
+		_removed       = _alloc_array<Slot>(_layout.num_slots);
+
+		Genode::memset(_snapshot, 0, _array_size());
+		Genode::memset(_badge_by_slot, 0, _layout.num_slots*sizeof(Genode::uint16_t));
+		for(Genode::size_t badge = 0; badge < NUM_BADGES; badge++) _slot_by_badge[badge] = INVALID_SLOT;
+		_num_added = _num_removed = _num_used = 0;
+	}
+
+	Layout const &layout() const { return _layout; }
+
+	/**
+	 * Compare the child's array with the snapshot and update the tables
+	 *
+	 * \return number of changed slots
+	 */
+	Genode::size_t scan()
+	{
+		_num_added = _num_removed = 0;
+
+		Genode::size_t const elem  = _layout.element_size;
+		Genode::size_t const block = elem * BLOCK_SLOTS;
+		bool const wide = !(block % sizeof(Genode::addr_t));
+
+		for(Genode::size_t first = 0; first < _layout.num_slots; first += BLOCK_SLOTS)
+		{
+			Genode::size_t const slots = Genode::min((Genode::size_t)BLOCK_SLOTS, _layout.num_slots - first);
+			Genode::size_t const bytes = slots * elem;
+			Genode::addr_t const child_addr = _layout.array_addr + first*elem;
+
+			Genode::uint8_t const *curr = (Genode::uint8_t const*)_local_addr(child_addr, bytes);
+			Genode::uint8_t       *prev = _snapshot + first*elem;
+
+			// The block crosses a segment border; fall back to single slots
+			if(!curr)
+			{
+				for(Genode::size_t i = 0; i < slots; i++)
+				{
+					Genode::uint8_t const *slot = (Genode::uint8_t const*)
+							_local_addr(child_addr + i*elem, elem);
+					if(!slot)
+					{
+						Genode::error("Slot ", first + i, " of the capability map is not mapped");
+						throw Genode::Exception();
+					}
+					if(!Genode::memcmp(slot, prev + i*elem, elem)) continue;
+
+					Genode::memcpy(prev + i*elem, slot, elem);
+					_update_slot(first + i, *(Genode::uint16_t const*)(slot + _layout.badge_offset));
+				}
+				continue;
+			}
+
+			// Skip unchanged blocks with word-wide compares
+			if(wide && slots == BLOCK_SLOTS
+			   && _equal((Genode::addr_t const*)curr, (Genode::addr_t const*)prev, bytes/sizeof(Genode::addr_t)))
+				continue;
+
+			for(Genode::size_t i = 0; i < slots; i++)
+			{
+				Genode::uint8_t const *slot = curr + i*elem;
+				if(!Genode::memcmp(slot, prev + i*elem, elem)) continue;
+
+				_update_slot(first + i, *(Genode::uint16_t const*)(slot + _layout.badge_offset));
+			}
+			Genode::memcpy(prev, curr, bytes);
+		}
+
+		return _num_added + _num_removed;
+	}
+
+	static Genode::addr_t kcap(Slot slot) { return slot << KCAP_SHIFT; }
+	static Slot slot(Genode::addr_t kcap) { return kcap >> KCAP_SHIFT; }
+
+	/**
+	 * Return the kcap for the badge or 0, if the badge is not in the array
+	 */
+	Genode::addr_t kcap_by_badge(Genode::uint16_t badge) const
+	{
+		if(!_slot_by_badge || _slot_by_badge[badge] == INVALID_SLOT) return 0;
+		return kcap(_slot_by_badge[badge]);
+	}
+
+	/**
+	 * Return the badge of a kcap or UNUSED_BADGE
+	 */
+	Genode::uint16_t badge_by_kcap(Genode::addr_t kcap) const
+	{
+		Slot const s = slot(kcap);
+		return (_badge_by_slot && s < _layout.num_slots) ? _badge_by_slot[s] : (Genode::uint16_t)UNUSED_BADGE;
+	}
+
+	Genode::size_t num_used()    const { return _num_used; }
+	Genode::size_t num_added()   const { return _num_added; }
+	Genode::size_t num_removed() const { return _num_removed; }
+
+	/**
+	 * Apply fn(kcap, badge) to each used slot
+	 */
+	template<typename FN>
+	void for_each_used(FN const &fn) const
+	{
+		for(Slot s = 0; s < _layout.num_slots; s++)
+			if(_badge_by_slot[s] != UNUSED_BADGE) fn(kcap(s), _badge_by_slot[s]);
+	}
+
+	/**
+	 * Apply fn(kcap, badge) to each slot added during the last scan
+	 */
+	template<typename FN>
+	void for_each_added(FN const &fn) const
+	{
+		for(Genode::size_t i = 0; i < _num_added; i++)
+			fn(kcap(_added[i]), _badge_by_slot[_added[i]]);
+	}
+
+	/**
+	 * Apply fn(kcap) to each slot removed during the last scan
+	 */
+	template<typename FN>
+	void for_each_removed(FN const &fn) const
+	{
+		for(Genode::size_t i = 0; i < _num_removed; i++)
+			fn(kcap(_removed[i]));
+	}
+};
+
+#endif /* _RTCR_CAP_MAP_SCANNER_H_ */
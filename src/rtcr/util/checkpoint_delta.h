@@ -0,0 +1,78 @@
+/*
+ * \brief  Stored memory overwritten by a checkpoint
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The Checkpointer records each extent of the stored memory content which it
+ * copies by a checkpoint. A consumer of the checkpoints, e.g. a Standby,
+ * applies only these extents instead of the whole stored memory.
+ */
+
+#ifndef _RTCR_CHECKPOINT_DELTA_H_
+#define _RTCR_CHECKPOINT_DELTA_H_
+
+/* Genode includes */
+#include <util/list.h>
+
+/* Rtcr includes */
+#include "arena.h"
+
+namespace Rtcr {
+	class Checkpoint_delta;
+}
+
+
+class Rtcr::Checkpoint_delta
+{
+public:
+	struct Extent : Genode::List<Extent>::Element
+	{
+		/**
+		 * Badge of the copy dataspace holding the stored memory content
+		 */
+		Genode::uint16_t const content_badge;
+		Genode::addr_t   const rel_addr;
+		Genode::size_t   const size;
+
+		Extent(Genode::uint16_t content_badge, Genode::addr_t rel_addr, Genode::size_t size)
+		: content_badge(content_badge), rel_addr(rel_addr), size(size) { }
+	};
+
+private:
+	/**
+	 * Allocator for the extents of a single checkpoint
+	 */
+	Arena               _arena;
+	Genode::List<Extent> _extents;
+
+	/*
+	 * Noncopyable
+	 */
+	Checkpoint_delta(Checkpoint_delta const &);
+	Checkpoint_delta &operator = (Checkpoint_delta const &);
+
+public:
+	Checkpoint_delta(Genode::Allocator &alloc) : _arena(alloc), _extents() { }
+
+	void add(Genode::uint16_t content_badge, Genode::addr_t rel_addr, Genode::size_t size)
+	{
+		_extents.insert(new (_arena) Extent(content_badge, rel_addr, size));
+	}
+
+	/**
+	 * Drop the extents of the previous checkpoint
+	 */
+	void clear()
+	{
+		_extents = Genode::List<Extent>();
+		_arena.reset();
+	}
+
+	template<typename FUNC>
+	void for_each(FUNC const &func) const
+	{
+		for(Extent const *extent = _extents.first(); extent; extent = extent->next()) func(*extent);
+	}
+};
+
+#endif /* _RTCR_CHECKPOINT_DELTA_H_ */
@@ -0,0 +1,18 @@
+/*
+ * \brief  Storage of the event trace
+ * \author agent
+ * \date   2026-10-18
+ */
+
+/* Rtcr includes */
+#include "event_trace.h"
+
+using namespace Rtcr;
+
+
+/*
+ * Nothing is recorded until categories are enabled, e.g. by Trace_dump
+ */
+volatile unsigned  Event_trace::_categories = Event_trace::NONE;
+volatile int       Event_trace::_dropped    = 0;
+Event_trace::Ring  Event_trace::_rings[Event_trace::MAX_RINGS];
@@ -0,0 +1,274 @@
+/*
+ * \brief  Binary trace of the intercepted RPCs, the page faults, and the checkpoint phases
+ * \author agent
+ * \date   2026-10-18
+ *
+ * Recording an event writes a few words to a ring of the calling thread; it
+ * neither takes a lock nor formats a string, thus, it is cheap enough for the
+ * hot paths in which the verbose_debug logs were too expensive to be enabled.
+ * Each thread claims a ring on its first event; the ring is written only by
+ * this thread and read by the decoder (Trace_dump) without stopping it. A
+ * thread which exits releases its ring by a Thread_scope in its entry(); the
+ * ring of a thread destroyed by others, e.g. the entrypoint of a destroyed
+ * child, is taken over by the next thread which finds no free ring. The
+ * recorded categories are selected at runtime, e.g. by
+ * <trace categories="rpc,fault,phase"/> in the config.
+ */
+
+#ifndef _RTCR_EVENT_TRACE_H_
+#define _RTCR_EVENT_TRACE_H_
+
+/* Genode includes */
+#include <base/thread.h>
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
+#include <util/string.h>
+#include <util/misc_math.h>
+#include <trace/timestamp.h>
+
+namespace Rtcr {
+	class Event_trace;
+}
+
+
+class Rtcr::Event_trace
+{
+public:
+	enum Category { NONE = 0, RPC = 1 << 0, FAULT = 1 << 1, PHASE = 1 << 2, ALL = RPC | FAULT | PHASE };
+
+	enum Id
+	{
+		RAM_ALLOC, RAM_FREE,
+		RM_ATTACH, RM_DETACH,
+		PD_ALLOC_CONTEXT, PD_FREE_CONTEXT, PD_SUBMIT, PD_ALLOC_RPC_CAP, PD_FREE_RPC_CAP,
+		CPU_CREATE_THREAD, CPU_KILL_THREAD,
+		/**
+		 * A page fault at arg0 was resolved; arg1 is its latency in timestamp ticks
+		 */
+		FAULT_READ, FAULT_WRITE, FAULT_EXEC,
+		/**
+		 * A phase of a checkpoint or restore ended; arg0 is the Phase_record::Phase
+		 */
+		PHASE_END,
+		NUM_IDS
+	};
+
+	struct Event
+	{
+		Genode::Trace::Timestamp time;
+		Genode::uint16_t         category;
+		Genode::uint16_t         id;
+		Genode::addr_t           arg0;
+		Genode::addr_t           arg1;
+	};
+
+	enum { MAX_RINGS = 16, RING_EVENTS = 256 };
+
+	struct Ring
+	{
+		enum State { FREE = 0, CLAIMING = 1, CLAIMED = 2 };
+
+		volatile int                   state;
+		Genode::Thread const *volatile owner;
+		/**
+		 * Number of events ever recorded; only the owner writes it. It is kept when
+		 * the ring is released, thus, the decoder continues with the next owner
+		 */
+		volatile unsigned long         head;
+		Event                          events[RING_EVENTS];
+	};
+
+private:
+	static volatile unsigned _categories;
+	/**
+	 * Events of the threads which found no ring to claim or to take over
+	 */
+	static volatile int _dropped;
+	static Ring _rings[MAX_RINGS];
+
+	static Ring *_claim(Genode::Thread const *myself)
+	{
+		for(unsigned i = 0; i < MAX_RINGS; i++)
+		{
+			Ring &ring = _rings[i];
+			if(ring.state != Ring::FREE || !Genode::cmpxchg(&ring.state, Ring::FREE, Ring::CLAIMING)) continue;
+
+			ring.owner = myself;
+			Genode::memory_barrier();
+			ring.state = Ring::CLAIMED;
+			return &ring;
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Take over the ring written least recently
+	 *
+	 * Its owner is most likely gone. Otherwise, the owner claims a ring again on
+	 * its next event; an event which it records during the takeover may be lost.
+	 */
+	static Ring *_take_over(Genode::Thread const *myself)
+	{
+		Ring                     *oldest      = nullptr;
+		Genode::Trace::Timestamp  oldest_time = 0;
+		for(unsigned i = 0; i < MAX_RINGS; i++)
+		{
+			Ring &ring = _rings[i];
+			if(ring.state != Ring::CLAIMED) continue;
+
+			unsigned long const head = ring.head;
+			Genode::Trace::Timestamp const time = head ? ring.events[(head - 1) % RING_EVENTS].time : 0;
+			if(!oldest || time < oldest_time)
+			{
+				oldest      = &ring;
+				oldest_time = time;
+			}
+		}
+
+		if(!oldest || !Genode::cmpxchg(&oldest->state, Ring::CLAIMED, Ring::CLAIMING)) return nullptr;
+
+		oldest->owner = myself;
+		Genode::memory_barrier();
+		oldest->state = Ring::CLAIMED;
+		return oldest;
+	}
+
+	static Ring *_ring()
+	{
+		Genode::Thread const *myself = Genode::Thread::myself();
+		for(unsigned i = 0; i < MAX_RINGS; i++)
+			if(_rings[i].state == Ring::CLAIMED && _rings[i].owner == myself) return &_rings[i];
+
+		Ring *ring = _claim(myself);
+		return ring ? ring : _take_over(myself);
+	}
+
+	static void _record(Category category, Id id, Genode::addr_t arg0, Genode::addr_t arg1)
+	{
+		Ring *ring = _ring();
+		if(!ring)
+		{
+			int dropped;
+			do { dropped = _dropped; } while(!Genode::cmpxchg(&_dropped, dropped, dropped + 1));
+			return;
+		}
+
+		unsigned long const head = ring->head;
+		Event &event = ring->events[head % RING_EVENTS];
+		event.time     = Genode::Trace::timestamp();
+		event.category = category;
+		event.id       = id;
+		event.arg0     = arg0;
+		event.arg1     = arg1;
+
+		// Publish the event only after it is written
+		Genode::memory_barrier();
+		ring->head = head + 1;
+	}
+
+public:
+	static void categories(unsigned categories) { _categories = categories; }
+	static unsigned categories() { return _categories; }
+	static bool enabled(Category category) { return _categories & category; }
+	static unsigned long dropped() { return (unsigned)_dropped; }
+
+	/**
+	 * Release the ring of owner; owner must not record events afterwards
+	 */
+	static void release(Genode::Thread const *owner)
+	{
+		for(unsigned i = 0; i < MAX_RINGS; i++)
+		{
+			Ring &ring = _rings[i];
+			if(ring.state != Ring::CLAIMED || ring.owner != owner) continue;
+
+			ring.owner = nullptr;
+			Genode::memory_barrier();
+			ring.state = Ring::FREE;
+		}
+	}
+
+	/**
+	 * Releases the ring of the calling thread when the thread leaves the scope, e.g. its entry()
+	 */
+	struct Thread_scope
+	{
+		~Thread_scope() { release(Genode::Thread::myself()); }
+	};
+
+	/**
+	 * Parse a comma-separated list of categories, e.g. "rpc,fault,phase" or "all"
+	 */
+	static unsigned parse_categories(char const *list)
+	{
+		struct { char const *name; unsigned mask; } const names[] = {
+			{ "rpc", RPC }, { "fault", FAULT }, { "phase", PHASE }, { "all", ALL } };
+
+		unsigned result = NONE;
+		while(*list)
+		{
+			Genode::size_t len = 0;
+			while(list[len] && list[len] != ',') len++;
+
+			for(unsigned i = 0; i < sizeof(names)/sizeof(names[0]); i++)
+				if(Genode::strlen(names[i].name) == len && !Genode::strcmp(names[i].name, list, len))
+					result |= names[i].mask;
+
+			list += len;
+			if(*list == ',') list++;
+		}
+		return result;
+	}
+
+	/**
+	 * Record an event, if its category is enabled
+	 */
+	static void record(Category category, Id id, Genode::addr_t arg0 = 0, Genode::addr_t arg1 = 0)
+	{
+		if(_categories & category) _record(category, id, arg0, arg1);
+	}
+
+	static Ring const &ring(unsigned i) { return _rings[i]; }
+
+	/**
+	 * Call func(Event const &) for each event of ring recorded at or after the position from, oldest first
+	 *
+	 * The events overwritten while they are read are skipped.
+	 *
+	 * \return position of the next event
+	 */
+	template<typename FUNC>
+	static unsigned long for_each_event(Ring const &ring, unsigned long from, FUNC const &func)
+	{
+		unsigned long const head  = ring.head;
+		Genode::memory_barrier();
+		unsigned long const first = head > RING_EVENTS ? Genode::max(from, head - RING_EVENTS) : from;
+
+		for(unsigned long pos = first; pos < head; pos++)
+		{
+			Event const event = ring.events[pos % RING_EVENTS];
+
+			// Skip the event, if the owner overwrote its slot or is writing to it
+			Genode::memory_barrier();
+			if(ring.head >= pos + RING_EVENTS) continue;
+
+			func(event);
+		}
+		return head;
+	}
+
+	static char const *name(Id id)
+	{
+		static char const *names[NUM_IDS] = {
+			"ram_alloc", "ram_free",
+			"rm_attach", "rm_detach",
+			"pd_alloc_context", "pd_free_context", "pd_submit", "pd_alloc_rpc_cap", "pd_free_rpc_cap",
+			"cpu_create_thread", "cpu_kill_thread",
+			"fault_read", "fault_write", "fault_exec",
+			"phase_end" };
+
+		return id < NUM_IDS ? names[id] : "unknown";
+	}
+};
+
+#endif /* _RTCR_EVENT_TRACE_H_ */
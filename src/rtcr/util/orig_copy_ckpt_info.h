@@ -15,6 +15,7 @@
 
 namespace Rtcr {
 	struct Orig_copy_ckpt_info;
+	struct Designated_dataspace_info;
 }
 
 
@@ -24,14 +25,19 @@ struct Rtcr::Orig_copy_ckpt_info : Genode::List<Orig_copy_ckpt_info>::Element
 	Genode::Ram_dataspace_capability const copy_ds_cap;
 	Genode::addr_t const copy_rel_addr;
 	Genode::size_t const copy_size;
+	/**
+	 * Designated dataspace, if orig_ds_cap is one; only designated dataspaces can be protected
+	 * from the child and copied after it is resumed
+	 */
+	Designated_dataspace_info *const dd_info;
 	bool checkpointed;
 
 	Orig_copy_ckpt_info(Genode::Dataspace_capability orig_ds_cap, Genode::Ram_dataspace_capability copy_ds_cap,
-			Genode::addr_t copy_rel_addr, Genode::size_t copy_size)
+			Genode::addr_t copy_rel_addr, Genode::size_t copy_size, Designated_dataspace_info *dd_info = nullptr)
 	:
 		orig_ds_cap(orig_ds_cap), copy_ds_cap(copy_ds_cap),
 		copy_rel_addr(copy_rel_addr), copy_size(copy_size),
-		checkpointed(false)
+		dd_info(dd_info), checkpointed(false)
 	{ }
 
 	Orig_copy_ckpt_info *find_by_orig_badge(Genode::uint16_t badge)
@@ -0,0 +1,320 @@
+/*
+ * \brief  Parallel copying of dataspace content
+ * \author agent
+ * \date   2026-10-18
+ *
+ * Copy requests are split into chunks, which are processed by a configurable
+ * number of worker threads and the calling thread. Each worker is pinned to its
+ * own CPU. Dataspaces are attached once per run; mappings marked as persistent
+ * are kept for the next run (e.g. the stored copies of a Target_state, which are
+ * read by each restore of the same state).
+ */
+
+#ifndef _RTCR_PARALLEL_COPY_H_
+#define _RTCR_PARALLEL_COPY_H_
+
+/* Genode includes */
+#include <base/env.h>
+#include <base/thread.h>
+#include <base/lock.h>
+#include <base/semaphore.h>
+#include <base/allocator.h>
+#include <base/log.h>
+#include <util/list.h>
+#include <util/string.h>
+#include <util/xml_node.h>
+
+/* Rtcr includes */
+
+namespace Rtcr {
+	class Parallel_copy;
+}
+
+
+class Rtcr::Parallel_copy
+{
+public:
+	struct Config
+	{
+		/**
+		 * Number of worker threads; with 0 workers, the calling thread copies alone
+		 */
+		unsigned       workers;
+		/**
+		 * CPU of the first worker; the following workers use the following CPUs
+		 */
+		unsigned       first_cpu;
+		/**
+		 * Copy requests larger than chunk_size are split into chunks
+		 */
+		Genode::size_t chunk_size;
+
+		Config(unsigned workers = 0, unsigned first_cpu = 0, Genode::size_t chunk_size = 256*1024)
+		: workers(workers), first_cpu(first_cpu), chunk_size(chunk_size) { }
+
+		/**
+		 * Read the config from a node, e.g. <restore workers="2" first_cpu="1" chunk_kib="256"/>
+		 */
+		static Config from_xml(Genode::Xml_node node)
+		{
+			Config config;
+			config.workers    = node.attribute_value("workers", config.workers);
+			config.first_cpu  = node.attribute_value("first_cpu", config.first_cpu);
+			config.chunk_size = node.attribute_value("chunk_kib", config.chunk_size / 1024) * 1024;
+			return config;
+		}
+	};
+
+private:
+	enum { MAX_WORKERS = 32 };
+
+	/**
+	 * Dataspace attached to the address space of the copying component
+	 */
+	struct Mapping : Genode::List<Mapping>::Element
+	{
+		Genode::Dataspace_capability const cap;
+		char                        *const addr;
+		bool     persistent;
+		unsigned round;
+
+		Mapping(Genode::Dataspace_capability cap, char *addr, bool persistent, unsigned round)
+		: cap(cap), addr(addr), persistent(persistent), round(round) { }
+
+		Mapping *find_by_badge(Genode::uint16_t badge)
+		{
+			if(badge == cap.local_name())
+				return this;
+			Mapping *mapping = next();
+			return mapping ? mapping->find_by_badge(badge) : 0;
+		}
+	};
+
+	struct Job
+	{
+		char           *dst;
+		char const     *src;
+		Genode::size_t  size;
+	};
+
+	struct Worker : Genode::Thread
+	{
+		Parallel_copy &engine;
+
+		Worker(Genode::Env &env, Parallel_copy &engine, Genode::Affinity::Location location)
+		:
+			Thread(env, "restore worker", 16*1024, location, Weight(), env.cpu()),
+			engine(engine)
+		{ }
+
+		void entry() override
+		{
+			while(engine._wait_for_round())
+			{
+				engine._process_jobs();
+				engine._finished.up();
+			}
+		}
+	};
+
+	Genode::Env       &_env;
+	Genode::Allocator &_alloc;
+	Config      const  _config;
+
+	Genode::List<Mapping> _mappings;
+	unsigned              _round;
+
+	/**
+	 * Queue of copy jobs; it grows on demand and is reused by each run
+	 */
+	Job      *_jobs;
+	unsigned  _num_jobs;
+	unsigned  _capacity;
+	unsigned  _next_job;
+
+	Genode::Lock      _lock;
+	Genode::Semaphore _start;
+	Genode::Semaphore _finished;
+	bool              _shutdown;
+
+	Worker  *_workers[MAX_WORKERS];
+	unsigned _num_workers;
+
+	/**
+	 * Bytes copied by all runs
+	 */
+	Genode::size_t _bytes_copied;
+
+	bool _wait_for_round()
+	{
+		_start.down();
+		return !_shutdown;
+	}
+
+	void _process_jobs()
+	{
+		while(true)
+		{
+			Job job;
+			{
+				Genode::Lock::Guard guard(_lock);
+				if(_next_job == _num_jobs) return;
+				job = _jobs[_next_job++];
+			}
+			Genode::memcpy(job.dst, job.src, job.size);
+		}
+	}
+
+	void _add_job(char *dst, char const *src, Genode::size_t size)
+	{
+		if(_num_jobs == _capacity)
+		{
+			unsigned const new_capacity = _capacity ? 2*_capacity : 64;
+
+			Job *new_jobs = nullptr;
+			if(!_alloc.alloc(new_capacity*sizeof(Job), (void**)&new_jobs))
+			{
+				Genode::error("Could not grow copy queue to ", new_capacity, " jobs");
+				throw Genode::Exception();
+			}
+			if(_jobs)
+			{
+				Genode::memcpy(new_jobs, _jobs, _num_jobs*sizeof(Job));
+				_alloc.free(_jobs, _capacity*sizeof(Job));
+			}
+			_jobs     = new_jobs;
+			_capacity = new_capacity;
+		}
+
+		_jobs[_num_jobs].dst  = dst;
+		_jobs[_num_jobs].src  = src;
+		_jobs[_num_jobs].size = size;
+		_num_jobs++;
+	}
+
+	char *_map(Genode::Dataspace_capability ds_cap, bool persistent)
+	{
+		Mapping *mapping = _mappings.first();
+		if(mapping) mapping = mapping->find_by_badge(ds_cap.local_name());
+
+		if(!mapping)
+		{
+			mapping = new (_alloc) Mapping(ds_cap, _env.rm().attach(ds_cap), persistent, _round);
+			_mappings.insert(mapping);
+		}
+		mapping->round       = _round;
+		mapping->persistent |= persistent;
+
+		return mapping->addr;
+	}
+
+	/*
+	 * Noncopyable
+	 */
+	Parallel_copy(Parallel_copy const &);
+	Parallel_copy &operator = (Parallel_copy const &);
+
+public:
+	Parallel_copy(Genode::Env &env, Genode::Allocator &alloc, Config const &config = Config())
+	:
+		_env(env), _alloc(alloc), _config(config), _mappings(), _round(0),
+		_jobs(nullptr), _num_jobs(0), _capacity(0), _next_job(0),
+		_lock(), _start(), _finished(), _shutdown(false), _num_workers(0), _bytes_copied(0)
+	{
+		Genode::Affinity::Space const space = env.cpu().affinity_space();
+		unsigned const num_cpus = space.width() ? space.width() : 1;
+
+		_num_workers = Genode::min(_config.workers, (unsigned)MAX_WORKERS);
+		for(unsigned i = 0; i < _num_workers; i++)
+		{
+			Genode::Affinity::Location const location((_config.first_cpu + i) % num_cpus, 0, 1, 1);
+
+			_workers[i] = new (_alloc) Worker(env, *this, location);
+			_workers[i]->start();
+		}
+	}
+
+	~Parallel_copy()
+	{
+		_shutdown = true;
+		for(unsigned i = 0; i < _num_workers; i++) _start.up();
+		for(unsigned i = 0; i < _num_workers; i++)
+		{
+			_workers[i]->join();
+			Genode::destroy(_alloc, _workers[i]);
+		}
+
+		detach_all();
+
+		if(_jobs) _alloc.free(_jobs, _capacity*sizeof(Job));
+	}
+
+	/**
+	 * Detach all mappings including the persistent ones, e.g. before their dataspaces are freed
+	 */
+	void detach_all()
+	{
+		while(Mapping *mapping = _mappings.first())
+		{
+			_mappings.remove(mapping);
+			_env.rm().detach(mapping->addr);
+			Genode::destroy(_alloc, mapping);
+		}
+	}
+
+	/**
+	 * Queue copying size bytes from src_ds_cap at src_offset to dst_ds_cap at dst_offset
+	 *
+	 * \param src_persistent keep the mapping of src_ds_cap for the next run
+	 */
+	void copy(Genode::Dataspace_capability dst_ds_cap, Genode::addr_t dst_offset,
+			Genode::Dataspace_capability src_ds_cap, Genode::addr_t src_offset, Genode::size_t size,
+			bool src_persistent = false)
+	{
+		char       *dst = _map(dst_ds_cap, false) + dst_offset;
+		char const *src = _map(src_ds_cap, src_persistent) + src_offset;
+
+		Genode::size_t const chunk_size = _config.chunk_size ? _config.chunk_size : size;
+		for(Genode::size_t offset = 0; offset < size; offset += chunk_size)
+			_add_job(dst + offset, src + offset, Genode::min(chunk_size, size - offset));
+
+		_bytes_copied += size;
+	}
+
+	/**
+	 * Copy all queued jobs and return when they are done
+	 *
+	 * Afterwards, all mappings are detached except for persistent mappings used in this run.
+	 */
+	void run()
+	{
+		_next_job = 0;
+
+		for(unsigned i = 0; i < _num_workers; i++) _start.up();
+		_process_jobs();
+		for(unsigned i = 0; i < _num_workers; i++) _finished.down();
+
+		_num_jobs = 0;
+
+		Mapping *mapping = _mappings.first();
+		while(mapping)
+		{
+			Mapping *next = mapping->next();
+			if(!mapping->persistent || mapping->round != _round)
+			{
+				_mappings.remove(mapping);
+				_env.rm().detach(mapping->addr);
+				Genode::destroy(_alloc, mapping);
+			}
+			mapping = next;
+		}
+
+		_round++;
+	}
+
+	unsigned num_workers() const { return _num_workers; }
+
+	Genode::size_t bytes_copied() const { return _bytes_copied; }
+};
+
+#endif /* _RTCR_PARALLEL_COPY_H_ */
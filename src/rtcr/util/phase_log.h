@@ -0,0 +1,176 @@
+/*
+ * \brief  Ring of the phase timings of the last checkpoints and restores of a target
+ * \author agent
+ * \date   2026-10-18
+ */
+
+#ifndef _RTCR_PHASE_LOG_H_
+#define _RTCR_PHASE_LOG_H_
+
+/* Genode includes */
+#include <base/lock.h>
+#include <util/list.h>
+#include <util/string.h>
+#include <util/misc_math.h>
+#include <trace/timestamp.h>
+#include <rtcr_session/rtcr_session.h>
+
+namespace Rtcr {
+	class Phase_log;
+}
+
+/**
+ * An operation is recorded by begin(), phase() for each of its phases, and end(). Only
+ * ended operations are read by copy(); the oldest operation is overwritten when the ring
+ * is full. The operations are recorded under the lock of the target, but read by Rtcr
+ * sessions concurrently, thus, the ring has its own lock.
+ *
+ * The progress of the current operation is reported to a Progress observer at the end
+ * of each phase and by copying() while a phase copies memory.
+ */
+class Rtcr::Phase_log
+{
+public:
+	typedef Rtcr::Session::Phase_record     Phase_record;
+	typedef Rtcr::Session::Operation_record Operation_record;
+	typedef Genode::Trace::Timestamp        Timestamp;
+
+	enum { MAX_OPERATIONS = Rtcr::Session::Phase_page::MAX_OPERATIONS };
+
+	struct Progress
+	{
+		/**
+		 * Called with the bytes copied by the current operation so far
+		 */
+		virtual void progress(Genode::uint64_t bytes) = 0;
+	};
+
+private:
+	Genode::Lock     _lock;
+	Operation_record _records[MAX_OPERATIONS];
+	/**
+	 * Index of the next record; the current operation is recorded there
+	 */
+	unsigned         _next;
+	unsigned         _count;
+	unsigned         _seq;
+	bool             _recording;
+	/**
+	 * Bytes of the ended phases of the current operation
+	 */
+	Genode::uint64_t _bytes;
+	Progress        *_progress;
+
+	/*
+	 * Noncopyable
+	 */
+	Phase_log(Phase_log const &);
+	Phase_log &operator = (Phase_log const &);
+
+public:
+	Phase_log() : _lock(), _next(0), _count(0), _seq(0), _recording(false), _bytes(0), _progress(nullptr) { }
+
+	static Timestamp now() { return Genode::Trace::timestamp(); }
+
+	/**
+	 * Number of elements of list, e.g. the objects processed by a phase
+	 */
+	template<typename T>
+	static unsigned count(Genode::List<T> const &list)
+	{
+		unsigned result = 0;
+		for(T const *element = list.first(); element; element = element->next()) result++;
+		return result;
+	}
+
+	void begin(Operation_record::Operation operation)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		Operation_record &record = _records[_next];
+		Genode::memset(&record, 0, sizeof(record));
+		record.seq       = ++_seq;
+		record.operation = operation;
+		record.start     = now();
+		_recording = true;
+		_bytes     = 0;
+	}
+
+	/**
+	 * Report the progress of the operations to progress; null stops the reports
+	 */
+	void progress(Progress *progress)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		_progress = progress;
+	}
+
+	/**
+	 * Report the bytes copied by the current phase so far
+	 */
+	void copying(Genode::uint64_t phase_bytes)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		if(_recording && _progress) _progress->progress(_bytes + phase_bytes);
+	}
+
+	/**
+	 * Record the phase which started at start and ends now
+	 *
+	 * \return the end of the phase, i.e. the start of the next phase
+	 */
+	Timestamp phase(Phase_record::Phase phase, Timestamp start, unsigned objects = 0, Genode::uint64_t bytes = 0)
+	{
+		Timestamp const end = now();
+
+		Genode::Lock::Guard guard(_lock);
+
+		Operation_record &record = _records[_next];
+		if(!_recording || record.num_phases == Operation_record::MAX_PHASES) return end;
+
+		Phase_record &phase_record = record.phases[record.num_phases++];
+		phase_record.phase    = phase;
+		phase_record.start    = start;
+		phase_record.duration = end - start;
+		phase_record.objects  = objects;
+		phase_record.bytes    = bytes;
+
+		_bytes += bytes;
+		if(_progress) _progress->progress(_bytes);
+
+		return end;
+	}
+
+	void end()
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		if(!_recording) return;
+
+		_records[_next].duration = now() - _records[_next].start;
+		_next  = (_next + 1) % MAX_OPERATIONS;
+		_count = Genode::min(_count + 1, (unsigned)MAX_OPERATIONS);
+		_recording = false;
+	}
+
+	/**
+	 * Copy the ended operations to dst, oldest first
+	 *
+	 * \return number of copied operations
+	 */
+	unsigned copy(Operation_record *dst, unsigned max)
+	{
+		Genode::Lock::Guard guard(_lock);
+
+		unsigned const count = Genode::min(_count, max);
+		unsigned const first = (_next + MAX_OPERATIONS - _count) % MAX_OPERATIONS;
+		for(unsigned i = 0; i < count; i++)
+			dst[i] = _records[(first + _count - count + i) % MAX_OPERATIONS];
+
+		return count;
+	}
+};
+
+#endif /* _RTCR_PHASE_LOG_H_ */
@@ -0,0 +1,88 @@
+/*
+ * \brief  Lock which is only taken, if no other thread holds or waits for it
+ * \author agent
+ * \date   2026-10-18
+ *
+ * Genode::Lock has no non-blocking acquisition. Try_lock counts the threads
+ * which hold or wait for its lock; try_lock() takes the lock only if there is
+ * none, thus, it never waits for a running operation.
+ */
+
+#ifndef _RTCR_TRY_LOCK_H_
+#define _RTCR_TRY_LOCK_H_
+
+/* Genode includes */
+#include <base/lock.h>
+#include <base/lock_guard.h>
+#include <cpu/atomic.h>
+
+/* Rtcr includes */
+
+namespace Rtcr {
+	class Try_lock;
+}
+
+
+class Rtcr::Try_lock
+{
+private:
+	Genode::Lock _lock;
+	/**
+	 * Threads which hold or wait for _lock
+	 */
+	volatile int _users;
+
+	/*
+	 * Noncopyable
+	 */
+	Try_lock(Try_lock const &);
+	Try_lock &operator = (Try_lock const &);
+
+	void _add(int value)
+	{
+		int users;
+		do { users = _users; } while(!Genode::cmpxchg(&_users, users, users + value));
+	}
+
+public:
+	typedef Genode::Lock_guard<Try_lock> Guard;
+
+	/**
+	 * Releases the lock taken by a successful try_lock() at the end of its scope
+	 */
+	struct Taken
+	{
+		Try_lock &lock;
+
+		Taken(Try_lock &lock) : lock(lock) { }
+		~Taken() { lock.unlock(); }
+	};
+
+	Try_lock() : _lock(), _users(0) { }
+
+	void lock()
+	{
+		_add(1);
+		_lock.lock();
+	}
+
+	/**
+	 * Take the lock, if it is free
+	 *
+	 * \return whether the lock is taken
+	 */
+	bool try_lock()
+	{
+		if(_users || !Genode::cmpxchg(&_users, 0, 1)) return false;
+		_lock.lock();
+		return true;
+	}
+
+	void unlock()
+	{
+		_lock.unlock();
+		_add(-1);
+	}
+};
+
+#endif /* _RTCR_TRY_LOCK_H_ */
@@ -13,7 +13,9 @@ SRC_CC += main.cc \
           target_child.cc \
           target_state.cc \
           checkpointer.cc \
-          restorer.cc
+          restorer.cc \
+          restore_plan.cc \
+          event_trace.cc
 
 LIBS   += base
 
@@ -30,3 +32,5 @@ vpath target_child.cc          $(REP_DIR)/src/rtcr
 vpath target_state.cc          $(REP_DIR)/src/rtcr
 vpath checkpointer.cc          $(REP_DIR)/src/rtcr
 vpath restorer.cc              $(REP_DIR)/src/rtcr
+vpath restore_plan.cc          $(REP_DIR)/src/rtcr
+vpath event_trace.cc           $(REP_DIR)/src/rtcr/util
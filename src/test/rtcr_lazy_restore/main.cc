@@ -0,0 +1,75 @@
+/*
+ * \brief  Checkpoint a child which was restored on first access, and restore it again
+ * \author agent
+ * \date   2026-10-18
+ *
+ * The designated dataspaces which the lazily restored child did not access
+ * before its checkpoint still hold no content. The second restore shows
+ * whether the checkpoint took their content from the first state: the
+ * sheep counter continues counting instead of starting over or faulting.
+ */
+
+/* Genode include */
+#include <base/component.h>
+#include <base/sleep.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+/* Rtcr includes */
+#include "../../rtcr/target_child.h"
+#include "../../rtcr/target_state.h"
+#include "../../rtcr/checkpointer.h"
+#include "../../rtcr/restorer.h"
+
+namespace Rtcr {
+	struct Main;
+}
+
+struct Rtcr::Main
+{
+	Genode::Env              &env;
+	Genode::Heap              heap            { env.ram(), env.rm() };
+	Genode::Service_registry  parent_services { };
+
+	Main(Genode::Env &env_) : env(env_)
+	{
+		using namespace Genode;
+
+		Timer::Connection timer { env };
+
+		Target_child child { env, heap, parent_services, "sheep_counter", 1 };
+		child.start();
+
+		timer.msleep(3000);
+
+		Target_state ts(env, heap);
+		Checkpointer ckpt(heap, child, ts);
+		ckpt.checkpoint();
+		log("Checkpointed the child");
+
+		Target_child child_lazy { env, heap, parent_services, "sheep_counter", 1 };
+		Restorer resto_lazy(heap, child_lazy, ts, Parallel_copy::Config(), Restorer::ON_FIRST_ACCESS);
+		child_lazy.start(resto_lazy);
+		log("Restored the child on first access");
+
+		// Checkpoint before the child touched most of its dataspaces
+		Target_state ts_lazy(env, heap);
+		Checkpointer ckpt_lazy(heap, child_lazy, ts_lazy);
+		ckpt_lazy.checkpoint();
+		log("Checkpointed the lazily restored child");
+
+		Target_child child_restored { env, heap, parent_services, "sheep_counter", 1 };
+		Restorer resto(heap, child_restored, ts_lazy);
+		child_restored.start(resto);
+		log("Restored the lazily restored child");
+
+		Genode::sleep_forever();
+	}
+};
+
+Genode::size_t Component::stack_size() { return 32*1024; }
+
+void Component::construct(Genode::Env &env)
+{
+	static Rtcr::Main main(env);
+}
@@ -44,7 +44,8 @@ struct Rtcr::Main
 		ckpt.checkpoint();
 
 		Target_child child_restored { env, heap, parent_services, "sheep_counter", 0 };
-		Restorer resto(heap, child_restored, ts);
+		// Restore memory with two worker threads on the CPUs following the boot CPU
+		Restorer resto(heap, child_restored, ts, Parallel_copy::Config(2, 1));
 		child_restored.start(resto);
 
 		//log("The End");
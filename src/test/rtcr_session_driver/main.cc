@@ -8,6 +8,8 @@
 #include <base/env.h>
 #include <base/log.h>
 #include <base/component.h>
+#include <os/attached_dataspace.h>
+#include <timer_session/connection.h>
 
 /* Rtcr includes */
 #include <rtcr_session/connection.h>
@@ -21,8 +23,77 @@ void Component::construct(Genode::Env &env)
 	log("--- Rtcr-driver started ---");
 
 	Rtcr::Connection rtcr { env };
-	rtcr.checkpoint("sheep_counter");
+
+	// The config of rtcr starts and schedules sheep_counter; without it, the driver starts it
+	try { rtcr.start("sheep_counter", 1); }
+	catch(Rtcr::Session::Target_already_exists) { log("sheep_counter is started by the config of rtcr"); }
+
+	// Let the scheduler checkpoint the target a few times; the operations below wait for a running checkpoint
+	Timer::Connection timer { env };
+	timer.msleep(1000);
+
+	Rtcr::Session::Prediction const prediction = rtcr.predict("sheep_counter");
+	log("predicted pause_us=", prediction.pause_us, " for ", prediction.dirty_bytes, " dirty bytes in ",
+			prediction.dirty_dataspaces, " dataspaces");
+
+	unsigned const generation = rtcr.checkpoint("sheep_counter");
+	log("checkpointed generation ", generation);
+
 	rtcr.restore("sheep_counter");
 
+	// The clones keep their checkpoint, while the component is checkpointed again
+	log("started ", rtcr.clone("sheep_counter", 2), " clones");
+	log("checkpointed generation ", rtcr.checkpoint("sheep_counter"), " with clones");
+	log("destroyed ", rtcr.destroy_clones("sheep_counter"), " clones");
+
+	// The first generation above is kept in compact form; the target continues from it
+	try
+	{
+		rtcr.restore("sheep_counter", generation);
+		log("restored older generation ", generation);
+	}
+	catch(Rtcr::Session::Checkpoint_does_not_exist) { error("generation ", generation, " is not kept"); }
+
+	// Asynchronous checkpoint; the completion is signalled and the progress is in the status page
+	Genode::Signal_receiver receiver;
+	Genode::Signal_context  context;
+	rtcr.completion_sigh(receiver.manage(&context));
+
+	Attached_dataspace status_ds { env.rm(), rtcr.status_dataspace() };
+	Rtcr::Session::Status_page const &page = *status_ds.local_addr<Rtcr::Session::Status_page>();
+
+	Rtcr::Session::Job const job = rtcr.checkpoint_async("sheep_counter");
+	Rtcr::Session::Job_status const &status = page.jobs[job % Rtcr::Session::Status_page::MAX_JOBS];
+	while(status.phase != Rtcr::Session::Job_status::DONE && status.phase != Rtcr::Session::Job_status::FAILED)
+		receiver.wait_for_signal();
+
+	log("job ", job, ": phase=", status.phase, ", generation=", status.generation,
+			", bytes_copied=", status.bytes_copied, ", elapsed_ms=", status.elapsed_ms);
+
+	receiver.dissolve(&context);
+
+	// Phase timings of the checkpoints and the restore above
+	Attached_dataspace phase_ds { env.rm(), rtcr.phase_dataspace() };
+	Rtcr::Session::Phase_page const &phases = *phase_ds.local_addr<Rtcr::Session::Phase_page>();
+	unsigned const count = rtcr.phase_records("sheep_counter");
+	for(unsigned i = 0; i < count; i++)
+	{
+		Rtcr::Session::Operation_record const &operation = phases.operations[i];
+		log("operation ", operation.seq, ": type=", operation.operation, ", us=",
+				operation.duration / (phases.ticks_per_us ? phases.ticks_per_us : 1));
+		for(unsigned j = 0; j < operation.num_phases; j++)
+			log("  phase ", operation.phases[j].phase, ": objects=", operation.phases[j].objects,
+					", bytes=", operation.phases[j].bytes, ", us=",
+					operation.phases[j].duration / (phases.ticks_per_us ? phases.ticks_per_us : 1));
+	}
+
+	// The standby replica, fed by the checkpoints above, takes over from the last checkpoint
+	try
+	{
+		rtcr.failover("sheep_counter");
+		log("failed over to the standby of sheep_counter");
+	}
+	catch(Rtcr::Session::Checkpoint_does_not_exist) { error("sheep_counter has no standby"); }
+
 	log("--- Rtcr-driver ended ---");
 }